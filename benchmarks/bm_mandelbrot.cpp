@@ -4,24 +4,291 @@
  * Benchmarks may be skipped depending on the runtime capability of the system.
  */
 
+#include <chrono>
+#include <cmath>
 #include <format>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 
 #include "backends.hpp"
 #include "benchmark/utils.h"
+#include "engine_pool.hpp"
 #include "mandelbrot_engine.hpp"
+#include "perturbation_engine.hpp"
 
 const ViewBounds bounds{-2.0f, 1.0f, -1.0f, 1.0f};
 constexpr unsigned int max_iter = 1000;
 
-template <Backend B, Execution Exec>
+template <Backend B, Execution Exec, bool InteriorDetection = false,
+          RenderMode Mode = RenderMode::Full,
+          KernelVariant Variant = KernelVariant::Block, Scalar T = float,
+          Channels C = channels::Full>
 void BM_Mandelbrot(benchmark::State& state) {
   const std::size_t width = static_cast<std::size_t>(state.range(0));
   const std::size_t height = static_cast<std::size_t>(state.range(1));
 
+  auto engine =
+      MandelbrotEngine<B, Exec, T, C>{width, height, bounds, max_iter};
+  engine.set_interior_detection(InteriorDetection);
+  engine.set_render_mode(Mode);
+  engine.set_kernel_variant(Variant);
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  for (auto _ : state) {
+    auto result = engine.compute();
+  }
+
+  state.counters["iterated_pixels"] =
+      static_cast<double>(engine.iterated_pixels());
+
+#if defined(MANDELBROT_HAS_OMP)
+  if constexpr (std::is_same_v<Exec, exec::WorkStealing>) {
+    // The share of thread time spent without work during the last iteration.
+    std::chrono::nanoseconds busy{0}, idle{0};
+
+    for (const WorkerStats& worker : engine.worker_stats()) {
+      busy += worker.busy;
+      idle += worker.idle;
+    }
+
+    state.counters["idle_fraction"] =
+        static_cast<double>(idle.count()) /
+        static_cast<double>((busy + idle).count());
+  }
+#endif
+}
+
+// The interleaved kernels, so that their shape can be tuned to the CPU.
+template <Backend B, Execution Exec, unsigned int Vectors,
+          unsigned int CheckInterval>
+void BM_Interleaved(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+
+  auto engine = MandelbrotEngine<B, Exec>{width, height, bounds, max_iter};
+  engine.set_kernel_variant(KernelVariant::Interleaved);
+  engine.set_interleaving(Vectors, CheckInterval);
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  for (auto _ : state) {
+    auto result = engine.compute();
+  }
+}
+
+// Pan back and forth by a few columns per frame, as an interactive viewer
+// would while dragging.
+template <Backend B, Execution Exec>
+void BM_Pan(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+  constexpr double pan_pixels = 8.0;
+
+  auto engine = MandelbrotEngine<B, Exec>{width, height, bounds, max_iter};
+  engine.set_incremental(true);
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  engine.compute();
+
+  const double step = (bounds.real_max - bounds.real_min) /
+                      static_cast<double>(width - 1) * pan_pixels;
+  double offset = 0.0;
+
+  for (auto _ : state) {
+    offset = (offset == 0.0) ? step : 0.0;
+    engine.set_bounds({bounds.real_min + offset, bounds.real_max + offset,
+                       bounds.imag_min, bounds.imag_max});
+
+    auto result = engine.compute();
+  }
+
+  state.counters["iterated_pixels"] =
+      static_cast<double>(engine.iterated_pixels());
+}
+
+// Refine progressively, as a viewer would while waiting for the final image:
+// preview with a quarter of the iterations, then resume up to four times more.
+template <Backend B, Execution Exec>
+void BM_Resume(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  std::size_t resumed_pixels{0};
+
+  for (auto _ : state) {
+    auto engine =
+        MandelbrotEngine<B, Exec>{width, height, bounds, max_iter / 4};
+
+    engine.compute();
+    engine.resume(max_iter);
+    resumed_pixels = engine.iterated_pixels();
+
+    auto result = engine.resume(max_iter * 4);
+    resumed_pixels += engine.iterated_pixels();
+  }
+
+  state.counters["resumed_pixels"] = static_cast<double>(resumed_pixels);
+}
+
+// Stream the image in bands, as a renderer writing an image too large to hold
+// in memory would.
+template <Backend B, Execution Exec>
+void BM_Bands(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+  constexpr std::size_t band_height = 16;
+
+  auto engine = MandelbrotEngine<B, Exec>{width, height, bounds, max_iter};
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  for (auto _ : state) {
+    engine.compute_bands(band_height, [](const MandelbrotBand<>& band) {
+      benchmark::DoNotOptimize(band(0, 0));
+    });
+  }
+}
+
+// Render an RGBA8 image, either fused with the computation or by coloring a
+// stored result afterwards. Fused images can supersample their edges.
+template <Backend B, Execution Exec, bool Fused,
+          unsigned int Supersampling = 1>
+void BM_Image(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  auto engine = MandelbrotEngine<B, Exec>{width, height, bounds, max_iter};
+  engine.set_supersampling(Supersampling);
+
+  const Colorizer colorizer;
+  std::vector<std::uint8_t> pixels(width * height *
+                                   bytesPerPixel(PixelFormat::RGBA8));
+
+  for (auto _ : state) {
+    if constexpr (Fused) {
+      engine.compute_image(colorizer, PixelFormat::RGBA8, pixels.data());
+    } else {
+      colorizer.colorize(engine.compute(), max_iter, PixelFormat::RGBA8,
+                         pixels.data());
+    }
+
+    benchmark::DoNotOptimize(pixels.data());
+  }
+
+  state.counters["supersampled_pixels"] =
+      static_cast<double>(engine.supersampled_pixels());
+}
+
+// Compute the frames of a zoom animation, either as a batch or one after the
+// other.
+template <Backend B, Execution Exec, bool Batched>
+void BM_Zoom(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+  constexpr std::size_t frame_count = 16;
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  std::vector<ViewBounds> frames;
+
+  for (std::size_t frame = 0; frame < frame_count; ++frame) {
+    const double scale = std::pow(0.9, static_cast<double>(frame));
+
+    frames.emplace_back(-0.75 - 1.5 * scale, -0.75 + 1.5 * scale,
+                        0.1 - scale, 0.1 + scale);
+  }
+
   auto engine = MandelbrotEngine<B, Exec>{width, height, bounds, max_iter};
 
+  for (auto _ : state) {
+    if constexpr (Batched) {
+      engine.compute_batch(frames, [](const std::size_t,
+                                      const MandelbrotResult<B>& result) {
+        benchmark::DoNotOptimize(result(0, 0));
+      });
+    } else {
+      for (const ViewBounds& frame : frames) {
+        engine.set_bounds(frame);
+        benchmark::DoNotOptimize(engine.compute()(0, 0));
+      }
+    }
+  }
+}
+
+// Serve a stream of requests of varying sizes within a size class, either with
+// an engine per request or with engines from a pool. The low iteration limit
+// keeps the cost of setting up an engine visible.
+template <Backend B, Execution Exec, bool Pooled>
+void BM_Requests(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+  constexpr unsigned int request_max_iter = 64;
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  EnginePool<B, Exec> pool;
+  std::size_t request{0};
+
+  for (auto _ : state) {
+    // Alternate between the full size and one a few rows smaller.
+    const std::size_t request_height = height - (request++ % 2) * 8;
+
+    if constexpr (Pooled) {
+      auto engine =
+          pool.acquire(width, request_height, bounds, request_max_iter);
+      benchmark::DoNotOptimize(engine->compute()(0, 0));
+    } else {
+      auto engine = MandelbrotEngine<B, Exec>{width, request_height, bounds,
+                                              request_max_iter};
+      benchmark::DoNotOptimize(engine.compute()(0, 0));
+    }
+  }
+}
+
+#if defined(MANDELBROT_HAS_OMP)
+// Place the threads and the results on the NUMA nodes, or leave them to the
+// operating system. The results are placed by the first computation.
+template <Backend B, Execution Exec, ThreadPlacement Placement>
+void BM_Placement(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+
+  auto engine = MandelbrotEngine<B, Exec>{width, height, bounds, max_iter};
+  engine.set_thread_placement(Placement);
+
   if (!B::is_available()) {
     state.SkipWithError(std::format("Backend {} not available", B::name()));
     return;
@@ -31,6 +298,43 @@ void BM_Mandelbrot(benchmark::State& state) {
     auto result = engine.compute();
   }
 }
+#endif
+
+// A view in the seahorse valley that is too deep to compute without
+// perturbation.
+constexpr std::string_view deep_center_real =
+    "-0.743643887037158704752191506114774";
+constexpr std::string_view deep_center_imag =
+    "0.131825904205311970493132056385139";
+constexpr double deep_radius = 1e-20;
+constexpr unsigned int deep_max_iter = 10000;
+
+template <Backend B, Execution Exec, Scalar T = double>
+void BM_Perturbation(benchmark::State& state) {
+  const std::size_t width = static_cast<std::size_t>(state.range(0));
+  const std::size_t height = static_cast<std::size_t>(state.range(1));
+
+  if (!B::is_available()) {
+    state.SkipWithError(std::format("Backend {} not available", B::name()));
+    return;
+  }
+
+  auto engine = PerturbationEngine<B, Exec, T>{
+      width,       height,       deep_center_real, deep_center_imag,
+      deep_radius, deep_max_iter};
+
+  for (auto _ : state) {
+    auto result = engine.compute();
+  }
+
+  state.counters["reference_length"] =
+      static_cast<double>(engine.reference_length());
+
+  // The iterations per frame that the series approximation replaced.
+  state.counters["skipped_iterations"] =
+      static_cast<double>(engine.skipped_iterations()) *
+      static_cast<double>(width * height);
+}
 
 // Set benchmark image resolutions.
 #define COMMON_ARGS                                                            \
@@ -41,28 +345,213 @@ void BM_Mandelbrot(benchmark::State& state) {
   ->UseRealTime()
 
 #define MANDEL_BENCH(BACKEND, EXEC)                                                  \
-  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC>)->Name(std::format("{}{}", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC>)->Name(std::format("{}{}", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, true>)->Name(std::format("{}{}InteriorDetection", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, false, RenderMode::Subdivision>)->Name(std::format("{}{}Subdivision", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, false, RenderMode::Full, KernelVariant::LaneRefill>)->Name(std::format("{}{}LaneRefill", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Pan<backend::BACKEND, exec::EXEC>)->Name(std::format("{}{}Pan", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Resume<backend::BACKEND, exec::EXEC>)->Name(std::format("{}{}Resume", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Compare double against float throughput on the same view. CUDA only
+// computes in single precision.
+#define MANDEL_BENCH_DOUBLE(BACKEND, EXEC)                                           \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, false, RenderMode::Full, KernelVariant::Block, double>)->Name(std::format("{}{}Double", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Compact result channels. CUDA is not supported.
+#define MANDEL_BENCH_CHANNELS(BACKEND, EXEC)                                         \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, false, RenderMode::Full, KernelVariant::Block, float, channels::Iterations16>)->Name(std::format("{}{}Iterations16", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, false, RenderMode::Full, KernelVariant::Block, float, channels::Smooth>)->Name(std::format("{}{}Smooth", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Mandelbrot<backend::BACKEND, exec::EXEC, false, RenderMode::Full, KernelVariant::Block, float, channels::Distance>)->Name(std::format("{}{}Distance", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Streaming in bands. CUDA is not supported.
+#define MANDEL_BENCH_BANDS(BACKEND, EXEC)                                            \
+  BENCHMARK(BM_Bands<backend::BACKEND, exec::EXEC>)->Name(std::format("{}{}Bands", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Colorized images, fused, unfused and with 4x4 edge supersampling. CUDA is not
+// supported.
+#define MANDEL_BENCH_IMAGE(BACKEND, EXEC)                                            \
+  BENCHMARK(BM_Image<backend::BACKEND, exec::EXEC, true>)->Name(std::format("{}{}Image", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Image<backend::BACKEND, exec::EXEC, false>)->Name(std::format("{}{}ImageUnfused", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Image<backend::BACKEND, exec::EXEC, true, 4>)->Name(std::format("{}{}ImageSupersampled", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Zoom animations, batched and frame by frame. CUDA is not supported.
+#define MANDEL_BENCH_ZOOM(BACKEND, EXEC)                                             \
+  BENCHMARK(BM_Zoom<backend::BACKEND, exec::EXEC, true>)->Name(std::format("{}{}ZoomBatch", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Zoom<backend::BACKEND, exec::EXEC, false>)->Name(std::format("{}{}Zoom", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Requests with an engine each and with pooled engines. CUDA is not supported.
+#define MANDEL_BENCH_REQUESTS(BACKEND, EXEC)                                         \
+  BENCHMARK(BM_Requests<backend::BACKEND, exec::EXEC, false>)->Name(std::format("{}{}Requests", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Requests<backend::BACKEND, exec::EXEC, true>)->Name(std::format("{}{}RequestsPooled", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Interleaved kernels of every shape. Only the SIMD backends interleave.
+#define MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, INTERVAL)            \
+  BENCHMARK(BM_Interleaved<backend::BACKEND, exec::EXEC, VECTORS, INTERVAL>)->Name(std::format("{}{}Interleaved{}x{}", backend::BACKEND::name(), exec::EXEC::name(), VECTORS, INTERVAL)) COMMON_ARGS;
+
+#define MANDEL_BENCH_INTERLEAVED_VECTORS(BACKEND, EXEC, VECTORS)                     \
+  MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, 1)                          \
+  MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, 2)                          \
+  MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, 4)                          \
+  MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, 8)                          \
+  MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, 16)                         \
+  MANDEL_BENCH_INTERLEAVED_SHAPE(BACKEND, EXEC, VECTORS, 32)
+
+#define MANDEL_BENCH_INTERLEAVED(BACKEND, EXEC)                                      \
+  MANDEL_BENCH_INTERLEAVED_VECTORS(BACKEND, EXEC, 2)                                 \
+  MANDEL_BENCH_INTERLEAVED_VECTORS(BACKEND, EXEC, 3)                                 \
+  MANDEL_BENCH_INTERLEAVED_VECTORS(BACKEND, EXEC, 4)
+
+// Deep zoom by perturbation, in both precisions. CUDA is not supported.
+#define MANDEL_BENCH_PERTURBATION(BACKEND, EXEC)                                     \
+  BENCHMARK(BM_Perturbation<backend::BACKEND, exec::EXEC>)->Name(std::format("{}{}Perturbation", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS; \
+  BENCHMARK(BM_Perturbation<backend::BACKEND, exec::EXEC, float>)->Name(std::format("{}{}PerturbationFloat", backend::BACKEND::name(), exec::EXEC::name())) COMMON_ARGS;
+
+// Resolutions whose results don't fit in the caches.
+#define LARGE_ARGS                                                             \
+  ->Args({3840, 2160})                                                         \
+  ->Args({7680, 4320})                                                         \
+  ->UseRealTime()
+
+// Thread placement, against the placement by the operating system. Only the
+// parallel execution policies place their threads.
+#define MANDEL_BENCH_PLACEMENT(BACKEND, EXEC)                                        \
+  BENCHMARK(BM_Placement<backend::BACKEND, exec::EXEC, ThreadPlacement::None>)->Name(std::format("{}{}PlacementNone", backend::BACKEND::name(), exec::EXEC::name())) LARGE_ARGS; \
+  BENCHMARK(BM_Placement<backend::BACKEND, exec::EXEC, ThreadPlacement::Close>)->Name(std::format("{}{}PlacementClose", backend::BACKEND::name(), exec::EXEC::name())) LARGE_ARGS; \
+  BENCHMARK(BM_Placement<backend::BACKEND, exec::EXEC, ThreadPlacement::Spread>)->Name(std::format("{}{}PlacementSpread", backend::BACKEND::name(), exec::EXEC::name())) LARGE_ARGS;
 
 MANDEL_BENCH(Serial, Default)
+MANDEL_BENCH_DOUBLE(Serial, Default)
+MANDEL_BENCH_CHANNELS(Serial, Default)
+MANDEL_BENCH_PERTURBATION(Serial, Default)
+MANDEL_BENCH_BANDS(Serial, Default)
+MANDEL_BENCH_IMAGE(Serial, Default)
+MANDEL_BENCH_ZOOM(Serial, Default)
+MANDEL_BENCH_REQUESTS(Serial, Default)
 
 #if defined(MANDELBROT_HAS_OMP)
 MANDEL_BENCH(Serial, OMP)
+MANDEL_BENCH_DOUBLE(Serial, OMP)
+MANDEL_BENCH_CHANNELS(Serial, OMP)
+MANDEL_BENCH_PERTURBATION(Serial, OMP)
+MANDEL_BENCH_BANDS(Serial, OMP)
+MANDEL_BENCH_IMAGE(Serial, OMP)
+MANDEL_BENCH_ZOOM(Serial, OMP)
+MANDEL_BENCH_REQUESTS(Serial, OMP)
+MANDEL_BENCH_PLACEMENT(Serial, OMP)
+MANDEL_BENCH(Serial, WorkStealing)
+MANDEL_BENCH_DOUBLE(Serial, WorkStealing)
+MANDEL_BENCH_CHANNELS(Serial, WorkStealing)
+MANDEL_BENCH_PERTURBATION(Serial, WorkStealing)
+MANDEL_BENCH_BANDS(Serial, WorkStealing)
+MANDEL_BENCH_IMAGE(Serial, WorkStealing)
+MANDEL_BENCH_ZOOM(Serial, WorkStealing)
+MANDEL_BENCH_REQUESTS(Serial, WorkStealing)
+MANDEL_BENCH_PLACEMENT(Serial, WorkStealing)
 #endif
 
 #if defined(MANDELBROT_HAS_AVX2)
 MANDEL_BENCH(AVX2, Default)
+MANDEL_BENCH_DOUBLE(AVX2, Default)
+MANDEL_BENCH_CHANNELS(AVX2, Default)
+MANDEL_BENCH_PERTURBATION(AVX2, Default)
+MANDEL_BENCH_BANDS(AVX2, Default)
+MANDEL_BENCH_IMAGE(AVX2, Default)
+MANDEL_BENCH_ZOOM(AVX2, Default)
+MANDEL_BENCH_REQUESTS(AVX2, Default)
+MANDEL_BENCH_INTERLEAVED(AVX2, Default)
 #endif
 
 #if defined(MANDELBROT_HAS_AVX2) && defined(MANDELBROT_HAS_OMP)
 MANDEL_BENCH(AVX2, OMP)
+MANDEL_BENCH_DOUBLE(AVX2, OMP)
+MANDEL_BENCH_CHANNELS(AVX2, OMP)
+MANDEL_BENCH_PERTURBATION(AVX2, OMP)
+MANDEL_BENCH_BANDS(AVX2, OMP)
+MANDEL_BENCH_IMAGE(AVX2, OMP)
+MANDEL_BENCH_ZOOM(AVX2, OMP)
+MANDEL_BENCH_REQUESTS(AVX2, OMP)
+MANDEL_BENCH_PLACEMENT(AVX2, OMP)
+MANDEL_BENCH_INTERLEAVED(AVX2, OMP)
+MANDEL_BENCH(AVX2, WorkStealing)
+MANDEL_BENCH_DOUBLE(AVX2, WorkStealing)
+MANDEL_BENCH_CHANNELS(AVX2, WorkStealing)
+MANDEL_BENCH_PERTURBATION(AVX2, WorkStealing)
+MANDEL_BENCH_BANDS(AVX2, WorkStealing)
+MANDEL_BENCH_IMAGE(AVX2, WorkStealing)
+MANDEL_BENCH_ZOOM(AVX2, WorkStealing)
+MANDEL_BENCH_REQUESTS(AVX2, WorkStealing)
+MANDEL_BENCH_PLACEMENT(AVX2, WorkStealing)
+MANDEL_BENCH_INTERLEAVED(AVX2, WorkStealing)
 #endif
 
 #if defined(MANDELBROT_HAS_AVX512)
 MANDEL_BENCH(AVX512, Default)
+MANDEL_BENCH_DOUBLE(AVX512, Default)
+MANDEL_BENCH_CHANNELS(AVX512, Default)
+MANDEL_BENCH_PERTURBATION(AVX512, Default)
+MANDEL_BENCH_BANDS(AVX512, Default)
+MANDEL_BENCH_IMAGE(AVX512, Default)
+MANDEL_BENCH_ZOOM(AVX512, Default)
+MANDEL_BENCH_REQUESTS(AVX512, Default)
+MANDEL_BENCH_INTERLEAVED(AVX512, Default)
 #endif
 
 #if defined(MANDELBROT_HAS_AVX512) && defined(MANDELBROT_HAS_OMP)
 MANDEL_BENCH(AVX512, OMP)
+MANDEL_BENCH_DOUBLE(AVX512, OMP)
+MANDEL_BENCH_CHANNELS(AVX512, OMP)
+MANDEL_BENCH_PERTURBATION(AVX512, OMP)
+MANDEL_BENCH_BANDS(AVX512, OMP)
+MANDEL_BENCH_IMAGE(AVX512, OMP)
+MANDEL_BENCH_ZOOM(AVX512, OMP)
+MANDEL_BENCH_REQUESTS(AVX512, OMP)
+MANDEL_BENCH_PLACEMENT(AVX512, OMP)
+MANDEL_BENCH_INTERLEAVED(AVX512, OMP)
+MANDEL_BENCH(AVX512, WorkStealing)
+MANDEL_BENCH_DOUBLE(AVX512, WorkStealing)
+MANDEL_BENCH_CHANNELS(AVX512, WorkStealing)
+MANDEL_BENCH_PERTURBATION(AVX512, WorkStealing)
+MANDEL_BENCH_BANDS(AVX512, WorkStealing)
+MANDEL_BENCH_IMAGE(AVX512, WorkStealing)
+MANDEL_BENCH_ZOOM(AVX512, WorkStealing)
+MANDEL_BENCH_REQUESTS(AVX512, WorkStealing)
+MANDEL_BENCH_PLACEMENT(AVX512, WorkStealing)
+MANDEL_BENCH_INTERLEAVED(AVX512, WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+MANDEL_BENCH(Portable, Default)
+MANDEL_BENCH_DOUBLE(Portable, Default)
+MANDEL_BENCH_CHANNELS(Portable, Default)
+MANDEL_BENCH_PERTURBATION(Portable, Default)
+MANDEL_BENCH_BANDS(Portable, Default)
+MANDEL_BENCH_IMAGE(Portable, Default)
+MANDEL_BENCH_ZOOM(Portable, Default)
+MANDEL_BENCH_REQUESTS(Portable, Default)
+MANDEL_BENCH_INTERLEAVED(Portable, Default)
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE) && defined(MANDELBROT_HAS_OMP)
+MANDEL_BENCH(Portable, OMP)
+MANDEL_BENCH_DOUBLE(Portable, OMP)
+MANDEL_BENCH_CHANNELS(Portable, OMP)
+MANDEL_BENCH_PERTURBATION(Portable, OMP)
+MANDEL_BENCH_BANDS(Portable, OMP)
+MANDEL_BENCH_IMAGE(Portable, OMP)
+MANDEL_BENCH_ZOOM(Portable, OMP)
+MANDEL_BENCH_REQUESTS(Portable, OMP)
+MANDEL_BENCH_PLACEMENT(Portable, OMP)
+MANDEL_BENCH_INTERLEAVED(Portable, OMP)
+MANDEL_BENCH(Portable, WorkStealing)
+MANDEL_BENCH_DOUBLE(Portable, WorkStealing)
+MANDEL_BENCH_CHANNELS(Portable, WorkStealing)
+MANDEL_BENCH_PERTURBATION(Portable, WorkStealing)
+MANDEL_BENCH_BANDS(Portable, WorkStealing)
+MANDEL_BENCH_IMAGE(Portable, WorkStealing)
+MANDEL_BENCH_ZOOM(Portable, WorkStealing)
+MANDEL_BENCH_REQUESTS(Portable, WorkStealing)
+MANDEL_BENCH_PLACEMENT(Portable, WorkStealing)
+MANDEL_BENCH_INTERLEAVED(Portable, WorkStealing)
 #endif
 
 #if defined(MANDELBROT_HAS_CUDA)
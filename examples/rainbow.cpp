@@ -1,11 +1,11 @@
 /*
  * This example will build a super-sampled RGB 1920x1080 image of the Mandelbrot
- * set. The SSAA factor has been set to 4. The complex plane is bounded by
- * [-1.252213542, -1.22213542] on the real axis and [0.108567708, 0.125442708]
- * on the imaginary axis. The maximum iterations for each pixel is set to 1000.
+ * set. The SSAA factor has been set to 4, and only the pixels on edges are
+ * supersampled. The complex plane is bounded by [-1.252213542, -1.22213542] on
+ * the real axis and [0.108567708, 0.125442708] on the imaginary axis. The
+ * maximum iterations for each pixel is set to 1000.
  */
 
-#include <cmath>
 #include <opencv2/core.hpp>
 #include <opencv2/core/hal/interface.h>
 #include <opencv2/core/types.hpp>
@@ -26,43 +26,15 @@ constexpr float
         0.125442708f; // The bounds of the imaginary axis on the complex plane.
 
 int main() {
-  cv::Mat pixels(height * ssaa_factor, width * ssaa_factor, CV_8UC3);
+  cv::Mat pixels(height, width, CV_8UC3);
 
-  auto engine = MandelbrotEngine{width * ssaa_factor, height * ssaa_factor, {real_min, real_max, imag_min, imag_max}, max_iterations};
-  MandelbrotResult result = engine.compute();
+  auto engine = MandelbrotEngine{width, height, {real_min, real_max, imag_min, imag_max}, max_iterations};
+  engine.set_supersampling(ssaa_factor);
 
-  for (std::size_t row = 0; row < pixels.rows; ++row) {
-    for (std::size_t col = 0; col < pixels.cols; ++col) {
-      auto&& [iteration, z] = result(row, col);
-
-      if (iteration == max_iterations) {
-        pixels.at<cv::Vec3b>(row, col) = cv::Vec3b(0, 0, 0);
-      } else {
-        float smooth = static_cast<float>(iteration) + 1.0f -
-                       std::log2(std::log(std::abs(z)));
-        float t = std::pow(smooth / max_iterations, 0.5f);
-
-        float freq = 2.0f;
-        float r = 0.5f + 0.5f * std::cos(6.28318f * (freq * t + 0.0f));
-        float g = 0.5f + 0.5f * std::cos(6.28318f * (freq * t + 0.33f));
-        float b = 0.5f + 0.5f * std::cos(6.28318f * (freq * t + 0.67f));
-
-        float brightness = 0.7f + 0.3f * t;
-        r *= brightness;
-        g *= brightness;
-        b *= brightness;
-
-        pixels.at<cv::Vec3b>(row, col) =
-            cv::Vec3b(static_cast<unsigned char>(b * 255),
-                      static_cast<unsigned char>(g * 255),
-                      static_cast<unsigned char>(r * 255));
-      }
-    }
-  }
-
-  cv::resize(pixels, pixels,
-             cv::Size(pixels.cols / ssaa_factor, pixels.rows / ssaa_factor), 0,
-             0, cv::INTER_AREA);
+  // Color the rows as they are computed, without storing the iteration counts
+  // and z-values of the whole image.
+  engine.compute_image(Colorizer{}, PixelFormat::RGB8, pixels.data);
+  cv::cvtColor(pixels, pixels, cv::COLOR_RGB2BGR);
 
   cv::imwrite("rainbow.png", pixels);
 
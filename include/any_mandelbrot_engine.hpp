@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "backends.hpp"
+#include "mandelbrot_engine.hpp"
+#include "mandelbrot_result.hpp"
+
+/*
+ * A type-erased Mandelbrot engine.
+ *
+ * Wraps any compiled `MandelbrotEngine<B, Exec>` specialization so that the
+ * backend and execution policy can be chosen at runtime. Use `make_engine` to
+ * construct one.
+ */
+class AnyMandelbrotEngine {
+public:
+  template <Backend B, Execution Exec>
+    requires Compatible<B, Exec>
+  explicit AnyMandelbrotEngine(MandelbrotEngine<B, Exec>&& engine)
+      : m_engine{std::make_unique<Model<B, Exec>>(std::move(engine))} {};
+
+  AnyMandelbrotResult compute() { return m_engine->compute(); }
+
+  AnyMandelbrotResult resume(unsigned int max_iterations) {
+    return m_engine->resume(max_iterations);
+  }
+
+  /*
+   * Take the buffers of the last computation out of the engine, see
+   * `MandelbrotEngine::take_result`.
+   *
+   * @returns The result of the last computation, owning its buffers.
+   *
+   * @throws std::logic_error If the engine holds no result.
+   */
+  AnyMandelbrotResult take_result() { return m_engine->take_result(); }
+
+  void set_bounds(const ViewBounds& bounds) { m_engine->set_bounds(bounds); }
+
+  void set_interior_detection(bool enabled) {
+    m_engine->set_interior_detection(enabled);
+  }
+
+  void set_render_mode(RenderMode mode) { m_engine->set_render_mode(mode); }
+
+  void set_kernel_variant(KernelVariant variant) {
+    m_engine->set_kernel_variant(variant);
+  }
+
+  void set_interleaving(unsigned int vectors, unsigned int check_interval) {
+    m_engine->set_interleaving(vectors, check_interval);
+  }
+
+  void set_incremental(bool enabled) { m_engine->set_incremental(enabled); }
+
+  /*
+   * Set the placement of the threads on the CPUs and of the results in memory,
+   * see `MandelbrotEngine::set_thread_placement`. The default execution policy
+   * ignores the setting.
+   *
+   * @param placement The placement of the threads.
+   */
+  void set_thread_placement(ThreadPlacement placement) {
+    m_engine->set_thread_placement(placement);
+  }
+
+  std::size_t width() const noexcept { return m_engine->width(); }
+  std::size_t height() const noexcept { return m_engine->height(); }
+  const ViewBounds& bounds() const noexcept { return m_engine->bounds(); }
+  unsigned int max_iterations() const noexcept {
+    return m_engine->max_iterations();
+  }
+  std::size_t iterated_pixels() const noexcept {
+    return m_engine->iterated_pixels();
+  }
+
+  /*
+   * Get the name of the backend the engine is running on.
+   *
+   * @returns The name of the backend.
+   */
+  std::string_view backend_name() const noexcept {
+    return m_engine->backend_name();
+  }
+
+  /*
+   * Get the name of the execution policy the engine is running with.
+   *
+   * @returns The name of the execution policy.
+   */
+  std::string_view exec_name() const noexcept { return m_engine->exec_name(); }
+
+private:
+  struct Concept {
+    virtual ~Concept() = default;
+
+    virtual AnyMandelbrotResult compute() = 0;
+    virtual AnyMandelbrotResult resume(unsigned int max_iterations) = 0;
+    virtual AnyMandelbrotResult take_result() = 0;
+    virtual void set_bounds(const ViewBounds& bounds) = 0;
+    virtual void set_interior_detection(bool enabled) = 0;
+    virtual void set_render_mode(RenderMode mode) = 0;
+    virtual void set_kernel_variant(KernelVariant variant) = 0;
+    virtual void set_interleaving(unsigned int vectors,
+                                  unsigned int check_interval) = 0;
+    virtual void set_incremental(bool enabled) = 0;
+    virtual void set_thread_placement(ThreadPlacement placement) = 0;
+
+    virtual std::size_t width() const noexcept = 0;
+    virtual std::size_t height() const noexcept = 0;
+    virtual const ViewBounds& bounds() const noexcept = 0;
+    virtual unsigned int max_iterations() const noexcept = 0;
+    virtual std::size_t iterated_pixels() const noexcept = 0;
+
+    virtual std::string_view backend_name() const noexcept = 0;
+    virtual std::string_view exec_name() const noexcept = 0;
+  };
+
+  template <Backend B, Execution Exec> struct Model final : Concept {
+    explicit Model(MandelbrotEngine<B, Exec>&& engine)
+        : engine{std::move(engine)} {};
+
+    AnyMandelbrotResult compute() override { return engine.compute(); }
+    AnyMandelbrotResult resume(unsigned int max_iterations) override {
+      return engine.resume(max_iterations);
+    }
+    AnyMandelbrotResult take_result() override { return engine.take_result(); }
+    void set_bounds(const ViewBounds& bounds) override {
+      engine.set_bounds(bounds);
+    }
+    void set_interior_detection(bool enabled) override {
+      engine.set_interior_detection(enabled);
+    }
+    void set_render_mode(RenderMode mode) override {
+      engine.set_render_mode(mode);
+    }
+    void set_kernel_variant(KernelVariant variant) override {
+      engine.set_kernel_variant(variant);
+    }
+    void set_interleaving(unsigned int vectors,
+                          unsigned int check_interval) override {
+      engine.set_interleaving(vectors, check_interval);
+    }
+    void set_incremental(bool enabled) override {
+      engine.set_incremental(enabled);
+    }
+    void set_thread_placement(ThreadPlacement placement) override {
+      if constexpr (requires { engine.set_thread_placement(placement); }) {
+        engine.set_thread_placement(placement);
+      }
+    }
+
+    std::size_t width() const noexcept override { return engine.width(); }
+    std::size_t height() const noexcept override { return engine.height(); }
+    const ViewBounds& bounds() const noexcept override {
+      return engine.bounds();
+    }
+    unsigned int max_iterations() const noexcept override {
+      return engine.max_iterations();
+    }
+    std::size_t iterated_pixels() const noexcept override {
+      return engine.iterated_pixels();
+    }
+
+    std::string_view backend_name() const noexcept override {
+      return B::name();
+    }
+    std::string_view exec_name() const noexcept override {
+      return Exec::name();
+    }
+
+    MandelbrotEngine<B, Exec> engine;
+  };
+
+  std::unique_ptr<Concept> m_engine;
+};
+
+/*
+ * Create an engine running on the fastest backend and execution policy that
+ * were compiled in and are supported by the current system.
+ *
+ * Backends are preferred in the order CUDA, AVX512, AVX2, Portable, Serial.
+ * Whenever more than one thread is available, the work-stealing execution
+ * policy is preferred, followed by the OpenMP one.
+ *
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param bounds The bounds of the complex plane.
+ * @param max_iterations The maximum iterations for each pixel.
+ *
+ * @returns The engine.
+ */
+AnyMandelbrotEngine make_engine(std::size_t width, std::size_t height,
+                                const ViewBounds& bounds,
+                                unsigned int max_iterations);
+
+/*
+ * Create an engine running on a specific backend and execution policy.
+ *
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param bounds The bounds of the complex plane.
+ * @param max_iterations The maximum iterations for each pixel.
+ * @param backend The name of the backend, e.g. "AVX2".
+ * @param exec The name of the execution policy, e.g. "OMP".
+ *
+ * @returns The engine.
+ *
+ * @throws std::runtime_error If the combination was not compiled in or is not
+ * supported by the current system.
+ */
+AnyMandelbrotEngine make_engine(std::size_t width, std::size_t height,
+                                const ViewBounds& bounds,
+                                unsigned int max_iterations,
+                                std::string_view backend,
+                                std::string_view exec);
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string_view>
+#include <type_traits>
 
 #if defined(MANDELBROT_HAS_CUDA)
 #include <cuda_runtime.h>
@@ -18,12 +20,103 @@ struct Default : ExecBase {
 struct OMP : ExecBase {
   static constexpr std::string_view name() { return "OMP"; }
 };
+
+/*
+ * Splits the image into tiles that are distributed over per-thread queues.
+ * Threads that run out of tiles steal from the queues of others.
+ */
+struct WorkStealing : ExecBase {
+  static constexpr std::string_view name() { return "WorkStealing"; }
+};
 #endif
 } // namespace exec
 
 template <typename T>
 concept Execution = std::is_base_of_v<exec::ExecBase, T>;
 
+// The floating-point types that pixels can be computed in.
+template <typename T>
+concept Scalar = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/*
+ * The channels that an engine stores for every pixel.
+ *
+ * Each policy selects its channels at compile time, so that the kernels only
+ * store the channels that are kept, and the result only exposes those.
+ */
+namespace channels {
+struct ChannelsBase {};
+
+// The iteration count and the final z-value. This is required for resuming.
+struct Full : ChannelsBase {
+  using Iteration = unsigned int;
+
+  static constexpr bool iterations = true;
+  static constexpr bool z = true;
+  static constexpr bool smooth = false;
+  static constexpr bool distance = false;
+
+  static constexpr std::string_view name() { return "Full"; }
+};
+
+// Only the iteration count.
+struct Iterations : ChannelsBase {
+  using Iteration = unsigned int;
+
+  static constexpr bool iterations = true;
+  static constexpr bool z = false;
+  static constexpr bool smooth = false;
+  static constexpr bool distance = false;
+
+  static constexpr std::string_view name() { return "Iterations"; }
+};
+
+// Only the iteration count, in 16 bits. The maximum iterations must fit.
+struct Iterations16 : ChannelsBase {
+  using Iteration = std::uint16_t;
+
+  static constexpr bool iterations = true;
+  static constexpr bool z = false;
+  static constexpr bool smooth = false;
+  static constexpr bool distance = false;
+
+  static constexpr std::string_view name() { return "Iterations16"; }
+};
+
+// Only the smooth iteration count, as a `float`.
+struct Smooth : ChannelsBase {
+  using Iteration = unsigned int;
+
+  static constexpr bool iterations = false;
+  static constexpr bool z = false;
+  static constexpr bool smooth = true;
+  static constexpr bool distance = false;
+
+  static constexpr std::string_view name() { return "Smooth"; }
+};
+
+/*
+ * The iteration count and the exterior distance estimate, as a `float`.
+ *
+ * The kernels track the derivative of each orbit with respect to the point,
+ * which costs a few more multiply-adds per iteration, so only this policy
+ * does. The SIMD kernels always compute it with the block variant.
+ */
+struct Distance : ChannelsBase {
+  using Iteration = unsigned int;
+
+  static constexpr bool iterations = true;
+  static constexpr bool z = false;
+  static constexpr bool smooth = false;
+  static constexpr bool distance = true;
+
+  static constexpr std::string_view name() { return "Distance"; }
+};
+} // namespace channels
+
+template <typename C>
+concept Channels = std::is_base_of_v<channels::ChannelsBase, C>;
+
 namespace backend {
 struct BackendBase {
   static const std::size_t alignment = alignof(std::max_align_t);
@@ -57,6 +150,18 @@ struct Serial : BackendBase {
   static constexpr bool supports_exec() {
     return true;
   }
+
+  template <Scalar T>
+  /*
+   * Check whether this backend supports a scalar type.
+   *
+   * @tparam The scalar type.
+   *
+   * @returns Whether this backend supports the scalar type.
+   */
+  static constexpr bool supports_scalar() {
+    return true;
+  }
 };
 
 #if defined(MANDELBROT_HAS_AVX2)
@@ -69,11 +174,14 @@ struct AVX2 : BackendBase {
   static constexpr std::string_view name() { return "AVX2"; }
 
   /*
-   * Check whether the current system supports AVX2.
+   * Check whether the current system supports AVX2, and the fused
+   * multiply-adds that the kernels use along with it.
    *
    * @returns Whether the AVX2 backend is available.
    */
-  static bool is_available() { return __builtin_cpu_supports("avx2"); }
+  static bool is_available() {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
 
   template <Execution Exec>
   /*
@@ -87,6 +195,18 @@ struct AVX2 : BackendBase {
     return true;
   }
 
+  template <Scalar T>
+  /*
+   * Check whether this backend supports a scalar type.
+   *
+   * @tparam The scalar type.
+   *
+   * @returns Whether this backend supports the scalar type.
+   */
+  static constexpr bool supports_scalar() {
+    return true;
+  }
+
   static constexpr unsigned int simd_width = 256; // The SIMD width in bits.
   static constexpr unsigned int alignment = simd_width / 8;
 };
@@ -120,6 +240,70 @@ struct AVX512 : BackendBase {
     return true;
   }
 
+  template <Scalar T>
+  /*
+   * Check whether this backend supports a scalar type.
+   *
+   * @tparam The scalar type.
+   *
+   * @returns Whether this backend supports the scalar type.
+   */
+  static constexpr bool supports_scalar() {
+    return true;
+  }
+
+  static constexpr unsigned int simd_width = 512; // The SIMD width in bits.
+  static constexpr unsigned int alignment = simd_width / 8;
+};
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+/*
+ * Vectorizes with `std::experimental::simd`, for the instruction set that the
+ * library was built for, see `MANDELBROT_PORTABLE_FLAGS`.
+ */
+struct Portable : BackendBase {
+  /*
+   * Get the name of the backend.
+   *
+   * @returns The name of the portable backend.
+   */
+  static constexpr std::string_view name() { return "Portable"; }
+
+  /*
+   * Check whether the current system supports the instruction set that the
+   * portable backend was built for.
+   *
+   * @returns Whether the portable backend is available.
+   */
+  static bool is_available();
+
+  template <Execution Exec>
+  /*
+   * Check whether this backend supports an execution policy.
+   *
+   * @tparam The execution policy.
+   *
+   * @returns Whether this backend supports the execution policy.
+   */
+  static constexpr bool supports_exec() {
+    return true;
+  }
+
+  template <Scalar T>
+  /*
+   * Check whether this backend supports a scalar type.
+   *
+   * @tparam The scalar type.
+   *
+   * @returns Whether this backend supports the scalar type.
+   */
+  static constexpr bool supports_scalar() {
+    return true;
+  }
+
+  // The vectors of the kernels always hold 64 bytes, whatever the instruction
+  // set.
   static constexpr unsigned int simd_width = 512; // The SIMD width in bits.
   static constexpr unsigned int alignment = simd_width / 8;
 };
@@ -157,6 +341,18 @@ struct CUDA : BackendBase {
   static constexpr bool supports_exec() {
     return std::is_same_v<Exec, exec::Default>;
   }
+
+  template <Scalar T>
+  /*
+   * Check whether this backend supports a scalar type.
+   *
+   * @tparam The scalar type.
+   *
+   * @returns Whether this backend supports the scalar type.
+   */
+  static constexpr bool supports_scalar() {
+    return std::is_same_v<T, float>;
+  }
 };
 #endif
 } // namespace backend
@@ -167,3 +363,22 @@ concept Backend = std::is_base_of_v<backend::BackendBase, T>;
 template <typename B, typename E>
 concept Compatible =
     Backend<B> && Execution<E> && B::template supports_exec<E>();
+
+template <typename B, typename T>
+concept SupportsScalar =
+    Backend<B> && Scalar<T> && B::template supports_scalar<T>();
+
+// The backends whose kernels run on the host, which are the CPU backends.
+template <typename B>
+concept HostBackend = Backend<B>
+#if defined(MANDELBROT_HAS_CUDA)
+                      && !std::is_same_v<B, backend::CUDA>
+#endif
+    ;
+
+// The CPU backends support every set of channels, the others only the full
+// one.
+template <typename B, typename C>
+concept SupportsChannels =
+    Backend<B> && Channels<C> &&
+    (HostBackend<B> || std::is_same_v<C, channels::Full>);
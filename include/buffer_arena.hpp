@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*
+ * The pages that the blocks of a `BufferArena` are made of.
+ */
+enum class HugePages {
+  None,        // Regular pages.
+  Transparent, // Regular pages that the kernel may merge into huge pages.
+  Explicit,    // Huge pages reserved by the system, or else regular pages.
+};
+
+/*
+ * A pool of memory blocks for the buffers of results.
+ *
+ * Engines that share an arena borrow their buffers from it and return them
+ * when they are destroyed or reallocate, so that constructing an engine per
+ * request doesn't allocate or fault in any memory once the arena is warm.
+ *
+ * Sizes are rounded up to a power of two, of at least 64 KiB, or of at least
+ * one huge page with huge pages, so that a block can serve any buffer of its
+ * size class. New blocks are mapped and faulted in at once, and released blocks
+ * are kept for later buffers until the arena is destroyed. Blocks are aligned
+ * to at least a page, so they satisfy the alignment of every backend.
+ *
+ * Faulting in a block places its pages on the NUMA node of the thread that
+ * maps it. Engines with a thread placement therefore take blocks that aren't
+ * faulted in, whose pages their threads place, see
+ * `MandelbrotEngine::set_thread_placement`. Those blocks are kept apart from
+ * the others once released, so that they are only reused by such engines.
+ *
+ * The arena is safe to use from several threads. It must outlive the buffers
+ * it hands out, which is why engines hold it by `std::shared_ptr`.
+ */
+class BufferArena {
+public:
+  /*
+   * Create an empty arena.
+   *
+   * @param huge_pages The pages of the blocks. Explicit huge pages must have
+   * been reserved, e.g. through /proc/sys/vm/nr_hugepages. Without enough of
+   * them, blocks fall back to transparent huge pages.
+   */
+  explicit BufferArena(HugePages huge_pages = HugePages::None)
+      : m_huge_pages{huge_pages} {};
+
+  BufferArena(const BufferArena&) = delete;
+  BufferArena& operator=(const BufferArena&) = delete;
+
+  ~BufferArena();
+
+  /*
+   * Take a block of at least `size` bytes, mapping a new one if no released
+   * block of its size class is left.
+   *
+   * @param size The size in bytes.
+   * @param populate Whether a new block is faulted in when it is mapped, or
+   * left for the threads that first write it to place its pages. A released
+   * block is only reused by allocations with the same setting.
+   *
+   * @returns The block.
+   *
+   * @throws std::bad_alloc If no block can be mapped.
+   */
+  [[nodiscard]] void* allocate(std::size_t size, bool populate = true);
+
+  /*
+   * Release a block for later allocations.
+   *
+   * @param block The block.
+   * @param size The size it was allocated with.
+   * @param populate The setting it was allocated with.
+   */
+  void deallocate(void* block, std::size_t size, bool populate = true) noexcept;
+
+  /*
+   * Map blocks ahead of the allocations, so that the first allocations are as
+   * fast as later ones.
+   *
+   * @param size The size of the blocks in bytes.
+   * @param count The number of released blocks of that size class to have.
+   *
+   * @throws std::bad_alloc If a block can't be mapped.
+   */
+  void reserve(std::size_t size, std::size_t count);
+
+  /*
+   * Get the size of all blocks, allocated or released.
+   *
+   * @returns The size in bytes.
+   */
+  std::size_t mapped_bytes() const;
+
+  /*
+   * Get the size of the released blocks.
+   *
+   * @returns The size in bytes.
+   */
+  std::size_t cached_bytes() const;
+
+  HugePages huge_pages() const noexcept { return m_huge_pages; }
+
+private:
+  std::size_t size_class(std::size_t size) const noexcept;
+  void* map_block(std::size_t size, bool populate);
+
+  HugePages m_huge_pages;
+
+  mutable std::mutex m_mutex;
+
+  // The released blocks by size class, and whether they were faulted in when
+  // they were mapped.
+  std::map<std::pair<std::size_t, bool>, std::vector<void*>> m_released;
+  std::size_t m_mapped{0};
+  std::size_t m_cached{0};
+};
@@ -0,0 +1,235 @@
+/*
+ * This file contains the declarations for colorizing results.
+ *
+ * A `Colorizer` turns the smooth iteration counts of an image into packed 8-bit
+ * pixels. The smooth iteration count of a pixel is mapped to a position in a
+ * `Palette`, a lookup table sampled from a gradient function once, so that
+ * coloring a pixel takes no trigonometry. The CPU with the widest SIMD
+ * instructions that the library was compiled for colors 8 or 16 pixels at a
+ * time.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "backends.hpp"
+#include "mandelbrot_result.hpp"
+#include "utility.hpp"
+
+/*
+ * The layout of a colored pixel.
+ */
+enum class PixelFormat {
+  Grey8,  // One byte of luminance.
+  RGB8,   // Three bytes, red first.
+  RGBA8,  // Four bytes, red first.
+};
+
+/*
+ * Get the number of bytes per pixel of a pixel format.
+ *
+ * @param format The pixel format.
+ *
+ * @returns The number of bytes per pixel.
+ */
+constexpr std::size_t bytesPerPixel(const PixelFormat format) noexcept {
+  switch (format) {
+  case PixelFormat::Grey8:
+    return 1;
+  case PixelFormat::RGB8:
+    return 3;
+  case PixelFormat::RGBA8:
+    return 4;
+  }
+
+  return 0;
+}
+
+struct Color {
+  std::uint8_t r, g, b;
+  std::uint8_t a{255};
+
+  bool operator==(const Color&) const = default;
+};
+
+/*
+ * A lookup table of colors, sampled from a gradient over [0, 1).
+ */
+class Palette {
+public:
+  /*
+   * Sample a gradient function.
+   *
+   * @param gradient The gradient, called with positions in [0, 1).
+   * @param size The number of colors in the table.
+   *
+   * @throws std::invalid_argument If the size is zero.
+   */
+  explicit Palette(const std::function<Color(float)>& gradient,
+                   std::size_t size = 1024);
+
+  /*
+   * The cosine rainbow of examples/rainbow.cpp, red at position 0.
+   */
+  static Palette rainbow(std::size_t size = 1024);
+
+  /*
+   * A ramp from black at position 0 to white at position 1.
+   */
+  static Palette greyscale(std::size_t size = 1024);
+
+  /*
+   * Interpolate linearly between colors at given positions. Positions before
+   * the first stop or after the last take the color of that stop.
+   *
+   * @param stops The positions in [0, 1] and their colors, in any order.
+   * @param size The number of colors in the table.
+   *
+   * @throws std::invalid_argument If there are no stops or the size is zero.
+   */
+  static Palette gradient(std::vector<std::pair<float, Color>> stops,
+                          std::size_t size = 1024);
+
+  Color operator[](std::size_t idx) const noexcept;
+
+  std::size_t size() const noexcept { return m_colors.size(); }
+
+  // The colors packed as RGBA8, red in the lowest byte.
+  const std::uint32_t* colors() const noexcept { return m_colors.data(); }
+
+  // The luminance of the colors, in the lowest byte.
+  const std::uint32_t* greys() const noexcept { return m_greys.data(); }
+
+private:
+  utility::AlignedVector<std::uint32_t, 64> m_colors;
+  utility::AlignedVector<std::uint32_t, 64> m_greys;
+};
+
+struct ColorKernels;
+
+/*
+ * Colors images by their smooth iteration counts.
+ *
+ * A pixel that escaped maps to the palette position
+ * `frac(cycles * (smooth / max_iterations) ^ exponent)`. The exponent
+ * stretches the low iteration counts, where most of the detail is, and the
+ * palette repeats `cycles` times over the range of iteration counts. Pixels
+ * that didn't escape take the interior color.
+ */
+class Colorizer {
+public:
+  /*
+   * Create a colorizer.
+   *
+   * @param palette The palette.
+   * @param exponent The exponent applied to the relative iteration counts.
+   * @param cycles The number of times the palette repeats.
+   * @param interior The color of the pixels that didn't escape.
+   */
+  explicit Colorizer(Palette palette = Palette::rainbow(),
+                     float exponent = 0.5f, float cycles = 2.0f,
+                     Color interior = {0, 0, 0});
+
+  /*
+   * Color a run of pixels.
+   *
+   * @param smooth The smooth iteration counts of the pixels, see
+   * `channels::Smooth`.
+   * @param count The number of pixels.
+   * @param max_iterations The maximum iterations of the computation.
+   * @param format The pixel format.
+   * @param pixels The colored pixels, `count * bytesPerPixel(format)` bytes.
+   */
+  void colorize(const float* smooth, std::size_t count,
+                unsigned int max_iterations, PixelFormat format,
+                std::uint8_t* pixels) const;
+
+  /*
+   * Color the image of a result, in parallel if OpenMP is enabled.
+   *
+   * Full results are colored by the smooth iteration counts derived from
+   * their z-values. Results with iteration counts only are colored by those,
+   * which shows bands.
+   *
+   * @param result The result.
+   * @param max_iterations The maximum iterations of the computation.
+   * @param format The pixel format.
+   * @param pixels The colored image, rows of `width * bytesPerPixel(format)`
+   * bytes without padding.
+   */
+  template <Backend B, Scalar T, Channels C>
+  void colorize(const MandelbrotResult<B, T, C>& result,
+                const unsigned int max_iterations, const PixelFormat format,
+                std::uint8_t* pixels) const {
+    const auto& host = *result.m_resources;
+    const std::size_t width = result.width();
+
+    colorize_rows(
+        result.height(), width, max_iterations, format, pixels,
+        [&](const std::size_t row, float* smooth) -> const float* {
+          const std::size_t first = row * width;
+
+          if constexpr (C::smooth) {
+            return host.smooth.data() + first;
+          } else if constexpr (C::z) {
+            smooth_row(host.iterations.data() + first,
+                       host.z_reals.data() + first,
+                       host.z_imags.data() + first, width, max_iterations,
+                       smooth);
+            return smooth;
+          } else {
+            for (std::size_t col = 0; col < width; ++col) {
+              smooth[col] = static_cast<float>(host.iterations[first + col]);
+            }
+            return smooth;
+          }
+        });
+  }
+
+  /*
+   * Get the color of a single pixel.
+   *
+   * The vectorized paths approximate the exponent, so their colors may differ
+   * by one palette entry.
+   *
+   * @param smooth The smooth iteration count of the pixel.
+   * @param max_iterations The maximum iterations of the computation.
+   *
+   * @returns The color.
+   */
+  Color color(float smooth, unsigned int max_iterations) const noexcept;
+
+  const Palette& palette() const noexcept { return m_palette; }
+  float exponent() const noexcept { return m_exponent; }
+  float cycles() const noexcept { return m_cycles; }
+  Color interior() const noexcept { return m_interior; }
+
+private:
+  // Get the smooth iteration counts of a row, into a buffer of its width if
+  // they aren't stored.
+  using RowSource = std::function<const float*(std::size_t, float*)>;
+
+  void colorize_rows(std::size_t height, std::size_t width,
+                     unsigned int max_iterations, PixelFormat format,
+                     std::uint8_t* pixels, const RowSource& source) const;
+
+  void smooth_row(const unsigned int* iterations, const float* z_reals,
+                  const float* z_imags, std::size_t count,
+                  unsigned int max_iterations, float* smooth) const;
+  void smooth_row(const unsigned int* iterations, const double* z_reals,
+                  const double* z_imags, std::size_t count,
+                  unsigned int max_iterations, float* smooth) const;
+
+  Palette m_palette;
+  float m_exponent;
+  float m_cycles;
+  Color m_interior;
+
+  // The implementation for the widest SIMD instructions of the CPU.
+  const ColorKernels* m_kernels;
+};
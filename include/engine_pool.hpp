@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "buffer_arena.hpp"
+#include "mandelbrot_engine.hpp"
+
+/*
+ * A pool of idle engines, so that a request for an image doesn't construct an
+ * engine, allocate its buffers or fault in their pages once the pool is warm.
+ *
+ * A pool holds engines of a single backend, execution policy, scalar type and
+ * set of channels, so a service with several backends keeps a pool for each.
+ * Within a pool, idle engines are kept by size class, which is the number of
+ * pixels rounded up to a power of two. A request takes an idle engine of its
+ * size class if there is one, and otherwise creates one. All engines of a pool
+ * borrow their buffers from the arena of the pool, so that even new engines
+ * reuse the buffers of engines that were dropped.
+ *
+ * A reused engine has its settings restored to the defaults, so that no
+ * setting of a previous request carries over into the next. The pool is safe
+ * to use from several threads, and engines may be returned after the pool is
+ * destroyed.
+ */
+template <Backend B = backend::Serial, Execution Exec = exec::Default,
+          Scalar T = float, Channels C = channels::Full>
+  requires HostBackend<B> && Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+class EnginePool {
+public:
+  using Engine = MandelbrotEngine<B, Exec, T, C>;
+
+private:
+  struct State {
+    std::shared_ptr<BufferArena> arena;
+    std::size_t max_idle;
+
+    std::mutex mutex;
+
+    // The idle engines by size class.
+    std::map<std::size_t, std::vector<std::unique_ptr<Engine>>> idle;
+  };
+
+  /*
+   * Returns an engine to its pool when its lease ends.
+   */
+  struct Release {
+    void operator()(Engine* engine) const noexcept {
+      std::unique_ptr<Engine> owned{engine};
+      std::lock_guard lock{state->mutex};
+
+      try {
+        auto& idle = state->idle[size_class];
+
+        if (idle.size() < state->max_idle) {
+          idle.push_back(std::move(owned));
+        }
+      } catch (...) {
+        // Without memory to keep the engine, drop it.
+      }
+    }
+
+    std::shared_ptr<State> state;
+    std::size_t size_class;
+  };
+
+public:
+  // An engine taken from the pool, which returns to it when destroyed.
+  using Lease = std::unique_ptr<Engine, Release>;
+
+  /*
+   * Create an empty pool.
+   *
+   * @param arena The arena to borrow the buffers of the engines from.
+   * @param max_idle The maximum number of idle engines of each size class.
+   * Engines returned beyond that are destroyed, and their buffers returned to
+   * the arena.
+   */
+  explicit EnginePool(
+      std::shared_ptr<BufferArena> arena = std::make_shared<BufferArena>(),
+      std::size_t max_idle = 4)
+      : m_state{std::make_shared<State>(std::move(arena), max_idle)} {};
+
+  /*
+   * Take an engine for a request.
+   *
+   * @param width The width of the image.
+   * @param height The height of the image.
+   * @param bounds The bounds of the complex plane.
+   * @param max_iterations The maximum iterations for each pixel.
+   *
+   * @returns The engine, set to the request, with the default settings.
+   *
+   * @throws std::runtime_error If the backend is not available.
+   * @throws std::invalid_argument If the channels can't hold the maximum
+   * iterations.
+   */
+  Lease acquire(std::size_t width, std::size_t height,
+                const ViewBounds& bounds, unsigned int max_iterations) {
+    const std::size_t size_class =
+        std::bit_ceil(std::max<std::size_t>(width * height, 1));
+    std::unique_ptr<Engine> engine;
+
+    {
+      std::lock_guard lock{m_state->mutex};
+      auto idle = m_state->idle.find(size_class);
+
+      if (idle != m_state->idle.end() && !idle->second.empty()) {
+        engine = std::move(idle->second.back());
+        idle->second.pop_back();
+      }
+    }
+
+    if (engine) {
+      engine->reset_settings();
+      engine->set_max_iterations(max_iterations);
+      engine->set_size(width, height);
+      engine->set_bounds(bounds);
+    } else {
+      engine = std::make_unique<Engine>(width, height, bounds, max_iterations,
+                                        m_state->arena);
+    }
+
+    return Lease{engine.release(), Release{m_state, size_class}};
+  }
+
+  /*
+   * Get the number of idle engines.
+   *
+   * @returns The number of idle engines of all size classes.
+   */
+  std::size_t idle_engines() const {
+    std::lock_guard lock{m_state->mutex};
+    std::size_t count{0};
+
+    for (const auto& [size_class, idle] : m_state->idle) {
+      count += idle.size();
+    }
+
+    return count;
+  }
+
+  const std::shared_ptr<BufferArena>& arena() const noexcept {
+    return m_state->arena;
+  }
+
+private:
+  // Shared with the leases, so that engines can outlive the pool.
+  std::shared_ptr<State> m_state;
+};
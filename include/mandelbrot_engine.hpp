@@ -1,44 +1,693 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <format>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #if defined(MANDELBROT_HAS_CUDA)
 #include <cuda_runtime.h>
 #endif
 
 #include "backends.hpp"
+#include "buffer_arena.hpp"
+#include "colorize.hpp"
 #include "mandelbrot_result.hpp"
 #include "resources.hpp"
 
+/*
+ * The bounds of the complex plane to render.
+ *
+ * The bounds are stored in double precision, so that they can describe deep
+ * zooms. An engine computing in single precision rounds them to `float`.
+ */
 struct ViewBounds {
-  ViewBounds(float real_min, float real_max, float imag_min, float imag_max)
+  ViewBounds(double real_min, double real_max, double imag_min,
+             double imag_max)
       : real_min{real_min}, real_max{real_max}, imag_min{imag_min},
         imag_max{imag_max} {};
 
-  float real_min, real_max;
-  float imag_min, imag_max;
+  bool operator==(const ViewBounds&) const = default;
+
+  double real_min, real_max;
+  double imag_min, imag_max;
+};
+
+/*
+ * The strategy used to render an image.
+ */
+enum class RenderMode {
+  Full,        // Every pixel is iterated.
+  Subdivision, // Mariani-Silver rectangle subdivision.
+};
+
+/*
+ * The way a SIMD kernel assigns pixels to its lanes.
+ */
+enum class KernelVariant {
+  Block,       // Each block of pixels iterates until its slowest pixel retires.
+  LaneRefill,  // Retired lanes immediately pick up the next pending pixel.
+  Interleaved, // Several blocks iterate together, checking for escapes rarely.
+};
+
+/*
+ * The shape of the interleaved SIMD kernels, see
+ * `MandelbrotEngine::set_interleaving`.
+ */
+struct Interleaving {
+  bool operator==(const Interleaving&) const = default;
+
+  unsigned int vectors;        // The number of vectors iterated together.
+  unsigned int check_interval; // The iterations between escape checks.
+};
+
+/*
+ * The placement of the samples within a supersampled pixel.
+ */
+enum class SamplePattern {
+  Grid,     // The samples are spread evenly over the pixel.
+  Jittered, // Each sample is placed randomly within its cell of the grid.
+};
+
+/*
+ * The placement of the threads of the parallel execution policies on the
+ * CPUs, see `MandelbrotEngine::set_thread_placement`.
+ */
+enum class ThreadPlacement {
+  None,   // The threads and the memory are placed by the operating system.
+  Close,  // The threads fill the CPUs of one NUMA node before the next.
+  Spread, // The threads take the NUMA nodes in turn.
+};
+
+/*
+ * The statistics of a single thread during a parallel computation.
+ */
+struct WorkerStats {
+  std::chrono::nanoseconds busy{0}; // Time spent computing tiles.
+  std::chrono::nanoseconds idle{0}; // Time spent looking for or out of work.
+  std::size_t tasks{0};             // The number of tiles computed.
+  std::size_t steals{0};            // The number of times work was stolen.
 };
 
-template <Backend B = backend::Serial, Execution Exec = exec::Default>
-  requires Compatible<B, Exec>
+/*
+ * Computes the Mandelbrot set on a backend `B`, using execution policy `Exec`
+ * and scalar type `T`, storing the channels `C` of every pixel.
+ *
+ * Single precision suffices until the distance between pixels approaches
+ * 1e-7 times the magnitude of their coordinates, after which neighbouring
+ * pixels collapse onto the same point. Double precision pushes that limit to
+ * about 1e-16, at half the SIMD lanes.
+ *
+ * Storing fewer or narrower channels than `channels::Full` shrinks the results
+ * and the memory traffic of writing them. Resuming, computing in bands and
+ * result files need the full channels.
+ */
+template <Backend B = backend::Serial, Execution Exec = exec::Default,
+          Scalar T = float, Channels C = channels::Full>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
 class MandelbrotEngine {
 public:
+  /*
+   * Create an engine.
+   *
+   * @param width The width of the image.
+   * @param height The height of the image.
+   * @param bounds The bounds of the complex plane.
+   * @param max_iterations The maximum iterations for each pixel.
+   * @param arena The arena to borrow the buffers of the results from, if any.
+   * The buffers are returned to it when the engine is destroyed.
+   *
+   * @throws std::runtime_error If the backend is not available.
+   * @throws std::invalid_argument If the channels can't hold the maximum
+   * iterations.
+   */
   MandelbrotEngine(std::size_t width, std::size_t height,
-                   const ViewBounds& bounds, unsigned int max_iterations)
+                   const ViewBounds& bounds, unsigned int max_iterations,
+                   std::shared_ptr<BufferArena> arena = nullptr)
       : m_width{width}, m_height{height}, m_bounds{bounds},
-        m_max_iterations{max_iterations}, m_host{width * height},
-        m_device{width * height} {
+        m_max_iterations{max_iterations}, m_arena{std::move(arena)},
+        m_host{width * height, m_arena}, m_device{width * height} {
     if (!B::is_available()) {
       throw std::runtime_error(
           std::format("{} backend is not available.", B::name()));
     }
+
+    check_max_iterations(max_iterations);
   };
 
-  MandelbrotResult<B> compute();
+  MandelbrotResult<B, T, C> compute();
+
+  /*
+   * Take the buffers of the last computation out of the engine, so that its
+   * result stays valid while later images are computed, without a copy.
+   *
+   * The engine allocates new buffers for the next computation, from its arena
+   * if it has one, and the taken buffers are freed, or returned to the arena,
+   * once the result is destroyed. Results that refer to the buffers of the
+   * engine are invalidated, and the next computation can't reuse the pixels
+   * of the taken one for incremental rendering or resuming. A result file
+   * that the buffers were mapped to stays mapped until the result is
+   * destroyed, and later computations are kept in memory.
+   *
+   * @returns The result of the last computation, owning its buffers.
+   *
+   * @throws std::logic_error If the engine holds no result.
+   */
+  MandelbrotResult<B, T, C> take_result() {
+    if (!m_host.allocated()) {
+      throw std::logic_error("No result to take.");
+    }
+
+    auto taken = std::make_shared<const HostResources<B, T, C>>(
+        std::exchange(m_host, empty_host()));
+
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+
+    return {std::move(taken), m_width, m_height};
+  }
+
+  /*
+   * Compute the Mandelbrot set on another thread.
+   *
+   * The image is computed into a buffer of its own, taken from a pool of
+   * buffers that no result refers to anymore, or added to the pool if there is
+   * none. The result shares ownership of the buffer, so that it stays valid
+   * while later images are computed, and the buffer returns to the pool once
+   * the result is destroyed. Displaying one image while computing the next
+   * takes two buffers.
+   *
+   * The computation uses the settings and bounds of the engine at the time of
+   * the call, and leaves the results, statistics and incremental rendering of
+   * the engine as they are. A cancelled computation stops before the next row
+   * it would compute, or with subdivision before the next rectangle.
+   *
+   * The future is that of `std::async`, so destroying it waits for the
+   * computation to finish. To drop a computation without waiting on it, cancel
+   * it first, through `cancel_async` or by starting the next one, so that the
+   * wait only lasts until the rows that are being computed are done.
+   *
+   * @param cancel_previous Whether to cancel the previous asynchronous
+   * computation, if it is still running.
+   *
+   * @returns The future result, which is empty if the computation was
+   * cancelled.
+   */
+  std::future<std::optional<MandelbrotResult<B, T, C>>>
+  compute_async(bool cancel_previous = true)
+    requires HostBackend<B>;
+
+  /*
+   * Cancel the last asynchronous computation, if it is still running, so that
+   * its result is empty.
+   */
+  void cancel_async() noexcept {
+    if (m_async_cancelled) {
+      m_async_cancelled->store(true);
+    }
+  }
+
+  /*
+   * Raise the maximum iterations of the last computation without starting
+   * over.
+   *
+   * Only the pixels that reached the previous maximum iterations are iterated
+   * further, continuing from their iteration count and z-value. They are
+   * gathered into a compact list first, so that the SIMD lanes aren't wasted
+   * on pixels that already escaped. The result equals that of a computation
+   * with the new maximum iterations, except for the z-values of pixels found
+   * by interior detection.
+   *
+   * Pixels filled in by subdivision have no z-value of their own, so after a
+   * subdivision render the resumed pixels are iterated from the start. If the
+   * bounds or the settings that affect the result changed since the last
+   * computation, the image is computed from scratch. The CUDA backend always
+   * computes the image from scratch.
+   *
+   * @param max_iterations The new maximum iterations.
+   *
+   * @returns MandelbrotResult containing iteration and final z-value per pixel.
+   *
+   * @throws std::invalid_argument If the new maximum iterations is lower than
+   * the current one.
+   */
+  MandelbrotResult<B, T> resume(unsigned int max_iterations)
+    requires std::is_same_v<C, channels::Full>;
+
+  /*
+   * Compute the image in bands of rows, handing each band to `sink` as soon as
+   * it is finished.
+   *
+   * Only the buffers of the bands being computed are allocated, rather than
+   * those of the whole image, and they are reused for later bands. This allows
+   * computing images that don't fit in memory: the memory used is that of one
+   * band per thread, regardless of the size of the image. An engine that only
+   * computes in bands never allocates the buffers of the whole image.
+   *
+   * The parallel execution policies compute one band per thread at a time.
+   * Either way, `sink` is called for one band at a time, in the order of the
+   * rows. With a parallel execution policy, `sink` must not throw.
+   *
+   * Bands are always iterated in full, so the render mode and incremental
+   * rendering don't apply.
+   *
+   * @param band_height The number of rows per band. The last band may have
+   * fewer.
+   * @param sink The function to pass each finished band to.
+   */
+  void compute_bands(std::size_t band_height,
+                     const std::function<void(const MandelbrotBand<T>&)>& sink)
+    requires HostBackend<B> && std::is_same_v<C, channels::Full>;
+
+  /*
+   * Compute a sequence of frames, such as those of a zoom animation, handing
+   * each finished frame to `sink` in order.
+   *
+   * The parallel execution policies split every frame into tiles, of 64 by 16
+   * pixels unless set by `set_tile_size`, and the threads take the tiles of all
+   * frames from a single queue, in the order of the frames. Threads that run
+   * out of tiles of one frame carry on with the next while the slowest tiles
+   * of the frame are finished, rather than idling until the frame is done. The
+   * frames in flight are computed into a small pool of buffers that is kept
+   * for later batches. A frame is handed to `sink` by the thread that finishes
+   * it, once the frames before it have been. `sink` is called for one frame at
+   * a time, while the other threads keep computing. With a parallel execution
+   * policy, `sink` must not throw.
+   *
+   * Frames are always iterated in full, so the render mode and incremental
+   * rendering don't apply. The bounds and results of the engine are left as
+   * they are.
+   *
+   * @param frames The bounds of the frames.
+   * @param sink The function to pass each finished frame to, with its index.
+   * The result refers to a buffer that is reused for later frames, so it is
+   * only valid during the call.
+   */
+  void compute_batch(
+      std::span<const ViewBounds> frames,
+      const std::function<void(std::size_t, const MandelbrotResult<B, T, C>&)>&
+          sink)
+    requires HostBackend<B>;
+
+  /*
+   * Compute the image and color it in one pass.
+   *
+   * Every row is computed into a buffer of smooth iteration counts, which the
+   * kernels derive from the z-values while they are still in registers, and
+   * colored while the buffer is in the cache. Neither the z-values nor the
+   * iteration counts are written to memory, and the buffers of the engine are
+   * not allocated. The execution policy spreads the rows over the threads.
+   *
+   * The render mode and incremental rendering don't apply, and the results of
+   * the engine are left as they are. With supersampling enabled, the smooth
+   * iteration counts of the whole image are kept until its edges are found,
+   * see `set_supersampling`.
+   *
+   * @param colorizer The colorizer.
+   * @param format The pixel format.
+   * @param pixels The colored image, rows of `width * bytesPerPixel(format)`
+   * bytes without padding.
+   */
+  void compute_image(const Colorizer& colorizer, PixelFormat format,
+                     std::uint8_t* pixels)
+    requires HostBackend<B>;
 
   void set_bounds(const ViewBounds& bounds) { m_bounds = bounds; }
 
+  /*
+   * Set the maximum iterations for each pixel.
+   *
+   * @param max_iterations The maximum iterations.
+   *
+   * @throws std::invalid_argument If the channels can't hold the maximum
+   * iterations.
+   */
+  void set_max_iterations(unsigned int max_iterations) {
+    check_max_iterations(max_iterations);
+
+    m_max_iterations = max_iterations;
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Set the radius beyond which a pixel counts as escaped.
+   *
+   * The smooth iteration counts assume that |z| is much larger than 2 when a
+   * pixel escapes, so a larger radius makes them more accurate, at the cost of
+   * a few more iterations for every escaping pixel. A radius of 2 gives the
+   * classic iteration counts. The smooth iteration counts are computed from
+   * the norms as `float`, which bounds the radius.
+   *
+   * Result files don't record the radius, so a computation must be resumed
+   * with the radius it was started with.
+   *
+   * @param radius The bailout radius.
+   *
+   * @throws std::invalid_argument If the radius is below 2 or above 1e9.
+   */
+  void set_bailout_radius(double radius) {
+    if (!(radius >= 2.0 && radius <= 1e9)) {
+      throw std::invalid_argument(
+          std::format("The bailout radius {} is not within [2, 1e9].", radius));
+    }
+
+    m_bailout_radius = radius;
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Change the size of the image.
+   *
+   * The buffers of the results keep their memory, and are only reallocated
+   * once they are too small. An engine can therefore be reused for images of
+   * different sizes without allocating, see `EnginePool`. Results mapped to a
+   * file are discarded.
+   *
+   * @param width The width of the image.
+   * @param height The height of the image.
+   */
+  void set_size(std::size_t width, std::size_t height)
+    requires HostBackend<B>
+  {
+    m_width = width;
+    m_height = height;
+
+    if (m_host.mapping) {
+      m_host = empty_host();
+    } else {
+      m_host.resize(width * height);
+    }
+
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Enable or disable interior detection.
+   *
+   * With interior detection enabled, pixels within the main cardioid or the
+   * period-2 bulb are not iterated, and orbits are checked for periodicity so
+   * that pixels inside the set stop iterating as soon as they are proven to
+   * never escape. Their iteration count is the maximum iterations, as without
+   * interior detection, but their z-value is the one at the time of detection.
+   *
+   * @param enabled Whether interior detection should be enabled.
+   */
+  void set_interior_detection(bool enabled) noexcept {
+    m_interior_detection = enabled;
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Set the strategy used to render an image.
+   *
+   * With `RenderMode::Subdivision`, the border of a rectangle is computed
+   * first. If every pixel on it has the same iteration count, the inside of the
+   * rectangle is filled in without iterating it. Otherwise, the rectangle is
+   * split and the halves are handled the same way. Filled pixels take the
+   * z-value of the top-left pixel of their rectangle.
+   *
+   * Subdivision is only supported by the CPU backends, and compares iteration
+   * counts, so it needs them among the channels. Otherwise, every pixel is
+   * iterated.
+   *
+   * @param mode The render mode.
+   */
+  void set_render_mode(RenderMode mode) noexcept {
+    m_render_mode = mode;
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Count the pixels near the boundary of the set as part of it, so that the
+   * thin filaments of the set show up in line art.
+   *
+   * A pixel whose distance estimate is below `threshold` times the distance
+   * between two pixels gets the maximum iterations and a distance of 0. As
+   * the estimate is at most four times the actual distance, a threshold of 1
+   * marks every pixel that the set passes through, and some of their
+   * neighbours.
+   *
+   * @param threshold The threshold in pixels. A threshold of 0 disables the
+   * boundary.
+   */
+  void set_boundary_threshold(float threshold) noexcept
+    requires(C::distance)
+  {
+    m_boundary_threshold = std::max(threshold, 0.0f);
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Set the way the SIMD kernels assign pixels to their lanes.
+   *
+   * With `KernelVariant::Block`, a block of pixels keeps iterating until its
+   * slowest pixel retires, leaving the lanes of escaped pixels idle. With
+   * `KernelVariant::LaneRefill`, the pixels a thread is given are queued, and a
+   * lane picks up the next pending pixel as soon as its own pixel retires. This
+   * pays off where neighbouring pixels have very different iteration counts,
+   * such as near the boundary of the set. `KernelVariant::Interleaved` iterates
+   * several blocks together, see `set_interleaving`.
+   *
+   * The kernels of every variant share the step that iterates the points, so
+   * their results are identical. Backends without SIMD lanes ignore the
+   * setting.
+   *
+   * @param variant The kernel variant.
+   */
+  void set_kernel_variant(KernelVariant variant) noexcept {
+    m_kernel_variant = variant;
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Set the shape of the kernels of `KernelVariant::Interleaved`.
+   *
+   * The iterations of a single vector of pixels depend on each other, so the
+   * block kernel waits on the latency of every multiplication. The interleaved
+   * kernel iterates `vectors` independent vectors together instead, with fused
+   * multiply-adds, and only checks for escaped pixels every `check_interval`
+   * iterations. A vector with a pixel that escaped during an interval is
+   * rolled back to the start of the interval and repeats it one iteration at
+   * a time, so the iteration counts are exact. The best shape depends on the
+   * latency and throughput of the CPU.
+   *
+   * A vector of `backend::Portable` spans several registers with instruction
+   * sets narrower than AVX512, which are independent as well. Its kernels
+   * count `vectors` in registers, and iterate correspondingly fewer vectors.
+   *
+   * The results are identical to those of the other variants. Interior
+   * detection checks every iteration, so with it enabled, the block kernel is
+   * used instead.
+   *
+   * @param vectors The number of vectors, clamped to [2, 4].
+   * @param check_interval The number of iterations between escape checks,
+   * rounded down to a power of two in [1, 32].
+   */
+  void set_interleaving(unsigned int vectors,
+                        unsigned int check_interval) noexcept {
+    m_interleaving = {std::clamp(vectors, 2u, 4u),
+                      std::bit_floor(std::clamp(check_interval, 1u, 32u))};
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+  }
+
+  /*
+   * Enable or disable incremental rendering.
+   *
+   * With incremental rendering enabled, a computation whose bounds are the
+   * bounds of the previous computation translated by a whole number of pixels
+   * reuses the pixels that both views share. They are shifted in place, and
+   * only the newly exposed strips along the edges are computed. Any other
+   * change of the bounds, or of the settings that affect the result, leads to
+   * a full render.
+   *
+   * The reused pixels were computed at their position in the previous view,
+   * which may differ from their position in the new view by rounding errors.
+   * Incremental rendering is only supported by the CPU backends.
+   *
+   * @param enabled Whether incremental rendering should be enabled.
+   */
+  void set_incremental(bool enabled) noexcept {
+    m_incremental = enabled;
+    m_rendered_bounds.reset();
+  }
+
+  /*
+   * Store the results in a file rather than in memory.
+   *
+   * The file is created, overwriting any existing file, and mapped into
+   * memory. Computations write their results to the mapping, so that the
+   * operating system can page them out to the file, and images larger than the
+   * memory can be computed. The file can be opened by other tools without a
+   * copy or parse step, see result_file.hpp. Its header records the bounds and
+   * maximum iterations of the last computation.
+   *
+   * The results of a mapped engine are computed row by row from the top, with
+   * every thread taking the next row, so that the pages are written in order
+   * rather than scattered over tiles. Any previous results are discarded.
+   *
+   * @param path The path of the file.
+   *
+   * @throws std::system_error If the file can't be created or mapped.
+   */
+  void map_results(const std::filesystem::path& path)
+    requires HostBackend<B> && std::is_same_v<C, channels::Full>;
+
+  /*
+   * Set the supersampling of the edges of the images of `compute_image`.
+   *
+   * The image is computed at its own resolution first. A pixel whose smooth
+   * iteration count differs by more than `threshold` from that of one of its
+   * eight neighbours, or that is inside the set while a neighbour isn't, lies
+   * on an edge. Only those pixels are supersampled: they are computed again at
+   * `factor * factor` positions within the pixel, and take the average of the
+   * colors at those positions. The samples at the same position within their
+   * pixels are computed together, so that the SIMD lanes are filled with
+   * samples of different pixels.
+   *
+   * The jittered positions are drawn once, and shared by every pixel.
+   *
+   * @param factor The number of samples along each axis of a pixel. A factor
+   * of 1 disables supersampling.
+   * @param pattern The placement of the samples.
+   * @param threshold The difference in smooth iteration counts above which
+   * neighbouring pixels lie on an edge.
+   */
+  void set_supersampling(unsigned int factor,
+                         SamplePattern pattern = SamplePattern::Grid,
+                         float threshold = 1.0f) noexcept {
+    m_supersampling = std::max(factor, 1u);
+    m_sample_pattern = pattern;
+    m_edge_threshold = threshold;
+  }
+
+  /*
+   * Restore every setting to its default, as in a new engine.
+   *
+   * The size, bounds, maximum iterations and buffers of the engine are kept,
+   * so that it can serve another request without allocating, see
+   * `EnginePool`. Resetting the thread placement may drop the results, see
+   * `set_thread_placement`.
+   */
+  void reset_settings() noexcept {
+    m_bailout_radius = 2.0;
+    m_boundary_threshold = 0.0f;
+    m_interior_detection = false;
+    m_render_mode = RenderMode::Full;
+    m_kernel_variant = KernelVariant::Block;
+    m_interleaving = {4, 8};
+    m_incremental = false;
+    m_supersampling = 1;
+    m_sample_pattern = SamplePattern::Grid;
+    m_edge_threshold = 1.0f;
+    m_tile_width = 64;
+    m_tile_height = 16;
+    m_rendered_bounds.reset();
+    m_resumable_bounds.reset();
+
+#if defined(MANDELBROT_HAS_OMP)
+    if constexpr (!std::is_same_v<Exec, exec::Default>) {
+      set_thread_placement(ThreadPlacement::None);
+    }
+#endif
+  }
+
+#if defined(MANDELBROT_HAS_OMP)
+  /*
+   * Set the size of the tiles that the image is split into.
+   *
+   * The work-stealing policy splits every image into tiles, while both parallel
+   * policies split the frames of `compute_batch` into them.
+   *
+   * The width is rounded up to a multiple of the number of SIMD lanes of the
+   * backend, so that tiles never split a vector.
+   *
+   * @param width The width of a tile in pixels.
+   * @param height The height of a tile in pixels.
+   */
+  void set_tile_size(std::size_t width, std::size_t height) noexcept
+    requires(!std::is_same_v<Exec, exec::Default>)
+  {
+    m_tile_width = std::max<std::size_t>(width, 1);
+    m_tile_height = std::max<std::size_t>(height, 1);
+  }
+
+  /*
+   * Set the placement of the threads on the CPUs and of the results in memory.
+   *
+   * Without a placement, the operating system moves the threads between CPUs,
+   * and places each page of the results on the NUMA node of the thread that
+   * first writes it. With the dynamic schedules of the parallel loops, that
+   * thread changes from run to run, so on a machine with several sockets,
+   * most threads write to the memory of another socket.
+   *
+   * With a placement, every thread is pinned to a CPU, and the results are
+   * first written by the threads that compute them, so that each page is
+   * placed on the node of the thread that computes it. The `OMP` execution
+   * policy then hands out the rows of the image in turn, rather than
+   * dynamically, so that the same thread computes a row every time. With the
+   * `WorkStealing` execution policy, a thread first computes the tiles whose
+   * memory it placed, and then steals from the threads on its own node before
+   * those on other nodes.
+   *
+   * The pages are placed when the results are allocated, so the placement
+   * should be set before the first computation. The threads are only pinned
+   * during the parallel regions of the engine, including the thread calling
+   * the engine, which takes part in them. Afterwards, every thread may run on
+   * the CPUs it could run on before, so other engines and the rest of the
+   * program aren't affected. The NUMA nodes are only known on Linux.
+   * Elsewhere, the threads aren't pinned.
+   *
+   * An engine with an arena takes blocks that the arena didn't fault in, see
+   * `BufferArena`. Setting or clearing the placement then drops the results,
+   * so that the next computation takes its blocks accordingly.
+   *
+   * @param placement The placement of the threads.
+   */
+  void set_thread_placement(ThreadPlacement placement) noexcept
+    requires(!std::is_same_v<Exec, exec::Default>)
+  {
+    const bool placed = m_thread_placement != ThreadPlacement::None;
+    m_thread_placement = placement;
+
+    if (m_arena && !m_host.mapping &&
+        placed != (placement != ThreadPlacement::None)) {
+      m_host = empty_host();
+      m_rendered_bounds.reset();
+      m_resumable_bounds.reset();
+    }
+  }
+
+  ThreadPlacement thread_placement() const noexcept
+    requires(!std::is_same_v<Exec, exec::Default>)
+  {
+    return m_thread_placement;
+  }
+#endif
+
   MandelbrotEngine(const MandelbrotEngine&) = delete;
   MandelbrotEngine& operator=(const MandelbrotEngine&) = delete;
 
@@ -48,13 +697,151 @@ public:
   std::size_t width() const noexcept { return m_width; }
   std::size_t height() const noexcept { return m_height; }
   const ViewBounds& bounds() const noexcept { return m_bounds; }
+  unsigned int max_iterations() const noexcept { return m_max_iterations; }
+  double bailout_radius() const noexcept { return m_bailout_radius; }
+  float boundary_threshold() const noexcept { return m_boundary_threshold; }
+  const std::shared_ptr<BufferArena>& arena() const noexcept { return m_arena; }
+  bool interior_detection() const noexcept { return m_interior_detection; }
+  RenderMode render_mode() const noexcept { return m_render_mode; }
+  KernelVariant kernel_variant() const noexcept { return m_kernel_variant; }
+  Interleaving interleaving() const noexcept { return m_interleaving; }
+  bool incremental() const noexcept { return m_incremental; }
+  unsigned int supersampling() const noexcept { return m_supersampling; }
+  SamplePattern sample_pattern() const noexcept { return m_sample_pattern; }
+  float edge_threshold() const noexcept { return m_edge_threshold; }
+
+  /*
+   * Get the number of pixels that were iterated during the last computation,
+   * as opposed to being filled in by subdivision or reused by incremental
+   * rendering. After resuming, it is the number of resumed pixels.
+   *
+   * @returns The number of iterated pixels.
+   */
+  std::size_t iterated_pixels() const noexcept { return m_iterated_pixels; }
+
+  /*
+   * Get the number of pixels that were supersampled during the last
+   * `compute_image`, see `set_supersampling`. Their samples are included in
+   * `iterated_pixels`.
+   *
+   * @returns The number of supersampled pixels.
+   */
+  std::size_t supersampled_pixels() const noexcept {
+    return m_supersampled_pixels;
+  }
+
+#if defined(MANDELBROT_HAS_OMP)
+  /*
+   * Get the statistics of each thread during the last computation.
+   *
+   * Comparing the busy and idle times of the threads shows how well the work
+   * was balanced.
+   *
+   * @returns The statistics per thread.
+   */
+  const std::vector<WorkerStats>& worker_stats() const noexcept
+    requires std::is_same_v<Exec, exec::WorkStealing>
+  {
+    return m_worker_stats;
+  }
+#endif
 
 private:
+  /*
+   * Check that the channels can hold a maximum number of iterations.
+   *
+   * @param max_iterations The maximum iterations.
+   *
+   * @throws std::invalid_argument If they can't.
+   */
+  static void check_max_iterations(unsigned int max_iterations) {
+    if (max_iterations > std::numeric_limits<typename C::Iteration>::max()) {
+      throw std::invalid_argument(
+          std::format("{} channels hold at most {} iterations.", C::name(),
+                      std::numeric_limits<typename C::Iteration>::max()));
+    }
+  }
+
+  /*
+   * Get the distance estimate below which pixels count as part of the set,
+   * see `set_boundary_threshold`.
+   *
+   * @param bounds The bounds of the computation.
+   *
+   * @returns The distance on the complex plane.
+   */
+  double boundary_distance(const ViewBounds& bounds) const noexcept {
+    if (m_width < 2) {
+      return 0.0;
+    }
+
+    return static_cast<double>(m_boundary_threshold) *
+           std::abs(bounds.real_max - bounds.real_min) /
+           static_cast<double>(m_width - 1);
+  }
+
+  /*
+   * Get the norm beyond which a pixel counts as escaped, see
+   * `set_bailout_radius`.
+   *
+   * @returns The square of the bailout radius.
+   */
+  double bailout_norm() const noexcept {
+    return m_bailout_radius * m_bailout_radius;
+  }
+
+  /*
+   * Create empty buffers for the results of the engine.
+   *
+   * With a thread placement, new blocks of the arena aren't faulted in, so
+   * that the threads computing the results place their pages.
+   *
+   * @returns The buffers.
+   */
+  HostResources<B, T, C> empty_host() const noexcept {
+    return HostResources<B, T, C>{m_width * m_height, m_arena,
+                                  m_thread_placement == ThreadPlacement::None};
+  }
+
   std::size_t m_width;
   std::size_t m_height;
   ViewBounds m_bounds;
   unsigned int m_max_iterations;
+  double m_bailout_radius{2.0};
+  float m_boundary_threshold{0.0f};
+  bool m_interior_detection{false};
+  RenderMode m_render_mode{RenderMode::Full};
+  KernelVariant m_kernel_variant{KernelVariant::Block};
+  Interleaving m_interleaving{4, 8};
+  bool m_incremental{false};
+  unsigned int m_supersampling{1};
+  SamplePattern m_sample_pattern{SamplePattern::Grid};
+  float m_edge_threshold{1.0f};
+  std::size_t m_iterated_pixels{0};
+  std::size_t m_supersampled_pixels{0};
+
+  // The bounds of the last computation, if its pixels can be reused.
+  std::optional<ViewBounds> m_rendered_bounds;
+
+  // The bounds of the last computation, if it can be resumed.
+  std::optional<ViewBounds> m_resumable_bounds;
+
+  std::size_t m_tile_width{64};
+  std::size_t m_tile_height{16};
+  ThreadPlacement m_thread_placement{ThreadPlacement::None};
+  std::vector<WorkerStats> m_worker_stats;
+
+  // The arena that the buffers are borrowed from, if any.
+  std::shared_ptr<BufferArena> m_arena;
+
+  HostResources<B, T, C> m_host;
+
+  // The buffers of the frames in flight during `compute_batch`.
+  std::vector<HostResources<B, T, C>> m_frames;
 
-  HostResources<B> m_host;
+  // The buffers of the results of `compute_async`, and the cancellation flag
+  // of the last asynchronous computation.
+  std::vector<std::shared_ptr<HostResources<B, T, C>>> m_async_buffers;
+  std::shared_ptr<std::atomic<bool>> m_async_cancelled;
   [[no_unique_address]] DeviceResources<B> m_device;
 };
@@ -1,23 +1,245 @@
 #pragma once
 
+#include <array>
 #include <complex>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
 
 #include "backends.hpp"
 #include "resources.hpp"
 
-struct EscapeResult {
+template <Scalar T = float> struct EscapeResult {
   unsigned int iteration;
-  std::complex<float> z;
+  std::complex<T> z;
 };
 
-template <Backend B> class MandelbrotResult {
+class AnyMandelbrotResult;
+class Colorizer;
+
+/*
+ * The element types of the channels of a result.
+ */
+enum class DType {
+  UInt16,
+  UInt32,
+  Float32,
+  Float64,
+};
+
+/*
+ * Get the element type of a channel with values of type `V`.
+ *
+ * @returns The element type.
+ */
+template <class V> constexpr DType dtypeOf() noexcept {
+  if constexpr (std::is_same_v<V, std::uint16_t>) {
+    return DType::UInt16;
+  } else if constexpr (std::is_same_v<V, std::uint32_t>) {
+    return DType::UInt32;
+  } else if constexpr (std::is_same_v<V, float>) {
+    return DType::Float32;
+  } else {
+    static_assert(std::is_same_v<V, double>, "Unsupported channel type.");
+    return DType::Float64;
+  }
+}
+
+/*
+ * A channel of a result as raw memory, so that other runtimes can wrap it
+ * without a copy, e.g. as a NumPy array through the buffer protocol or as a
+ * DLPack tensor.
+ */
+struct RawChannel {
+  const void* data;
+  DType dtype;
+  std::size_t element_size;
+
+  // The number of rows and columns.
+  std::array<std::size_t, 2> shape;
+
+  // The distances in bytes between consecutive rows and columns.
+  std::array<std::size_t, 2> strides;
+
+  // Keeps the buffer alive while it is wrapped, if the result owns it.
+  std::shared_ptr<const void> owner;
+};
+
+/*
+ * A view of a channel of an image, with rows `stride` values apart.
+ *
+ * It refers to the buffer of the result that it was taken from, and is only
+ * valid for as long as that buffer is.
+ */
+template <class V> class ChannelView {
 public:
+  ChannelView(const V* data, std::size_t width, std::size_t height,
+              std::size_t stride)
+      : m_data{data}, m_width{width}, m_height{height}, m_stride{stride} {};
+
+  const V& operator()(std::size_t row, std::size_t col) const noexcept {
+    return m_data[row * m_stride + col];
+  }
+
+  /*
+   * Get the values of a row.
+   *
+   * @param row The row.
+   *
+   * @returns The values.
+   */
+  std::span<const V> row(std::size_t row) const noexcept {
+    return {m_data + row * m_stride, m_width};
+  }
+
+  /*
+   * Get a view of a rectangle of the image.
+   *
+   * @param row The first row of the rectangle.
+   * @param col The first column of the rectangle.
+   * @param height The number of rows of the rectangle.
+   * @param width The number of columns of the rectangle.
+   *
+   * @returns The view, with the stride of this view.
+   */
+  ChannelView crop(std::size_t row, std::size_t col, std::size_t height,
+                   std::size_t width) const noexcept {
+    return {m_data + row * m_stride + col, width, height, m_stride};
+  }
+
+  /*
+   * Check whether the rows follow each other without gaps, so that the whole
+   * channel is a single span.
+   *
+   * @returns Whether the rows are contiguous.
+   */
+  bool contiguous() const noexcept {
+    return m_stride == m_width || m_height <= 1;
+  }
+
+  /*
+   * Get the values of all pixels of a contiguous view, row by row.
+   *
+   * @returns The values.
+   */
+  std::span<const V> values() const noexcept {
+    return {m_data, m_height == 0 ? 0 : (m_height - 1) * m_stride + m_width};
+  }
+
+#if defined(__cpp_lib_mdspan)
+  std::mdspan<const V, std::dextents<std::size_t, 2>, std::layout_stride>
+  mdspan() const noexcept {
+    return {m_data, std::layout_stride::mapping{
+                        std::dextents<std::size_t, 2>{m_height, m_width},
+                        std::array<std::size_t, 2>{m_stride, 1}}};
+  }
+#endif
+
+  /*
+   * Export the view as raw memory.
+   *
+   * @param owner The owner of the buffer to keep alive, see
+   * `MandelbrotResult::owner`.
+   *
+   * @returns The raw channel.
+   */
+  RawChannel raw(std::shared_ptr<const void> owner = nullptr) const noexcept {
+    return {m_data,
+            dtypeOf<V>(),
+            sizeof(V),
+            {m_height, m_width},
+            {m_stride * sizeof(V), sizeof(V)},
+            std::move(owner)};
+  }
+
+  const V* data() const noexcept { return m_data; }
+  std::size_t width() const noexcept { return m_width; }
+  std::size_t height() const noexcept { return m_height; }
+  std::size_t stride() const noexcept { return m_stride; }
+
+private:
+  const V* m_data;
+  std::size_t m_width;
+  std::size_t m_height;
+  std::size_t m_stride;
+};
+
+/*
+ * A band of consecutive rows of an image that is computed in bands, see
+ * `MandelbrotEngine::compute_bands`.
+ *
+ * It refers to buffers that the engine reuses for later bands, so it is only
+ * valid during the call it is passed to.
+ */
+template <Scalar T = float> class MandelbrotBand {
+public:
+  MandelbrotBand(std::size_t first_row, std::size_t width, std::size_t height,
+                 const unsigned int* iterations, const T* z_reals,
+                 const T* z_imags)
+      : m_first_row{first_row}, m_width{width}, m_height{height},
+        m_iterations{iterations}, m_z_reals{z_reals}, m_z_imags{z_imags} {};
+
+  /*
+   * Get the escape information for the pixel at row `row` of the band and
+   * column `col`.
+   *
+   * @param row The row of the pixel, relative to the first row of the band.
+   * @param col The column of the pixel.
+   *
+   * @returns The escape information.
+   */
+  EscapeResult<T> operator()(std::size_t row, std::size_t col) const noexcept {
+    std::size_t idx = row * m_width + col;
+
+    return {m_iterations[idx], std::complex<T>{m_z_reals[idx], m_z_imags[idx]}};
+  }
+
+  // The row of the image that the band starts at.
+  std::size_t first_row() const noexcept { return m_first_row; }
+  std::size_t width() const noexcept { return m_width; }
+  std::size_t height() const noexcept { return m_height; }
+
+private:
+  std::size_t m_first_row;
+  std::size_t m_width;
+  std::size_t m_height;
+
+  const unsigned int* m_iterations;
+  const T* m_z_reals;
+  const T* m_z_imags;
+};
+
+/*
+ * The result of a computation, referring to the buffers of the engine that
+ * produced it. A result of `MandelbrotEngine::compute_async` or
+ * `MandelbrotEngine::take_result` shares ownership of its buffers instead, and
+ * keeps them alive until it is destroyed.
+ *
+ * Only the channels `C` that the engine stored can be accessed, pixel by pixel
+ * or as views of whole channels.
+ */
+template <Backend B, Scalar T = float, Channels C = channels::Full>
+class MandelbrotResult {
+public:
+  // An empty result, of no pixels, to assign another result to.
   MandelbrotResult() = default;
 
-  MandelbrotResult(const HostResources<B>& resources, std::size_t width,
+  MandelbrotResult(const HostResources<B, T, C>& resources, std::size_t width,
                    std::size_t height)
-      : m_resources(resources), m_width(width), m_height(height) {};
+      : m_width(width), m_height(height), m_resources(&resources) {};
+
+  MandelbrotResult(std::shared_ptr<const HostResources<B, T, C>> resources,
+                   std::size_t width, std::size_t height)
+      : m_width(width), m_height(height), m_resources(resources.get()),
+        m_owner(std::move(resources)) {};
 
   /*
    * Get the escape information for the pixel at row `row` and column `col`.
@@ -27,17 +249,194 @@ public:
    *
    * @returns The escape information.
    */
-  EscapeResult operator()(std::size_t row, std::size_t col) const noexcept {
+  EscapeResult<T> operator()(std::size_t row, std::size_t col) const noexcept
+    requires(C::iterations && C::z)
+  {
     std::size_t idx = row * m_width + col;
 
-    return {m_resources.iterations[idx],
-            std::complex<float>{m_resources.z_reals[idx],
-                                m_resources.z_imags[idx]}};
+    return {m_resources->iterations[idx],
+            std::complex<T>{m_resources->z_reals[idx],
+                            m_resources->z_imags[idx]}};
   }
 
+  /*
+   * Get the iteration count of the pixel at row `row` and column `col`.
+   *
+   * @param row The row of the pixel.
+   * @param col The column of the pixel.
+   *
+   * @returns The iteration count.
+   */
+  typename C::Iteration iteration(std::size_t row,
+                                  std::size_t col) const noexcept
+    requires(C::iterations)
+  {
+    return m_resources->iterations[row * m_width + col];
+  }
+
+  /*
+   * Get the smooth iteration count of the pixel at row `row` and column `col`.
+   *
+   * @param row The row of the pixel.
+   * @param col The column of the pixel.
+   *
+   * @returns The smooth iteration count.
+   */
+  float smooth(std::size_t row, std::size_t col) const noexcept
+    requires(C::smooth)
+  {
+    return m_resources->smooth[row * m_width + col];
+  }
+
+  /*
+   * Get the estimated distance to the set of the pixel at row `row` and column
+   * `col`.
+   *
+   * @param row The row of the pixel.
+   * @param col The column of the pixel.
+   *
+   * @returns The distance in units of the complex plane, or 0 if the pixel is
+   * part of the set.
+   */
+  float distance(std::size_t row, std::size_t col) const noexcept
+    requires(C::distance)
+  {
+    return m_resources->distance[row * m_width + col];
+  }
+
+  ChannelView<typename C::Iteration> iterations() const noexcept
+    requires(C::iterations)
+  {
+    return view(&HostResources<B, T, C>::iterations);
+  }
+
+  ChannelView<T> z_reals() const noexcept
+    requires(C::z)
+  {
+    return view(&HostResources<B, T, C>::z_reals);
+  }
+
+  ChannelView<T> z_imags() const noexcept
+    requires(C::z)
+  {
+    return view(&HostResources<B, T, C>::z_imags);
+  }
+
+  ChannelView<float> smooth() const noexcept
+    requires(C::smooth)
+  {
+    return view(&HostResources<B, T, C>::smooth);
+  }
+
+  ChannelView<float> distance() const noexcept
+    requires(C::distance)
+  {
+    return view(&HostResources<B, T, C>::distance);
+  }
+
+  /*
+   * Get the owner of the buffers, to keep them alive past the result, e.g.
+   * while another runtime wraps a `RawChannel`.
+   *
+   * @returns The owner, or null if the result refers to the buffers of the
+   * engine.
+   */
+  std::shared_ptr<const void> owner() const noexcept { return m_owner; }
+
+  std::size_t width() const noexcept { return m_width; }
+  std::size_t height() const noexcept { return m_height; }
+
+private:
+  friend class AnyMandelbrotResult;
+  friend class Colorizer;
+
+  /*
+   * Get a view of a channel, which is empty for an empty result.
+   *
+   * @param buffer The buffer of the channel.
+   *
+   * @returns The view.
+   */
+  template <class V>
+  ChannelView<V> view(const MappedVector<V, B::alignment>
+                          HostResources<B, T, C>::*buffer) const noexcept {
+    return {m_resources ? (m_resources->*buffer).data() : nullptr, m_width,
+            m_height, m_width};
+  }
+
+  std::size_t m_width{0};
+  std::size_t m_height{0};
+
+  const HostResources<B, T, C>* m_resources{nullptr};
+
+  // The owner of the buffers, if the result keeps them alive.
+  std::shared_ptr<const HostResources<B, T, C>> m_owner;
+};
+
+/*
+ * A backend-independent view of the result of an `AnyMandelbrotEngine`.
+ *
+ * Type-erased engines compute in single precision.
+ *
+ * Like `MandelbrotResult`, it refers to the buffers of the engine that produced
+ * it and is only valid for as long as that engine is alive, unless the result
+ * it was made from owns its buffers.
+ */
+class AnyMandelbrotResult {
+public:
+  template <Backend B>
+  AnyMandelbrotResult(const MandelbrotResult<B>& result)
+      : m_width(result.m_width), m_height(result.m_height),
+        m_iterations(result.m_resources
+                         ? result.m_resources->iterations.data()
+                         : nullptr),
+        m_z_reals(result.m_resources ? result.m_resources->z_reals.data()
+                                     : nullptr),
+        m_z_imags(result.m_resources ? result.m_resources->z_imags.data()
+                                     : nullptr),
+        m_owner(result.m_owner) {};
+
+  /*
+   * Get the escape information for the pixel at row `row` and column `col`.
+   *
+   * @param row The row of the pixel.
+   * @param col The column of the pixel.
+   *
+   * @returns The escape information.
+   */
+  EscapeResult<> operator()(std::size_t row, std::size_t col) const noexcept {
+    std::size_t idx = row * m_width + col;
+
+    return {m_iterations[idx],
+            std::complex<float>{m_z_reals[idx], m_z_imags[idx]}};
+  }
+
+  ChannelView<unsigned int> iterations() const noexcept {
+    return {m_iterations, m_width, m_height, m_width};
+  }
+
+  ChannelView<float> z_reals() const noexcept {
+    return {m_z_reals, m_width, m_height, m_width};
+  }
+
+  ChannelView<float> z_imags() const noexcept {
+    return {m_z_imags, m_width, m_height, m_width};
+  }
+
+  // The owner of the buffers, see `MandelbrotResult::owner`.
+  std::shared_ptr<const void> owner() const noexcept { return m_owner; }
+
+  std::size_t width() const noexcept { return m_width; }
+  std::size_t height() const noexcept { return m_height; }
+
 private:
   std::size_t m_width;
   std::size_t m_height;
 
-  const HostResources<B>& m_resources;
+  const unsigned int* m_iterations;
+  const float* m_z_reals;
+  const float* m_z_imags;
+
+  // The owner of the buffers, if the result keeps them alive.
+  std::shared_ptr<const void> m_owner;
 };
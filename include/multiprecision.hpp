@@ -0,0 +1,89 @@
+/*
+ * This file contains a minimal multiprecision number type.
+ *
+ * It supports exactly what is needed to compute a reference orbit at a deep
+ * zoom: parsing a decimal coordinate, addition, subtraction, multiplication and
+ * conversion to and from double.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace multiprecision {
+/*
+ * A signed fixed-point number with a configurable number of fractional bits.
+ *
+ * The magnitude is stored in 32-bit limbs, least significant first. All limbs
+ * but the last hold the fraction, the last one holds the integer part. Values
+ * that occur while iterating the Mandelbrot set stay well within that range.
+ *
+ * Operands of an arithmetic operation must have the same number of limbs.
+ */
+class FixedPoint {
+public:
+  /*
+   * Create a zero-valued number.
+   *
+   * @param fraction_limbs The number of 32-bit limbs of the fraction.
+   */
+  explicit FixedPoint(std::size_t fraction_limbs);
+
+  /*
+   * Create a number from a double.
+   *
+   * The conversion is exact if the number has enough fractional bits.
+   *
+   * @param value The value, with a magnitude below 2^32.
+   * @param fraction_limbs The number of 32-bit limbs of the fraction.
+   */
+  FixedPoint(double value, std::size_t fraction_limbs);
+
+  /*
+   * Parse a decimal number such as "-0.7436438870371587047521915".
+   *
+   * @param decimal The number, consisting of an optional sign, the integer
+   * part, and an optional fraction.
+   * @param fraction_limbs The number of 32-bit limbs of the fraction.
+   *
+   * @returns The number, truncated to the fractional bits.
+   *
+   * @throws std::invalid_argument If the string is not a valid decimal number
+   * or its integer part does not fit.
+   */
+  static FixedPoint parse(std::string_view decimal,
+                          std::size_t fraction_limbs);
+
+  /*
+   * Get the number of fraction limbs needed for a number of fractional bits.
+   *
+   * @param bits The number of fractional bits.
+   *
+   * @returns The number of limbs.
+   */
+  static std::size_t limbs_for_bits(std::size_t bits) noexcept {
+    return (bits + 31) / 32;
+  }
+
+  /*
+   * Convert the number to the closest double.
+   *
+   * @returns The converted number.
+   */
+  double to_double() const noexcept;
+
+  FixedPoint operator-() const;
+  FixedPoint operator+(const FixedPoint& other) const;
+  FixedPoint operator-(const FixedPoint& other) const;
+  FixedPoint operator*(const FixedPoint& other) const;
+
+  std::size_t fraction_limbs() const noexcept { return m_limbs.size() - 1; }
+
+private:
+  std::vector<std::uint32_t> m_limbs;
+  bool m_negative{false};
+};
+} // namespace multiprecision
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "backends.hpp"
+#include "mandelbrot_result.hpp"
+#include "multiprecision.hpp"
+#include "resources.hpp"
+
+// The backends that can compute a perturbed image.
+template <typename B>
+concept PerturbationBackend = HostBackend<B>;
+
+/*
+ * Computes deep zooms of the Mandelbrot set using perturbation theory, on a
+ * backend `B`, using execution policy `Exec` and scalar type `T`.
+ *
+ * The orbit of the center of the view is computed once in multiprecision.
+ * Every pixel then only iterates its difference to that reference orbit. The
+ * differences are tiny but, unlike the coordinates themselves, can be
+ * represented in `T`, so the pixels are iterated by the regular SIMD kernels.
+ * The zoom depth is limited by the exponent range of `T` rather than its
+ * precision: about 1e-30 for `float` and 1e-300 for `double`.
+ *
+ * Where the difference of a pixel grows larger than its orbit, the difference
+ * would lose the precision needed to follow it, which shows up as glitches. The
+ * pixel is then rebased: its orbit continues as a difference to the start of
+ * the reference orbit, so that no secondary reference orbits are needed.
+ *
+ * Ahead of iterating the pixels, the early iterations that all pixels share
+ * are replaced by a series approximation, see `set_series_terms`.
+ */
+template <Backend B = backend::Serial, Execution Exec = exec::Default,
+          Scalar T = double>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> && PerturbationBackend<B>
+class PerturbationEngine {
+public:
+  /*
+   * Create a perturbation engine.
+   *
+   * @param width The width of the image.
+   * @param height The height of the image.
+   * @param center_real The real part of the center of the view, in decimal.
+   * @param center_imag The imaginary part of the center of the view, in
+   * decimal.
+   * @param radius Half the width of the view on the real axis.
+   * @param max_iterations The maximum iterations for each pixel.
+   *
+   * @throws std::invalid_argument If the center is not a decimal number.
+   */
+  PerturbationEngine(std::size_t width, std::size_t height,
+                     std::string_view center_real, std::string_view center_imag,
+                     double radius, unsigned int max_iterations)
+      : m_width{width}, m_height{height}, m_radius{radius},
+        m_max_iterations{max_iterations}, m_host{width * height} {
+    if (!B::is_available()) {
+      throw std::runtime_error(
+          std::format("{} backend is not available.", B::name()));
+    }
+
+    set_center(center_real, center_imag);
+  };
+
+  MandelbrotResult<B, T> compute();
+
+  /*
+   * Set the center of the view.
+   *
+   * The coordinates are kept as given and only parsed to the precision that
+   * the radius requires when computing.
+   *
+   * @param real The real part of the center, in decimal.
+   * @param imag The imaginary part of the center, in decimal.
+   *
+   * @throws std::invalid_argument If the center is not a decimal number.
+   */
+  void set_center(std::string_view real, std::string_view imag) {
+    // Validate both before changing anything.
+    multiprecision::FixedPoint::parse(real, 1);
+    multiprecision::FixedPoint::parse(imag, 1);
+
+    m_center_real = real;
+    m_center_imag = imag;
+  }
+
+  void set_radius(double radius) noexcept { m_radius = radius; }
+
+  /*
+   * Set the number of terms of the series approximation.
+   *
+   * During the early iterations of a deep zoom, the difference of each pixel
+   * to the reference orbit is approximated by a power series in its offset to
+   * the center, whose coefficients are iterated once along with the reference
+   * orbit. Every pixel then starts at the last iteration for which the series
+   * is still accurate, with its difference initialized from the series. The
+   * number of skipped iterations is detected automatically by comparing the
+   * series against probe points on the edges of the view.
+   *
+   * More terms keep the series accurate for longer, at a cost that is
+   * negligible compared to iterating the pixels.
+   *
+   * @param terms The number of terms. Zero disables the approximation.
+   */
+  void set_series_terms(std::size_t terms) noexcept { m_series_terms = terms; }
+
+  /*
+   * Set the radius beyond which a pixel counts as escaped, as for
+   * `MandelbrotEngine::set_bailout_radius`.
+   *
+   * The reference orbit is computed with an integer part of 32 bits, which
+   * bounds the radius more tightly than for the direct engines.
+   *
+   * @param radius The bailout radius.
+   *
+   * @throws std::invalid_argument If the radius is below 2 or above 1e4.
+   */
+  void set_bailout_radius(double radius) {
+    if (!(radius >= 2.0 && radius <= 1e4)) {
+      throw std::invalid_argument(
+          std::format("The bailout radius {} is not within [2, 1e4].", radius));
+    }
+
+    m_bailout_radius = radius;
+  }
+
+  PerturbationEngine(const PerturbationEngine&) = delete;
+  PerturbationEngine& operator=(const PerturbationEngine&) = delete;
+
+  PerturbationEngine(PerturbationEngine&&) = default;
+  PerturbationEngine& operator=(PerturbationEngine&&) = default;
+
+  std::size_t width() const noexcept { return m_width; }
+  std::size_t height() const noexcept { return m_height; }
+  const std::string& center_real() const noexcept { return m_center_real; }
+  const std::string& center_imag() const noexcept { return m_center_imag; }
+  double radius() const noexcept { return m_radius; }
+  double bailout_radius() const noexcept { return m_bailout_radius; }
+
+  /*
+   * Get the length of the reference orbit of the last computation, including
+   * its starting point. It is shorter than the maximum iterations plus one if
+   * the center of the view escapes.
+   *
+   * @returns The length of the reference orbit.
+   */
+  std::size_t reference_length() const noexcept { return m_orbit_reals.size(); }
+
+  std::size_t series_terms() const noexcept { return m_series_terms; }
+
+  /*
+   * Get the number of iterations that every pixel skipped during the last
+   * computation thanks to the series approximation.
+   *
+   * @returns The number of skipped iterations per pixel.
+   */
+  unsigned int skipped_iterations() const noexcept {
+    return m_skipped_iterations;
+  }
+
+private:
+  /*
+   * Get the norm beyond which a pixel counts as escaped.
+   *
+   * @returns The square of the bailout radius.
+   */
+  double bailout_norm() const noexcept {
+    return m_bailout_radius * m_bailout_radius;
+  }
+
+  std::size_t m_width;
+  std::size_t m_height;
+  std::string m_center_real;
+  std::string m_center_imag;
+  double m_radius;
+  unsigned int m_max_iterations;
+  double m_bailout_radius{2.0};
+  std::size_t m_series_terms{16};
+  unsigned int m_skipped_iterations{0};
+
+  AlignedVector<T, B::alignment> m_orbit_reals;
+  AlignedVector<T, B::alignment> m_orbit_imags;
+  std::vector<T> m_series_reals;
+  std::vector<T> m_series_imags;
+
+  HostResources<B, T> m_host;
+};
@@ -1,20 +1,275 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "backends.hpp"
+#include "buffer_arena.hpp"
+#include "result_file.hpp"
 #include "utility.hpp"
 
 using utility::AlignedVector;
 
-template <Backend B> struct HostResources {
-  explicit HostResources(std::size_t n) : iterations{}, z_reals{}, z_imags{} {
-    iterations.reserve(n);
-    z_reals.reserve(n);
-    z_imags.reserve(n);
+/*
+ * An allocator that hands out a region of memory that it was given, such as a
+ * memory-mapped file. Without a region, it borrows blocks from an arena if it
+ * was given one, and otherwise allocates like `AlignedAllocator`.
+ *
+ * The region backs a single allocation, and isn't freed by the allocator.
+ */
+template <typename T, std::size_t Alignment> struct MappedAllocator {
+  using value_type = T;
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  // Moving or swapping a container moves its region along.
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  MappedAllocator() noexcept = default;
+
+  /*
+   * Create an allocator handing out a region.
+   *
+   * @param region The start of the region, aligned to `Alignment`.
+   * @param size The size of the region in bytes.
+   */
+  MappedAllocator(void* region, std::size_t size) noexcept
+      : region{region}, size{size} {};
+
+  /*
+   * Create an allocator borrowing from an arena.
+   *
+   * @param arena The arena, or null to allocate like `AlignedAllocator`.
+   * @param populate Whether new blocks of the arena are faulted in, see
+   * `BufferArena::allocate`.
+   */
+  explicit MappedAllocator(std::shared_ptr<BufferArena> arena,
+                           bool populate = true) noexcept
+      : arena{std::move(arena)}, populate{populate} {};
+
+  template <typename U>
+  MappedAllocator(const MappedAllocator<U, Alignment>& other) noexcept
+      : region{other.region}, size{other.size}, arena{other.arena},
+        populate{other.populate} {};
+
+  bool operator==(const MappedAllocator& other) const noexcept {
+    return region == other.region && arena == other.arena &&
+           populate == other.populate;
+  }
+  bool operator!=(const MappedAllocator& other) const noexcept {
+    return !(*this == other);
+  }
+
+  [[nodiscard]] value_type* allocate(std::size_t n) {
+    if (region == nullptr && arena) {
+      return static_cast<value_type*>(
+          arena->allocate(n * sizeof(T), populate));
+    }
+
+    if (region == nullptr) {
+      return utility::AlignedAllocator<T, Alignment>{}.allocate(n);
+    }
+
+    if (n * sizeof(T) > size) {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<value_type*>(region);
   };
 
-  AlignedVector<unsigned int, B::alignment> iterations;
-  AlignedVector<float, B::alignment> z_reals;
-  AlignedVector<float, B::alignment> z_imags;
+  void deallocate(value_type* p, std::size_t n) noexcept {
+    if (region == nullptr && arena) {
+      arena->deallocate(p, n * sizeof(T), populate);
+    } else if (region == nullptr) {
+      utility::AlignedAllocator<T, Alignment>{}.deallocate(p, n);
+    }
+  }
+
+  /*
+   * Default-initialise the elements of a container rather than
+   * value-initialise them, so that resizing a buffer doesn't write it. The
+   * pages of a new buffer are then only placed in memory by the threads that
+   * first write them, and a mapped file keeps its contents.
+   *
+   * @param p The element.
+   */
+  template <typename U> void construct(U* p) {
+    ::new (static_cast<void*>(p)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    std::construct_at(p, std::forward<Args>(args)...);
+  }
+
+  template <typename U> struct rebind {
+    using other = MappedAllocator<U, Alignment>;
+  };
+
+  void* region{nullptr};
+  std::size_t size{0};
+
+  // Shared, so that the arena outlives the allocations.
+  std::shared_ptr<BufferArena> arena;
+  bool populate{true};
+};
+
+template <typename T, std::size_t Alignment>
+using MappedVector = std::vector<T, MappedAllocator<T, Alignment>>;
+
+/*
+ * The buffers of the channels `C` of an image on the host. The buffers of the
+ * other channels stay empty.
+ */
+template <Backend B, Scalar T = float, Channels C = channels::Full>
+struct HostResources {
+  using Iteration = typename C::Iteration;
+
+  /*
+   * Create the resources for `n` pixels.
+   *
+   * The buffers are only allocated by `allocate`, so that an engine that never
+   * holds a full image, such as one computing in bands, doesn't allocate one.
+   *
+   * @param n The number of pixels.
+   * @param arena The arena to borrow the buffers from, if any.
+   * @param populate Whether new blocks of the arena are faulted in when they
+   * are mapped, rather than by the threads that first write them.
+   */
+  explicit HostResources(std::size_t n,
+                         const std::shared_ptr<BufferArena>& arena = nullptr,
+                         bool populate = true)
+      : pixels{n},
+        iterations{MappedAllocator<Iteration, B::alignment>{arena, populate}},
+        z_reals{MappedAllocator<T, B::alignment>{arena, populate}},
+        z_imags{MappedAllocator<T, B::alignment>{arena, populate}},
+        smooth{MappedAllocator<float, B::alignment>{arena, populate}},
+        distance{MappedAllocator<float, B::alignment>{arena, populate}} {};
+
+  /*
+   * Change the number of pixels.
+   *
+   * The buffers keep their memory, and `allocate` only reallocates the buffers
+   * that are too small for the new number of pixels.
+   *
+   * @param n The number of pixels.
+   */
+  void resize(std::size_t n) noexcept { pixels = n; }
+
+  /*
+   * Store the buffers in a mapped result file rather than in memory.
+   *
+   * @param file The mapping of a file created for as many pixels.
+   */
+  void map(result_file::Mapping file)
+    requires std::is_same_v<C, channels::Full>
+  {
+    const result_file::Header& header = file.header();
+    std::byte* data = file.data();
+
+    iterations = MappedVector<unsigned int, B::alignment>(
+        MappedAllocator<unsigned int, B::alignment>{
+            data + header.iterations_offset, pixels * sizeof(unsigned int)});
+    z_reals = MappedVector<T, B::alignment>(MappedAllocator<T, B::alignment>{
+        data + header.z_reals_offset, pixels * sizeof(T)});
+    z_imags = MappedVector<T, B::alignment>(MappedAllocator<T, B::alignment>{
+        data + header.z_imags_offset, pixels * sizeof(T)});
+
+    mapping = std::move(file);
+    allocate();
+  }
+
+  /*
+   * Allocate the buffers, unless they already are, and size them to the number
+   * of pixels.
+   *
+   * The values of the pixels are left uninitialised, so that the buffers
+   * aren't written. The pages of a new buffer are only placed in memory once
+   * they are first written, by the threads computing the results.
+   *
+   * @returns Whether any buffer was allocated.
+   */
+  bool allocate() {
+    bool allocated{false};
+
+    const auto fit = [&](auto& buffer) {
+      if (buffer.capacity() < pixels) {
+        // Drop the old values, so that reallocating doesn't copy them.
+        buffer.clear();
+        allocated = true;
+      }
+
+      buffer.resize(pixels);
+    };
+
+    if constexpr (C::iterations) {
+      fit(iterations);
+    }
+
+    if constexpr (C::z) {
+      fit(z_reals);
+      fit(z_imags);
+    }
+
+    if constexpr (C::smooth) {
+      fit(smooth);
+    }
+
+    if constexpr (C::distance) {
+      fit(distance);
+    }
+
+    return allocated;
+  }
+
+  /*
+   * Check whether the buffers are allocated for the number of pixels.
+   *
+   * @returns Whether they are.
+   */
+  bool allocated() const noexcept {
+    bool allocated{true};
+
+    const auto check = [&](const auto& buffer) {
+      allocated = allocated && buffer.size() == pixels;
+    };
+
+    if constexpr (C::iterations) {
+      check(iterations);
+    }
+
+    if constexpr (C::z) {
+      check(z_reals);
+      check(z_imags);
+    }
+
+    if constexpr (C::smooth) {
+      check(smooth);
+    }
+
+    if constexpr (C::distance) {
+      check(distance);
+    }
+
+    return allocated;
+  }
+
+  std::size_t pixels;
+
+  // The result file that the buffers are stored in, if any.
+  std::optional<result_file::Mapping> mapping;
+
+  MappedVector<Iteration, B::alignment> iterations;
+  MappedVector<T, B::alignment> z_reals;
+  MappedVector<T, B::alignment> z_imags;
+  MappedVector<float, B::alignment> smooth;
+  MappedVector<float, B::alignment> distance;
 };
 
 template <Backend B> struct DeviceResources {
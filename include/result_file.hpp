@@ -0,0 +1,165 @@
+/*
+ * This file contains the declarations for result files.
+ *
+ * A result file holds the result of a computation in a form that can be
+ * mapped into memory as is, so that neither writing nor reading it involves a
+ * copy or a parse step. It starts with a `Header`, followed by the iteration
+ * counts and the real and imaginary parts of the z-values as three separate
+ * arrays, in the same layout as `HostResources`. All values are stored in the
+ * byte order of the machine that wrote the file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "backends.hpp"
+
+namespace result_file {
+// The bytes that every result file starts with.
+constexpr std::array<char, 8> magic{'M', 'A', 'N', 'D', 'E', 'L', 'B', 'R'};
+
+// The version of the layout, which changes whenever the layout does.
+constexpr std::uint32_t version = 1;
+
+// The alignment of the arrays in the file. Aligning them to pages keeps them
+// aligned for every backend, and lets the arrays be advised separately.
+constexpr std::size_t alignment = 4096;
+
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+
+  // The size of a z-value component in bytes, 4 for `float` and 8 for
+  // `double`.
+  std::uint32_t scalar_size;
+
+  std::uint64_t width;
+  std::uint64_t height;
+
+  // The bounds and maximum iterations of the last computation.
+  double real_min, real_max;
+  double imag_min, imag_max;
+  std::uint32_t max_iterations;
+
+  // The alignment of the arrays, in bytes.
+  std::uint32_t alignment;
+
+  // The offsets of the arrays from the start of the file, in bytes.
+  std::uint64_t iterations_offset;
+  std::uint64_t z_reals_offset;
+  std::uint64_t z_imags_offset;
+
+  // The size of the file, in bytes.
+  std::uint64_t size;
+};
+
+/*
+ * Create the header of a file for an image.
+ *
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param scalar_size The size of a z-value component in bytes.
+ *
+ * @returns The header, without bounds and maximum iterations.
+ */
+Header makeHeader(std::size_t width, std::size_t height,
+                  std::size_t scalar_size);
+
+/*
+ * A result file mapped into memory.
+ *
+ * The mapping is shared with the file, so that writes to it end up in the
+ * file, and can be paged out to it by the operating system.
+ */
+class Mapping {
+public:
+  /*
+   * Create a file for an image and map it for writing. An existing file is
+   * overwritten.
+   *
+   * The file is created sparse, so that disk space is only used for the pages
+   * that are written.
+   *
+   * @param path The path of the file.
+   * @param header The header of the file, see `makeHeader`.
+   *
+   * @returns The mapping.
+   *
+   * @throws std::system_error If the file can't be created or mapped.
+   */
+  static Mapping create(const std::filesystem::path& path,
+                        const Header& header);
+
+  /*
+   * Map an existing file for reading.
+   *
+   * @param path The path of the file.
+   *
+   * @returns The mapping.
+   *
+   * @throws std::system_error If the file can't be opened or mapped.
+   * @throws std::runtime_error If the file is not a result file of this
+   * version.
+   */
+  static Mapping open(const std::filesystem::path& path);
+
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+
+  Mapping(Mapping&& other) noexcept;
+  Mapping& operator=(Mapping&& other) noexcept;
+
+  ~Mapping();
+
+  /*
+   * Advise the operating system that the arrays are about to be written from
+   * front to back, so that written pages can be flushed and evicted early.
+   */
+  void advise_sequential() const noexcept;
+
+  const Header& header() const noexcept {
+    return *reinterpret_cast<const Header*>(m_data);
+  }
+  Header& header() noexcept { return *reinterpret_cast<Header*>(m_data); }
+
+  std::byte* data() const noexcept { return m_data; }
+
+  const unsigned int* iterations() const noexcept {
+    return reinterpret_cast<const unsigned int*>(m_data +
+                                                 header().iterations_offset);
+  }
+
+  /*
+   * Get the real parts of the z-values.
+   *
+   * @tparam T The scalar type, which must match the scalar size in the header.
+   *
+   * @returns The real parts.
+   */
+  template <Scalar T> const T* z_reals() const noexcept {
+    return reinterpret_cast<const T*>(m_data + header().z_reals_offset);
+  }
+
+  /*
+   * Get the imaginary parts of the z-values.
+   *
+   * @tparam T The scalar type, which must match the scalar size in the header.
+   *
+   * @returns The imaginary parts.
+   */
+  template <Scalar T> const T* z_imags() const noexcept {
+    return reinterpret_cast<const T*>(m_data + header().z_imags_offset);
+  }
+
+private:
+  Mapping(std::byte* data, std::size_t size) noexcept
+      : m_data{data}, m_size{size} {};
+
+  std::byte* m_data{nullptr};
+  std::size_t m_size{0};
+};
+} // namespace result_file
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mandelbrot_engine.hpp"
+#include "mandelbrot_result.hpp"
+
+/*
+ * Identifies a tile of a `TileCache`.
+ *
+ * At zoom level `zoom`, the view is divided into 2^zoom by 2^zoom tiles, with
+ * tile (0, 0) in the top-left corner.
+ */
+struct TileKey {
+  unsigned int zoom;
+  std::uint64_t x;
+  std::uint64_t y;
+  unsigned int max_iterations;
+
+  // The name of the backend that computes the tile, e.g. "AVX2".
+  std::string backend;
+
+  bool operator==(const TileKey&) const = default;
+};
+
+template <> struct std::hash<TileKey> {
+  std::size_t operator()(const TileKey& key) const noexcept {
+    std::size_t seed = std::hash<std::string>{}(key.backend);
+
+    for (const std::uint64_t value :
+         {std::uint64_t{key.zoom}, key.x, key.y,
+          std::uint64_t{key.max_iterations}}) {
+      seed ^= std::hash<std::uint64_t>{}(value) + 0x9e3779b97f4a7c15 +
+              (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+  }
+};
+
+/*
+ * A computed tile. Tiles are immutable and shared between the cache and
+ * everyone who requested them.
+ */
+class Tile {
+public:
+  explicit Tile(std::size_t size)
+      : m_size{size}, m_iterations(size * size), m_z_reals(size * size),
+        m_z_imags(size * size) {};
+
+  /*
+   * Get the escape information for the pixel at row `row` and column `col`.
+   *
+   * @param row The row of the pixel.
+   * @param col The column of the pixel.
+   *
+   * @returns The escape information.
+   */
+  EscapeResult<> operator()(std::size_t row, std::size_t col) const noexcept {
+    std::size_t idx = row * m_size + col;
+
+    return {m_iterations[idx],
+            std::complex<float>{m_z_reals[idx], m_z_imags[idx]}};
+  }
+
+  // The width and height of the tile.
+  std::size_t size() const noexcept { return m_size; }
+
+  // The memory taken by the tile, in bytes.
+  std::size_t bytes() const noexcept {
+    return m_iterations.size() * sizeof(unsigned int) +
+           2 * m_z_reals.size() * sizeof(float);
+  }
+
+  const unsigned int* iterations() const noexcept {
+    return m_iterations.data();
+  }
+  const float* z_reals() const noexcept { return m_z_reals.data(); }
+  const float* z_imags() const noexcept { return m_z_imags.data(); }
+
+private:
+  friend class TileCache;
+
+  std::size_t m_size;
+
+  std::vector<unsigned int> m_iterations;
+  std::vector<float> m_z_reals;
+  std::vector<float> m_z_imags;
+};
+
+struct TileCacheStats {
+  // Requests served from the cache, including the compressed tiles.
+  std::size_t hits;
+
+  // Requests that computed their tile.
+  std::size_t misses;
+
+  // Requests that waited for a computation of the same tile by another request.
+  std::size_t coalesced;
+
+  // Tiles that were dropped from the cache to stay within its capacity.
+  std::size_t evictions;
+
+  // The memory taken by the tiles in the cache, in bytes.
+  std::size_t bytes;
+  std::size_t compressed_bytes;
+};
+
+/*
+ * A cache of tiles of the Mandelbrot set, for viewers that show the set as a
+ * pyramid of tiles at increasing zoom levels.
+ *
+ * Tiles are computed on the backend given by their key and kept in memory up to
+ * a capacity, evicting the least recently used tiles first. Tiles are returned
+ * as shared pointers, so that hits don't copy them, and tiles that are evicted
+ * stay valid for as long as they are referenced.
+ *
+ * The cache can be used from many threads at once. Tiles are computed outside
+ * of the lock, so that different tiles are computed in parallel, while
+ * concurrent requests for the same tile wait for a single computation.
+ *
+ * Since the tiles are computed in single precision, zoom levels deeper than
+ * about 16 show the limits of `float`.
+ */
+class TileCache {
+public:
+  /*
+   * Create a tile cache.
+   *
+   * @param capacity The memory that the tiles may take, in bytes.
+   * @param tile_size The width and height of the tiles.
+   * @param world The bounds of the complex plane covered by zoom level 0.
+   */
+  explicit TileCache(std::size_t capacity, std::size_t tile_size = 256,
+                     const ViewBounds& world = {-2.0, 1.0, -1.5, 1.5})
+      : m_capacity{capacity}, m_tile_size{tile_size}, m_world{world} {};
+
+  TileCache(const TileCache&) = delete;
+  TileCache& operator=(const TileCache&) = delete;
+
+  /*
+   * Get a tile, computing it if it isn't in the cache.
+   *
+   * @param key The tile.
+   *
+   * @returns The tile.
+   *
+   * @throws std::out_of_range If the tile lies outside of its zoom level.
+   * @throws std::runtime_error If the backend was not compiled in or is not
+   * supported by the current system.
+   */
+  std::shared_ptr<const Tile> get(const TileKey& key);
+
+  /*
+   * Keep tiles that are evicted in compressed form, up to a capacity.
+   *
+   * Compressed tiles are run-length encoded, which shrinks tiles with large
+   * areas of equal values, such as the interior of the set, to a fraction of
+   * their size. A hit on a compressed tile decompresses it back into the
+   * cache, which is much cheaper than computing it. Tiles are compressed
+   * outside of the lock, so that other requests don't wait for it.
+   *
+   * @param capacity The memory that the compressed tiles may take, in bytes.
+   * Zero disables compression.
+   */
+  void set_compressed_capacity(std::size_t capacity);
+
+  /*
+   * Set the execution policy that tiles are computed with.
+   *
+   * Defaults to "Default", since servers tend to compute many tiles at once,
+   * one per request.
+   *
+   * @param exec The name of the execution policy, e.g. "OMP".
+   */
+  void set_exec(std::string_view exec);
+
+  /*
+   * Get the bounds of the complex plane covered by a tile.
+   *
+   * Tiles are sampled at the centers of their pixels, so that neighbouring
+   * tiles line up without sharing a row or column.
+   *
+   * @param key The tile.
+   *
+   * @returns The bounds of the tile.
+   *
+   * @throws std::out_of_range If the tile lies outside of its zoom level.
+   */
+  ViewBounds bounds(const TileKey& key) const;
+
+  TileCacheStats stats() const;
+
+  std::size_t capacity() const noexcept { return m_capacity; }
+  std::size_t tile_size() const noexcept { return m_tile_size; }
+  const ViewBounds& world() const noexcept { return m_world; }
+
+private:
+  // A channel of a compressed tile, as runs of equal values.
+  template <typename V> struct Runs {
+    std::vector<V> values;
+
+    // The length of each run, or empty if the channel is stored as is because
+    // it doesn't compress.
+    std::vector<std::uint32_t> lengths;
+  };
+
+  struct CompressedTile {
+    Runs<unsigned int> iterations;
+    Runs<float> z_reals;
+    Runs<float> z_imags;
+
+    std::size_t bytes;
+  };
+
+  struct Entry {
+    TileKey key;
+    std::shared_ptr<const Tile> tile;
+  };
+
+  struct CompressedEntry {
+    TileKey key;
+    CompressedTile tile;
+  };
+
+  std::shared_ptr<const Tile> compute(const TileKey& key,
+                                      const std::string& exec) const;
+
+  static CompressedTile compress(const Tile& tile);
+  static std::shared_ptr<const Tile> decompress(const CompressedTile& tile,
+                                                std::size_t size);
+
+  std::vector<Entry> insert(const TileKey& key,
+                            std::shared_ptr<const Tile> tile);
+  std::vector<Entry> evict();
+  void evict_compressed();
+  void compress_evicted(std::vector<Entry> evicted);
+
+  std::size_t m_capacity;
+  std::size_t m_compressed_capacity{0};
+  std::size_t m_tile_size;
+  ViewBounds m_world;
+  std::string m_exec{"Default"};
+
+  mutable std::mutex m_mutex;
+
+  // The tiles, from most to least recently used.
+  std::list<Entry> m_tiles;
+  std::unordered_map<TileKey, std::list<Entry>::iterator> m_index;
+  std::size_t m_bytes{0};
+
+  std::list<CompressedEntry> m_compressed_tiles;
+  std::unordered_map<TileKey, std::list<CompressedEntry>::iterator>
+      m_compressed_index;
+  std::size_t m_compressed_bytes{0};
+
+  // The evicted tiles that are being compressed outside of the lock.
+  std::unordered_map<TileKey, std::shared_ptr<const Tile>> m_compressing;
+
+  // The tiles that are being computed or decompressed.
+  std::unordered_map<TileKey, std::shared_future<std::shared_ptr<const Tile>>>
+      m_pending;
+
+  std::size_t m_hits{0};
+  std::size_t m_misses{0};
+  std::size_t m_coalesced{0};
+  std::size_t m_evictions{0};
+};
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <cmath>
 #include <complex>
+#include <new>
 #include <stdlib.h>
 #include <vector>
 
@@ -59,12 +61,12 @@ using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
  *
  * @returns The mapped coordinate on the axis.
  */
-constexpr float mapIndexToBoundedAxis(const std::size_t idx,
-                                      const std::size_t num_spaces,
-                                      const float start, const float end) {
+template <typename T>
+constexpr T mapIndexToBoundedAxis(const std::size_t idx,
+                                  const std::size_t num_spaces, const T start,
+                                  const T end) {
   return start +
-         (static_cast<float>(idx) / static_cast<float>(num_spaces - 1)) *
-             (end - start);
+         (static_cast<T>(idx) / static_cast<T>(num_spaces - 1)) * (end - start);
 }
 
 /*
@@ -81,19 +83,160 @@ constexpr float mapIndexToBoundedAxis(const std::size_t idx,
  *
  * @returns The mapped position of the pixel on the complex plane.
  */
-constexpr std::complex<float>
+template <typename T>
+constexpr std::complex<T>
 mapPixelToComplexPlane(const std::size_t row, const std::size_t col,
                        const std::size_t width, const std::size_t height,
-                       const float real_min, const float real_max,
-                       const float imag_min, const float imag_max) {
+                       const T real_min, const T real_max, const T imag_min,
+                       const T imag_max) {
   return {
       mapIndexToBoundedAxis(col, width, real_min, real_max), // Real axis
       mapIndexToBoundedAxis(row, height, imag_max, imag_min) // Imag axis
   };
 }
 
+/*
+ * Map an index to a bounded axis linearly, like `mapIndexToBoundedAxis`.
+ *
+ * The kernels map their pixels through this function, whether the pixels are
+ * a run, a list or resumed. It isn't inlined or specialized, so that fast math
+ * can't round the copies of the mapping differently, and every pixel maps to
+ * the same point however it is computed.
+ *
+ * @param idx The index.
+ * @param num_spaces The number of spaces to linearly space to bounded axis
+ * into.
+ * @param start The start of the range.
+ * @param end The end of the range.
+ *
+ * @returns The mapped coordinate on the axis.
+ */
+float mapIndexToAxis(std::size_t idx, std::size_t num_spaces, float start,
+                     float end);
+double mapIndexToAxis(std::size_t idx, std::size_t num_spaces, double start,
+                      double end);
+
+/*
+ * Get the distance between consecutive indices on a bounded axis, for the
+ * SIMD kernels that map a vector of indices at once. Like `mapIndexToAxis`, it
+ * isn't inlined or specialized.
+ *
+ * @param num_spaces The number of spaces to linearly space to bounded axis
+ * into.
+ * @param start The start of the range.
+ * @param end The end of the range.
+ *
+ * @returns The distance between consecutive indices.
+ */
+float axisSpacing(std::size_t num_spaces, float start, float end);
+double axisSpacing(std::size_t num_spaces, double start, double end);
+
+/*
+ * Check whether a point lies within the main cardioid or the period-2 bulb of
+ * the Mandelbrot set.
+ *
+ * Points that pass this test are known to never escape, so they don't have to
+ * be iterated.
+ *
+ * @param c The point on the complex plane.
+ *
+ * @returns Whether the point is within the main cardioid or period-2 bulb.
+ */
+template <typename T>
+constexpr bool isInMainCardioidOrBulb(const std::complex<T> c) {
+  const T real_shifted = c.real() - T{0.25};
+  const T imag_squared = c.imag() * c.imag();
+  const T q = real_shifted * real_shifted + imag_squared;
+
+  if (q * (q + real_shifted) <= T{0.25} * imag_squared) {
+    return true;
+  }
+
+  const T real_bulb = c.real() + T{1};
+
+  return real_bulb * real_bulb + imag_squared <= T{0.0625};
+}
+
+/*
+ * Get the smooth iteration count of a pixel, which continues the iteration
+ * count between whole iterations by how far the final z-value escaped.
+ *
+ * @param iteration The iteration count.
+ * @param max_iterations The maximum iterations.
+ * @param z_real The real part of the final z-value.
+ * @param z_imag The imaginary part of the final z-value.
+ *
+ * @returns The smooth iteration count, or the maximum iterations if the pixel
+ * didn't escape.
+ */
+template <typename T>
+float smoothIteration(const unsigned int iteration,
+                      const unsigned int max_iterations, const T z_real,
+                      const T z_imag) {
+  if (iteration >= max_iterations) {
+    return static_cast<float>(max_iterations);
+  }
+
+  // log2(log2(|z|)), with log2(|z|) = log2(|z|^2) / 2.
+  const T norm = z_real * z_real + z_imag * z_imag;
+
+  return static_cast<float>(static_cast<T>(iteration) + T{1} -
+                            std::log2(std::log2(norm) / T{2}));
+}
+
+/*
+ * Get the exterior distance estimate of a pixel, from its final z-value and
+ * the derivative of its orbit with respect to the point, dz/dc.
+ *
+ * The estimate is 2 |z| ln|z| / |dz/dc|. The distance of the point to the set
+ * lies between a quarter of the estimate and the estimate.
+ *
+ * @param iteration The iteration count.
+ * @param max_iterations The maximum iterations.
+ * @param z_real The real part of the final z-value.
+ * @param z_imag The imaginary part of the final z-value.
+ * @param dz_real The real part of the final derivative.
+ * @param dz_imag The imaginary part of the final derivative.
+ *
+ * @returns The distance estimate, or 0 if the pixel didn't escape.
+ */
+template <typename T>
+float distanceEstimate(const unsigned int iteration,
+                       const unsigned int max_iterations, const T z_real,
+                       const T z_imag, const T dz_real, const T dz_imag) {
+  if (iteration >= max_iterations) {
+    return 0.0f;
+  }
+
+  // |z| ln|z| * 2 = |z| ln(|z|^2).
+  const T norm = z_real * z_real + z_imag * z_imag;
+  const T dz_norm = dz_real * dz_real + dz_imag * dz_imag;
+
+  return static_cast<float>(std::sqrt(norm / dz_norm) * std::log(norm));
+}
+
 #if defined(MANDELBROT_HAS_AVX)
 namespace avx {
+/*
+ * The positions of eight pixels on the complex plane, with the real and
+ * imaginary parts in separate registers.
+ *
+ * A plain struct rather than a `std::pair`, as GCC drops the attributes of
+ * vector types that are passed as template arguments, and warns about it.
+ */
+struct Points {
+  __m256 real;
+  __m256 imag;
+};
+
+/*
+ * The positions of four pixels on the complex plane, in double precision.
+ */
+struct DoublePoints {
+  __m256d real;
+  __m256d imag;
+};
+
 /*
  * Map the columns of eight consecutive pixels in the same row starting at
  * column `col` to their real coordinates in the complex plane.
@@ -139,17 +282,42 @@ __m256 mapRowToImagAxis(const std::size_t row, const std::size_t height,
  *
  * @returns The mapped positions of the pixels on the complex plane.
  */
-std::pair<__m256, __m256>
+Points
 mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
                         const std::size_t width, const std::size_t height,
                         const float real_min, const float real_max,
                         const float imag_min, const float imag_max);
 
+/*
+ * Map up to eight arbitrary pixels onto the complex plane.
+ *
+ * The pixels are given by their index in an image structured as a 1D array.
+ * Unused lanes repeat the last pixel. The mapping is identical to the one for
+ * consecutive pixels.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+Points
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const float real_min, const float real_max,
+                        const float imag_min, const float imag_max);
+
 /*
  * Calculate the norms of multiple complex numbers where the real and imaginary
  * parts are represented by two separate AVX registers.
  *
- * The norm of a complex number (a, bi) is a^2 + b^2.
+ * The norm of a complex number (a, bi) is a^2 + b^2, computed with a fused
+ * multiply-add, so that every kernel rounds it alike.
  *
  * @param real The real parts.
  * @param imag The imaginary parts.
@@ -157,11 +325,133 @@ mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
  * @returns The norms.
  */
 __m256 norm(const __m256 real, const __m256 imag);
+
+/*
+ * Check which of multiple points lie within the main cardioid or the period-2
+ * bulb of the Mandelbrot set.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns A mask with all bits set for the points within the main cardioid or
+ * period-2 bulb.
+ */
+__m256 isInMainCardioidOrBulb(const __m256 real, const __m256 imag);
+/*
+ * Map the columns of four consecutive pixels in the same row starting at
+ * column `col` to their real coordinates in the complex plane, in double
+ * precision.
+ *
+ * @param col The column of the first pixel.
+ * @param width The width of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ *
+ * @returns The real coordinates.
+ */
+__m256d mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
+                             const double real_min, const double real_max);
+
+/*
+ * Map the row of four consecutive pixels in the same row to the imaginary
+ * axis, in double precision.
+ *
+ * @param row The row index.
+ * @param height The height of the image.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The imaginary coordinates.
+ */
+__m256d mapRowToImagAxis(const std::size_t row, const std::size_t height,
+                         const double imag_min, const double imag_max);
+
+/*
+ * Map four consecutive pixels in the same row onto the complex plane, in
+ * double precision.
+ *
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max);
+
+/*
+ * Map up to four arbitrary pixels onto the complex plane, in double precision.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max);
+
+/*
+ * Calculate the norms of multiple complex numbers in double precision.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns The norms.
+ */
+__m256d norm(const __m256d real, const __m256d imag);
+
+/*
+ * Check which of multiple points lie within the main cardioid or the period-2
+ * bulb of the Mandelbrot set, in double precision.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns A mask with all bits set for the points within the main cardioid or
+ * period-2 bulb.
+ */
+__m256d isInMainCardioidOrBulb(const __m256d real, const __m256d imag);
 } // namespace avx
 #endif
 
 #if defined(MANDELBROT_HAS_AVX512)
 namespace avx512 {
+/*
+ * The positions of sixteen pixels on the complex plane, with the real and
+ * imaginary parts in separate registers.
+ *
+ * See `avx::Points`.
+ */
+struct Points {
+  __m512 real;
+  __m512 imag;
+};
+
+/*
+ * The positions of eight pixels on the complex plane, in double precision.
+ */
+struct DoublePoints {
+  __m512d real;
+  __m512d imag;
+};
+
 /*
  * Map the columns of sixteen consecutive pixels in the same row starting at
  * column `col` to their real coordinates in the complex plane.
@@ -207,17 +497,42 @@ __m512 mapRowToImagAxis(const std::size_t row, const std::size_t height,
  *
  * @returns The mapped positions of the pixels on the complex plane.
  */
-std::pair<__m512, __m512>
+Points
 mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
                         const std::size_t width, const std::size_t height,
                         const float real_min, const float real_max,
                         const float imag_min, const float imag_max);
 
+/*
+ * Map up to sixteen arbitrary pixels onto the complex plane.
+ *
+ * The pixels are given by their index in an image structured as a 1D array.
+ * Unused lanes repeat the last pixel. The mapping is identical to the one for
+ * consecutive pixels.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+Points
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const float real_min, const float real_max,
+                        const float imag_min, const float imag_max);
+
 /*
  * Calculate the norms of multiple complex numbers where the real and imaginary
  * parts are represented by two separate AVX registers.
  *
- * The norm of a complex number (a, bi) is a^2 + b^2.
+ * The norm of a complex number (a, bi) is a^2 + b^2, computed with a fused
+ * multiply-add, so that every kernel rounds it alike.
  *
  * @param real The real parts.
  * @param imag The imaginary parts.
@@ -225,6 +540,109 @@ mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
  * @returns The norms.
  */
 __m512 norm(const __m512 real, const __m512 imag);
+
+/*
+ * Check which of multiple points lie within the main cardioid or the period-2
+ * bulb of the Mandelbrot set.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns A mask with the bits set for the points within the main cardioid
+ * or period-2 bulb.
+ */
+__mmask16 isInMainCardioidOrBulb(const __m512 real, const __m512 imag);
+/*
+ * Map the columns of eight consecutive pixels in the same row starting at
+ * column `col` to their real coordinates in the complex plane, in double
+ * precision.
+ *
+ * @param col The column of the first pixel.
+ * @param width The width of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ *
+ * @returns The real coordinates.
+ */
+__m512d mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
+                             const double real_min, const double real_max);
+
+/*
+ * Map the row of eight consecutive pixels in the same row to the imaginary
+ * axis, in double precision.
+ *
+ * @param row The row index.
+ * @param height The height of the image.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The imaginary coordinates.
+ */
+__m512d mapRowToImagAxis(const std::size_t row, const std::size_t height,
+                         const double imag_min, const double imag_max);
+
+/*
+ * Map eight consecutive pixels in the same row onto the complex plane, in
+ * double precision.
+ *
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max);
+
+/*
+ * Map up to eight arbitrary pixels onto the complex plane, in double precision.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param real_min The lower bound of the real axis.
+ * @param real_max The upper bound of the real axis.
+ * @param imag_min The lower bound of the imaginary axis.
+ * @param imag_max The upper bound of the imaginary axis.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max);
+
+/*
+ * Calculate the norms of multiple complex numbers in double precision.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns The norms.
+ */
+__m512d norm(const __m512d real, const __m512d imag);
+
+/*
+ * Check which of multiple points lie within the main cardioid or the period-2
+ * bulb of the Mandelbrot set, in double precision.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns A mask with the bits set for the points within the main cardioid
+ * or period-2 bulb.
+ */
+__mmask8 isInMainCardioidOrBulb(const __m512d real, const __m512d imag);
 } // namespace avx512
 #endif
 } // namespace utility
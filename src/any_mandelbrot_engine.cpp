@@ -0,0 +1,119 @@
+/*
+ * This file contains the runtime dispatch for the type-erased engine.
+ *
+ * The header can be found in: include/any_mandelbrot_engine.hpp
+ */
+
+#include <array>
+#include <format>
+#include <stdexcept>
+
+#if defined(MANDELBROT_HAS_OMP)
+#include <omp.h>
+#endif
+
+#include "any_mandelbrot_engine.hpp"
+#include "backends.hpp"
+#include "mandelbrot_engine.hpp"
+
+namespace {
+struct Candidate {
+  std::string_view backend;
+  std::string_view exec;
+  bool (*is_available)();
+  AnyMandelbrotEngine (*create)(std::size_t, std::size_t, const ViewBounds&,
+                                unsigned int);
+};
+
+template <Backend B, Execution Exec> constexpr Candidate makeCandidate() {
+  return {B::name(), Exec::name(), &B::is_available,
+          [](std::size_t width, std::size_t height, const ViewBounds& bounds,
+             unsigned int max_iterations) {
+            return AnyMandelbrotEngine{MandelbrotEngine<B, Exec>{
+                width, height, bounds, max_iterations}};
+          }};
+}
+
+// All compiled backend and execution policy combinations, ordered from fastest
+// to slowest.
+constexpr std::array candidates{
+#if defined(MANDELBROT_HAS_CUDA)
+    makeCandidate<backend::CUDA, exec::Default>(),
+#endif
+#if defined(MANDELBROT_HAS_AVX512) && defined(MANDELBROT_HAS_OMP)
+    makeCandidate<backend::AVX512, exec::WorkStealing>(),
+    makeCandidate<backend::AVX512, exec::OMP>(),
+#endif
+#if defined(MANDELBROT_HAS_AVX512)
+    makeCandidate<backend::AVX512, exec::Default>(),
+#endif
+#if defined(MANDELBROT_HAS_AVX2) && defined(MANDELBROT_HAS_OMP)
+    makeCandidate<backend::AVX2, exec::WorkStealing>(),
+    makeCandidate<backend::AVX2, exec::OMP>(),
+#endif
+#if defined(MANDELBROT_HAS_AVX2)
+    makeCandidate<backend::AVX2, exec::Default>(),
+#endif
+#if defined(MANDELBROT_HAS_PORTABLE) && defined(MANDELBROT_HAS_OMP)
+    makeCandidate<backend::Portable, exec::WorkStealing>(),
+    makeCandidate<backend::Portable, exec::OMP>(),
+#endif
+#if defined(MANDELBROT_HAS_PORTABLE)
+    makeCandidate<backend::Portable, exec::Default>(),
+#endif
+#if defined(MANDELBROT_HAS_OMP)
+    makeCandidate<backend::Serial, exec::WorkStealing>(),
+    makeCandidate<backend::Serial, exec::OMP>(),
+#endif
+    makeCandidate<backend::Serial, exec::Default>(),
+};
+
+/*
+ * Check whether running with an execution policy is worthwhile on the current
+ * system.
+ *
+ * @param exec The name of the execution policy.
+ *
+ * @returns Whether the execution policy should be preferred.
+ */
+bool isExecUseful(std::string_view exec) {
+#if defined(MANDELBROT_HAS_OMP)
+  if (exec == exec::OMP::name() || exec == exec::WorkStealing::name()) {
+    return omp_get_max_threads() > 1;
+  }
+#endif
+
+  return true;
+}
+} // namespace
+
+AnyMandelbrotEngine make_engine(std::size_t width, std::size_t height,
+                                const ViewBounds& bounds,
+                                unsigned int max_iterations) {
+  for (const Candidate& candidate : candidates) {
+    if (candidate.is_available() && isExecUseful(candidate.exec)) {
+      return candidate.create(width, height, bounds, max_iterations);
+    }
+  }
+
+  // The serial backend with the default execution policy is always available,
+  // so this is unreachable.
+  throw std::runtime_error("No backend is available.");
+}
+
+AnyMandelbrotEngine make_engine(std::size_t width, std::size_t height,
+                                const ViewBounds& bounds,
+                                unsigned int max_iterations,
+                                std::string_view backend,
+                                std::string_view exec) {
+  for (const Candidate& candidate : candidates) {
+    if (candidate.backend == backend && candidate.exec == exec) {
+      // The engine itself throws if the backend is not available.
+      return candidate.create(width, height, bounds, max_iterations);
+    }
+  }
+
+  throw std::runtime_error(std::format(
+      "{} backend with {} execution policy was not compiled in.", backend,
+      exec));
+}
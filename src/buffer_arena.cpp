@@ -0,0 +1,230 @@
+/*
+ * This file contains the implementation of the buffer arena.
+ *
+ * The header can be found in: include/buffer_arena.hpp
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "buffer_arena.hpp"
+
+namespace {
+// The smallest size class without huge pages.
+constexpr std::size_t min_block = std::size_t{64} << 10;
+
+// The size of a huge page on x86-64 and the default on AArch64.
+constexpr std::size_t huge_page = std::size_t{2} << 20;
+
+/*
+ * Fault in the pages of a block by writing to each of them.
+ *
+ * @param block The block.
+ * @param size The size of the block.
+ * @param page The size of a page.
+ */
+void touchPages(void* block, const std::size_t size, const std::size_t page) {
+  auto* bytes = static_cast<volatile std::uint8_t*>(block);
+
+  for (std::size_t offset = 0; offset < size; offset += page) {
+    bytes[offset] = 0;
+  }
+}
+
+/*
+ * Map anonymous memory aligned to a huge page, so that the kernel can back it
+ * with transparent huge pages.
+ *
+ * @param size The size, a multiple of a huge page.
+ *
+ * @returns The memory, or null if it can't be mapped.
+ */
+void* mapAligned(const std::size_t size) {
+  // Map a huge page more than needed, and unmap the misaligned ends.
+  void* mapped = mmap(nullptr, size + huge_page, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (mapped == MAP_FAILED) {
+    return nullptr;
+  }
+
+  const auto start = reinterpret_cast<std::uintptr_t>(mapped);
+  const std::uintptr_t aligned = (start + huge_page - 1) & ~(huge_page - 1);
+  const std::size_t head = aligned - start;
+
+  if (head > 0) {
+    munmap(mapped, head);
+  }
+
+  munmap(reinterpret_cast<void*>(aligned + size), huge_page - head);
+
+  return reinterpret_cast<void*>(aligned);
+}
+} // namespace
+
+BufferArena::~BufferArena() {
+  for (auto& [key, blocks] : m_released) {
+    for (void* block : blocks) {
+      munmap(block, key.first);
+    }
+  }
+}
+
+void* BufferArena::allocate(const std::size_t size, const bool populate) {
+  const std::size_t block_size = size_class(size);
+
+  {
+    std::lock_guard lock{m_mutex};
+    auto released = m_released.find({block_size, populate});
+
+    if (released != m_released.end() && !released->second.empty()) {
+      void* block = released->second.back();
+      released->second.pop_back();
+      m_cached -= block_size;
+
+      return block;
+    }
+  }
+
+  // Map outside the lock, as faulting in a block takes a while.
+  void* block = map_block(block_size, populate);
+
+  std::lock_guard lock{m_mutex};
+  m_mapped += block_size;
+
+  return block;
+}
+
+void BufferArena::deallocate(void* block, const std::size_t size,
+                             const bool populate) noexcept {
+  const std::size_t block_size = size_class(size);
+
+  std::lock_guard lock{m_mutex};
+
+  try {
+    m_released[{block_size, populate}].push_back(block);
+    m_cached += block_size;
+  } catch (...) {
+    // Without memory to track the block, give it back to the system.
+    munmap(block, block_size);
+    m_mapped -= block_size;
+  }
+}
+
+void BufferArena::reserve(const std::size_t size, const std::size_t count) {
+  const std::size_t block_size = size_class(size);
+
+  while (true) {
+    {
+      std::lock_guard lock{m_mutex};
+
+      if (m_released[{block_size, true}].size() >= count) {
+        return;
+      }
+    }
+
+    void* block = map_block(block_size, true);
+
+    std::lock_guard lock{m_mutex};
+    m_released[{block_size, true}].push_back(block);
+    m_mapped += block_size;
+    m_cached += block_size;
+  }
+}
+
+std::size_t BufferArena::mapped_bytes() const {
+  std::lock_guard lock{m_mutex};
+  return m_mapped;
+}
+
+std::size_t BufferArena::cached_bytes() const {
+  std::lock_guard lock{m_mutex};
+  return m_cached;
+}
+
+/*
+ * Get the size of the blocks that serve a size.
+ *
+ * @param size The size in bytes.
+ *
+ * @returns The size of the blocks in bytes.
+ */
+std::size_t BufferArena::size_class(const std::size_t size) const noexcept {
+  const std::size_t min_size =
+      m_huge_pages == HugePages::None ? min_block : huge_page;
+
+  return std::bit_ceil(std::max(size, min_size));
+}
+
+/*
+ * Map a new block.
+ *
+ * @param size The size of the block, a size class.
+ * @param populate Whether to fault in its pages.
+ *
+ * @returns The block.
+ *
+ * @throws std::bad_alloc If the block can't be mapped.
+ */
+void* BufferArena::map_block(const std::size_t size, const bool populate) {
+#if defined(MAP_HUGETLB)
+  if (m_huge_pages == HugePages::Explicit) {
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                      (populate ? MAP_POPULATE : 0);
+    void* block = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+    if (block != MAP_FAILED) {
+      return block;
+    }
+  }
+#endif
+
+  const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+  if (m_huge_pages != HugePages::None) {
+    void* block = mapAligned(size);
+
+    if (block == nullptr) {
+      throw std::bad_alloc();
+    }
+
+#if defined(MADV_HUGEPAGE)
+    madvise(block, size, MADV_HUGEPAGE);
+#endif
+
+    // Fault in the pages after the advice, so that they are huge pages where
+    // the kernel can provide them.
+    if (populate) {
+      touchPages(block, size, page);
+    }
+
+    return block;
+  }
+
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#if defined(MAP_POPULATE)
+  if (populate) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+
+  void* block = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+  if (block == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+
+#if !defined(MAP_POPULATE)
+  if (populate) {
+    touchPages(block, size, page);
+  }
+#endif
+
+  return block;
+}
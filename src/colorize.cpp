@@ -0,0 +1,304 @@
+/*
+ * This file contains the implementation of colorization, and the serial
+ * colorization kernels.
+ *
+ * The header can be found in: include/colorize.hpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+#include "colorize.hpp"
+#include "colorize_kernels.hpp"
+
+namespace {
+/*
+ * Pack a color as RGBA8, red in the lowest byte.
+ *
+ * @param color The color.
+ *
+ * @returns The packed color.
+ */
+constexpr std::uint32_t packColor(const Color color) noexcept {
+  return std::uint32_t{color.r} | std::uint32_t{color.g} << 8 |
+         std::uint32_t{color.b} << 16 | std::uint32_t{color.a} << 24;
+}
+
+/*
+ * Get the luminance of a color, with the weights of ITU-R BT.601.
+ *
+ * @param color The color.
+ *
+ * @returns The luminance.
+ */
+constexpr std::uint32_t luminance(const Color color) noexcept {
+  return (77 * std::uint32_t{color.r} + 150 * std::uint32_t{color.g} +
+          29 * std::uint32_t{color.b} + 128) >>
+         8;
+}
+
+/*
+ * Convert an intensity in [0, 1] to a byte.
+ *
+ * @param intensity The intensity.
+ *
+ * @returns The byte.
+ */
+std::uint8_t toByte(const float intensity) noexcept {
+  return static_cast<std::uint8_t>(
+      std::lround(255.0f * std::clamp(intensity, 0.0f, 1.0f)));
+}
+
+/*
+ * Get the kernels for the widest SIMD instructions that the CPU supports.
+ *
+ * @returns The kernels.
+ */
+const ColorKernels* selectKernels() {
+#if defined(MANDELBROT_HAS_AVX512)
+  if (backend::AVX512::is_available()) {
+    return &colorize::avx512::kernels;
+  }
+#endif
+
+#if defined(MANDELBROT_HAS_AVX2)
+  if (backend::AVX2::is_available()) {
+    return &colorize::avx2::kernels;
+  }
+#endif
+
+  return &colorize::serial::kernels;
+}
+
+/*
+ * Get the palette and mapping of a colorizer in the form the kernels use.
+ *
+ * @param colorizer The colorizer.
+ *
+ * @returns The table.
+ */
+ColorTable makeTable(const Colorizer& colorizer) noexcept {
+  const Palette& palette = colorizer.palette();
+
+  return {palette.colors(),
+          palette.greys(),
+          palette.size(),
+          colorizer.exponent(),
+          colorizer.cycles(),
+          packColor(colorizer.interior()),
+          luminance(colorizer.interior())};
+}
+} // namespace
+
+Palette::Palette(const std::function<Color(float)>& gradient,
+                 const std::size_t size) {
+  if (size == 0) {
+    throw std::invalid_argument("A palette needs at least one color.");
+  }
+
+  m_colors.resize(size);
+  m_greys.resize(size);
+
+  for (std::size_t idx = 0; idx < size; ++idx) {
+    const Color color =
+        gradient(static_cast<float>(idx) / static_cast<float>(size));
+
+    m_colors[idx] = packColor(color);
+    m_greys[idx] = luminance(color);
+  }
+}
+
+Palette Palette::rainbow(const std::size_t size) {
+  const auto gradient = [](const float position) {
+    const auto channel = [position](const float phase) {
+      return toByte(0.5f + 0.5f * std::cos(2.0f * std::numbers::pi_v<float> *
+                                           (position + phase)));
+    };
+
+    return Color{channel(0.0f), channel(0.33f), channel(0.67f)};
+  };
+
+  return Palette{gradient, size};
+}
+
+Palette Palette::greyscale(const std::size_t size) {
+  // Stretch the ramp so that the last entry is white.
+  const float scale =
+      size > 1 ? static_cast<float>(size) / static_cast<float>(size - 1)
+               : 0.0f;
+
+  const auto gradient = [scale](const float position) {
+    const std::uint8_t grey = toByte(position * scale);
+
+    return Color{grey, grey, grey};
+  };
+
+  return Palette{gradient, size};
+}
+
+Palette Palette::gradient(std::vector<std::pair<float, Color>> stops,
+                          const std::size_t size) {
+  if (stops.empty()) {
+    throw std::invalid_argument("A gradient needs at least one stop.");
+  }
+
+  using Stop = std::pair<float, Color>;
+  std::ranges::sort(stops, {}, &Stop::first);
+
+  const auto gradient = [&stops](const float position) {
+    const auto next =
+        std::ranges::lower_bound(stops, position, {}, &Stop::first);
+
+    if (next == stops.begin()) {
+      return stops.front().second;
+    }
+
+    if (next == stops.end()) {
+      return stops.back().second;
+    }
+
+    const auto& [to_position, to] = *next;
+    const auto& [from_position, from] = *std::prev(next);
+    const float t = (position - from_position) / (to_position - from_position);
+
+    const auto mix = [t](const std::uint8_t a, const std::uint8_t b) {
+      return static_cast<std::uint8_t>(std::lround(
+          static_cast<float>(a) +
+          t * (static_cast<float>(b) - static_cast<float>(a))));
+    };
+
+    return Color{mix(from.r, to.r), mix(from.g, to.g), mix(from.b, to.b),
+                 mix(from.a, to.a)};
+  };
+
+  return Palette{gradient, size};
+}
+
+Color Palette::operator[](const std::size_t idx) const noexcept {
+  const std::uint32_t color = m_colors[idx];
+
+  return {static_cast<std::uint8_t>(color),
+          static_cast<std::uint8_t>(color >> 8),
+          static_cast<std::uint8_t>(color >> 16),
+          static_cast<std::uint8_t>(color >> 24)};
+}
+
+Colorizer::Colorizer(Palette palette, const float exponent, const float cycles,
+                     const Color interior)
+    : m_palette{std::move(palette)}, m_exponent{exponent}, m_cycles{cycles},
+      m_interior{interior}, m_kernels{selectKernels()} {}
+
+void Colorizer::colorize(const float* smooth, const std::size_t count,
+                         const unsigned int max_iterations,
+                         const PixelFormat format,
+                         std::uint8_t* pixels) const {
+  m_kernels->colorize(smooth, count, max_iterations, makeTable(*this), format,
+                      pixels);
+}
+
+Color Colorizer::color(const float smooth,
+                       const unsigned int max_iterations) const noexcept {
+  if (smooth >= static_cast<float>(max_iterations)) {
+    return m_interior;
+  }
+
+  return m_palette[colorize::paletteIndex(smooth, max_iterations,
+                                          makeTable(*this))];
+}
+
+void Colorizer::colorize_rows(const std::size_t height,
+                              const std::size_t width,
+                              const unsigned int max_iterations,
+                              const PixelFormat format, std::uint8_t* pixels,
+                              const RowSource& source) const {
+  const ColorTable table = makeTable(*this);
+  const std::size_t stride = width * bytesPerPixel(format);
+
+#if defined(MANDELBROT_HAS_OMP)
+#pragma omp parallel
+#endif
+  {
+    std::vector<float> buffer(width);
+
+#if defined(MANDELBROT_HAS_OMP)
+#pragma omp for schedule(static)
+#endif
+    for (std::size_t row = 0; row < height; ++row) {
+      m_kernels->colorize(source(row, buffer.data()), width, max_iterations,
+                          table, format, pixels + row * stride);
+    }
+  }
+}
+
+void Colorizer::smooth_row(const unsigned int* iterations,
+                           const float* z_reals, const float* z_imags,
+                           const std::size_t count,
+                           const unsigned int max_iterations,
+                           float* smooth) const {
+  m_kernels->smooth_float(iterations, z_reals, z_imags, count, max_iterations,
+                          smooth);
+}
+
+void Colorizer::smooth_row(const unsigned int* iterations,
+                           const double* z_reals, const double* z_imags,
+                           const std::size_t count,
+                           const unsigned int max_iterations,
+                           float* smooth) const {
+  m_kernels->smooth_double(iterations, z_reals, z_imags, count, max_iterations,
+                           smooth);
+}
+
+namespace colorize {
+std::size_t paletteIndex(const float smooth, const unsigned int max_iterations,
+                         const ColorTable& table) noexcept {
+  const float relative =
+      std::max(smooth / static_cast<float>(max_iterations),
+               std::numeric_limits<float>::min());
+
+  float position = table.cycles * std::pow(relative, table.exponent);
+  position -= std::floor(position);
+
+  return std::min(
+      static_cast<std::size_t>(position * static_cast<float>(table.size)),
+      table.size - 1);
+}
+
+namespace serial {
+namespace {
+template <Scalar T>
+void smoothRow(const unsigned int* iterations, const T* z_reals,
+               const T* z_imags, const std::size_t count,
+               const unsigned int max_iterations, float* smooth) {
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    smooth[idx] = utility::smoothIteration(iterations[idx], max_iterations,
+                                           z_reals[idx], z_imags[idx]);
+  }
+}
+} // namespace
+
+void colorize(const float* smooth, const std::size_t count,
+              const unsigned int max_iterations, const ColorTable& table,
+              const PixelFormat format, std::uint8_t* pixels) {
+  const std::size_t bytes = bytesPerPixel(format);
+
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    if (smooth[idx] >= static_cast<float>(max_iterations)) {
+      storeColor(table.interior_color, table.interior_grey, format,
+                 pixels + idx * bytes);
+      continue;
+    }
+
+    const std::size_t entry = paletteIndex(smooth[idx], max_iterations, table);
+    storeColor(table.colors[entry], table.greys[entry], format,
+               pixels + idx * bytes);
+  }
+}
+
+const ColorKernels kernels{&colorize, &smoothRow<float>, &smoothRow<double>};
+} // namespace serial
+} // namespace colorize
@@ -0,0 +1,232 @@
+/*
+ * This file contains the AVX2 colorization kernels.
+ *
+ * The kernels color eight pixels at a time. The exponent of the mapping is
+ * computed as exp2(exponent * log2(x)), with polynomial approximations of
+ * log2 and exp2 that are accurate to about 1e-6, since AVX2 has no vector
+ * logarithm. The approximation of log2 is shared with the Mandelbrot kernels,
+ * see src/vector_math.hpp. The palette entries are gathered from the lookup
+ * table.
+ *
+ * The declarations can be found in: src/colorize_kernels.hpp
+ */
+
+#if defined(MANDELBROT_HAS_AVX2)
+
+#include <cstddef>
+#include <limits>
+#include <numbers>
+
+#include <immintrin.h>
+
+#include "colorize_kernels.hpp"
+#include "utility.hpp"
+#include "vector_math.hpp"
+
+namespace colorize::avx2 {
+namespace {
+constexpr std::size_t lanes = 8;
+
+/*
+ * Calculate powers of two.
+ *
+ * @param x The exponents, clamped to the normal range of `float`.
+ *
+ * @returns The powers.
+ */
+__m256 exp2(__m256 x) {
+  x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.0f)),
+                    _mm256_set1_ps(126.0f));
+
+  const __m256 whole = _mm256_floor_ps(x);
+  const __m256 f =
+      _mm256_mul_ps(_mm256_sub_ps(x, whole),
+                    _mm256_set1_ps(std::numbers::ln2_v<float>));
+
+  // e^f by its Taylor series, with f in [0, ln(2)).
+  __m256 power = _mm256_set1_ps(1.0f / 5040.0f);
+
+  for (const float coefficient : {1.0f / 720.0f, 1.0f / 120.0f, 1.0f / 24.0f,
+                                  1.0f / 6.0f, 1.0f / 2.0f, 1.0f, 1.0f}) {
+    power = _mm256_add_ps(_mm256_mul_ps(power, f),
+                          _mm256_set1_ps(coefficient));
+  }
+
+  // Scale by 2^whole by adding it to the exponent.
+  return _mm256_castsi256_ps(_mm256_add_epi32(
+      _mm256_castps_si256(power),
+      _mm256_slli_epi32(_mm256_cvtps_epi32(whole), 23)));
+}
+
+/*
+ * Get the palette entries of eight pixels.
+ *
+ * @param smooth The smooth iteration counts.
+ * @param inverse_max The inverse of the maximum iterations.
+ * @param table The palette and mapping.
+ *
+ * @returns The indices of the palette entries.
+ */
+__m256i paletteIndices(const __m256 smooth, const __m256 inverse_max,
+                       const ColorTable& table) {
+  const __m256 relative =
+      _mm256_max_ps(_mm256_mul_ps(smooth, inverse_max),
+                    _mm256_set1_ps(std::numeric_limits<float>::min()));
+
+  __m256 position = _mm256_mul_ps(
+      _mm256_set1_ps(table.cycles),
+      exp2(_mm256_mul_ps(_mm256_set1_ps(table.exponent),
+                         vector_math::avx2::log2(relative))));
+  position = _mm256_sub_ps(position, _mm256_floor_ps(position));
+
+  const __m256i idx = _mm256_cvttps_epi32(
+      _mm256_mul_ps(position, _mm256_set1_ps(static_cast<float>(table.size))));
+
+  return _mm256_min_epi32(idx,
+                          _mm256_set1_epi32(static_cast<int>(table.size - 1)));
+}
+
+/*
+ * Store eight packed colors in a pixel format.
+ *
+ * @param colors The colors, or their luminance for `PixelFormat::Grey8`.
+ * @param format The pixel format.
+ * @param pixels The pixels.
+ */
+void storePixels(const __m256i colors, const PixelFormat format,
+                 std::uint8_t* pixels) {
+  switch (format) {
+  case PixelFormat::Grey8: {
+    // Gather the lowest byte of every color at the start of each half.
+    const __m256i bytes = _mm256_shuffle_epi8(
+        colors, _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1,
+                                 -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1,
+                                 -1, -1, -1, -1, -1, -1, -1, -1));
+    const __m256i packed = _mm256_permutevar8x32_epi32(
+        bytes, _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels),
+                     _mm256_castsi256_si128(packed));
+    break;
+  }
+  case PixelFormat::RGB8: {
+    // Drop the alpha byte of every color, then close the gap between the
+    // halves.
+    const __m256i bytes = _mm256_shuffle_epi8(
+        colors, _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1,
+                                 -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12,
+                                 13, 14, -1, -1, -1, -1));
+    const __m256i packed = _mm256_permutevar8x32_epi32(
+        bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels),
+                     _mm256_castsi256_si128(packed));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels + 16),
+                     _mm256_extracti128_si256(packed, 1));
+    break;
+  }
+  case PixelFormat::RGBA8:
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), colors);
+    break;
+  }
+}
+
+/*
+ * Store the smooth iteration counts of eight pixels.
+ *
+ * @param iterations The iteration counts.
+ * @param norm The norms of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param smooth The smooth iteration counts.
+ */
+void storeSmooth(const __m256i iterations, const __m256 norm,
+                 const unsigned int max_iterations, float* smooth) {
+  _mm256_storeu_ps(smooth, vector_math::avx2::smoothIterations(
+                               iterations, norm, max_iterations));
+}
+
+void colorize(const float* smooth, const std::size_t count,
+              const unsigned int max_iterations, const ColorTable& table,
+              const PixelFormat format, std::uint8_t* pixels) {
+  const bool grey = format == PixelFormat::Grey8;
+  const auto* lookup =
+      reinterpret_cast<const int*>(grey ? table.greys : table.colors);
+  const __m256i interior = _mm256_set1_epi32(static_cast<int>(
+      grey ? table.interior_grey : table.interior_color));
+
+  const auto max_float = static_cast<float>(max_iterations);
+  const __m256 max = _mm256_set1_ps(max_float);
+  const __m256 inverse_max = _mm256_set1_ps(1.0f / max_float);
+  const std::size_t bytes = bytesPerPixel(format);
+
+  std::size_t idx = 0;
+
+  for (; idx + lanes <= count; idx += lanes) {
+    const __m256 values = _mm256_loadu_ps(smooth + idx);
+    const __m256i inside =
+        _mm256_castps_si256(_mm256_cmp_ps(values, max, _CMP_GE_OQ));
+
+    const __m256i colors = _mm256_i32gather_epi32(
+        lookup, paletteIndices(values, inverse_max, table), 4);
+
+    storePixels(_mm256_blendv_epi8(colors, interior, inside), format,
+                pixels + idx * bytes);
+  }
+
+  serial::colorize(smooth + idx, count - idx, max_iterations, table, format,
+                   pixels + idx * bytes);
+}
+
+void smoothFloat(const unsigned int* iterations, const float* z_reals,
+                 const float* z_imags, const std::size_t count,
+                 const unsigned int max_iterations, float* smooth) {
+  std::size_t idx = 0;
+
+  for (; idx + lanes <= count; idx += lanes) {
+    const __m256 real = _mm256_loadu_ps(z_reals + idx);
+    const __m256 imag = _mm256_loadu_ps(z_imags + idx);
+
+    storeSmooth(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(iterations + idx)),
+        _mm256_add_ps(_mm256_mul_ps(real, real), _mm256_mul_ps(imag, imag)),
+        max_iterations, smooth + idx);
+  }
+
+  for (; idx < count; ++idx) {
+    smooth[idx] = utility::smoothIteration(iterations[idx], max_iterations,
+                                           z_reals[idx], z_imags[idx]);
+  }
+}
+
+void smoothDouble(const unsigned int* iterations, const double* z_reals,
+                  const double* z_imags, const std::size_t count,
+                  const unsigned int max_iterations, float* smooth) {
+  std::size_t idx = 0;
+
+  // The norms of escaped pixels are small, so they are narrowed to `float`.
+  const auto norm = [&](const std::size_t first) {
+    const __m256d real = _mm256_loadu_pd(z_reals + first);
+    const __m256d imag = _mm256_loadu_pd(z_imags + first);
+
+    return _mm256_cvtpd_ps(
+        _mm256_add_pd(_mm256_mul_pd(real, real), _mm256_mul_pd(imag, imag)));
+  };
+
+  for (; idx + lanes <= count; idx += lanes) {
+    storeSmooth(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(iterations + idx)),
+        _mm256_set_m128(norm(idx + 4), norm(idx)), max_iterations,
+        smooth + idx);
+  }
+
+  for (; idx < count; ++idx) {
+    smooth[idx] = utility::smoothIteration(iterations[idx], max_iterations,
+                                           z_reals[idx], z_imags[idx]);
+  }
+}
+} // namespace
+
+const ColorKernels kernels{&colorize, &smoothFloat, &smoothDouble};
+} // namespace colorize::avx2
+
+#endif
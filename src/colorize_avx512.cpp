@@ -0,0 +1,249 @@
+/*
+ * This file contains the AVX512 colorization kernels.
+ *
+ * The kernels color sixteen pixels at a time, with the same approximations of
+ * log2 and exp2 as the AVX2 kernels.
+ *
+ * The declarations can be found in: src/colorize_kernels.hpp
+ */
+
+#if defined(MANDELBROT_HAS_AVX512)
+
+#include <cstddef>
+#include <limits>
+#include <numbers>
+
+#include <immintrin.h>
+
+#include "colorize_kernels.hpp"
+#include "utility.hpp"
+#include "vector_math.hpp"
+
+namespace colorize::avx512 {
+namespace {
+constexpr std::size_t lanes = 16;
+
+// Every lane. The kernels use the zero-masked forms of the intrinsics that
+// would otherwise pass undefined values through, which GCC warns about.
+constexpr __mmask16 all = 0xFFFF;
+
+/*
+ * Round down to whole numbers.
+ *
+ * @param x The numbers.
+ *
+ * @returns The rounded numbers.
+ */
+__m512 floor(const __m512 x) {
+  return _mm512_maskz_roundscale_ps(all, x,
+                                    _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+}
+
+/*
+ * Calculate powers of two.
+ *
+ * @param x The exponents, clamped to the normal range of `float`.
+ *
+ * @returns The powers.
+ */
+__m512 exp2(__m512 x) {
+  x = _mm512_maskz_min_ps(
+      all, _mm512_maskz_max_ps(all, x, _mm512_set1_ps(-126.0f)),
+      _mm512_set1_ps(126.0f));
+
+  const __m512 whole = floor(x);
+  const __m512 f =
+      _mm512_mul_ps(_mm512_sub_ps(x, whole),
+                    _mm512_set1_ps(std::numbers::ln2_v<float>));
+
+  // e^f by its Taylor series, with f in [0, ln(2)).
+  __m512 power = _mm512_set1_ps(1.0f / 5040.0f);
+
+  for (const float coefficient : {1.0f / 720.0f, 1.0f / 120.0f, 1.0f / 24.0f,
+                                  1.0f / 6.0f, 1.0f / 2.0f, 1.0f, 1.0f}) {
+    power = _mm512_add_ps(_mm512_mul_ps(power, f),
+                          _mm512_set1_ps(coefficient));
+  }
+
+  // Scale by 2^whole by adding it to the exponent.
+  return _mm512_castsi512_ps(_mm512_add_epi32(
+      _mm512_castps_si512(power),
+      _mm512_maskz_slli_epi32(all, _mm512_maskz_cvttps_epi32(all, whole),
+                              23)));
+}
+
+/*
+ * Get the palette entries of sixteen pixels.
+ *
+ * @param smooth The smooth iteration counts.
+ * @param inverse_max The inverse of the maximum iterations.
+ * @param table The palette and mapping.
+ *
+ * @returns The indices of the palette entries.
+ */
+__m512i paletteIndices(const __m512 smooth, const __m512 inverse_max,
+                       const ColorTable& table) {
+  const __m512 relative = _mm512_maskz_max_ps(
+      all, _mm512_mul_ps(smooth, inverse_max),
+      _mm512_set1_ps(std::numeric_limits<float>::min()));
+
+  __m512 position = _mm512_mul_ps(
+      _mm512_set1_ps(table.cycles),
+      exp2(_mm512_mul_ps(_mm512_set1_ps(table.exponent),
+                         vector_math::avx512::log2(relative))));
+  position = _mm512_sub_ps(position, floor(position));
+
+  const __m512i idx = _mm512_maskz_cvttps_epi32(
+      all,
+      _mm512_mul_ps(position, _mm512_set1_ps(static_cast<float>(table.size))));
+
+  return _mm512_maskz_min_epi32(
+      all, idx, _mm512_set1_epi32(static_cast<int>(table.size - 1)));
+}
+
+/*
+ * Store eight packed colors as RGB8.
+ *
+ * AVX512F can't shuffle bytes, so each half of the colors is packed with AVX2.
+ *
+ * @param colors The colors.
+ * @param pixels The pixels.
+ */
+void storeRGB(const __m256i colors, std::uint8_t* pixels) {
+  // Drop the alpha byte of every color, then close the gap between the halves.
+  const __m256i bytes = _mm256_shuffle_epi8(
+      colors, _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1,
+                               -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                               -1, -1, -1, -1));
+  const __m256i packed = _mm256_permutevar8x32_epi32(
+      bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels),
+                   _mm256_castsi256_si128(packed));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels + 16),
+                   _mm256_extracti128_si256(packed, 1));
+}
+
+/*
+ * Store sixteen packed colors in a pixel format.
+ *
+ * @param colors The colors, or their luminance for `PixelFormat::Grey8`.
+ * @param format The pixel format.
+ * @param pixels The pixels.
+ */
+void storePixels(const __m512i colors, const PixelFormat format,
+                 std::uint8_t* pixels) {
+  switch (format) {
+  case PixelFormat::Grey8:
+    _mm512_mask_cvtepi32_storeu_epi8(pixels, all, colors);
+    break;
+  case PixelFormat::RGB8:
+    storeRGB(_mm512_maskz_extracti64x4_epi64(0xFF, colors, 0), pixels);
+    storeRGB(_mm512_maskz_extracti64x4_epi64(0xFF, colors, 1), pixels + 24);
+    break;
+  case PixelFormat::RGBA8:
+    _mm512_storeu_si512(pixels, colors);
+    break;
+  }
+}
+
+/*
+ * Store the smooth iteration counts of sixteen pixels.
+ *
+ * @param iterations The iteration counts.
+ * @param norm The norms of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param smooth The smooth iteration counts.
+ */
+void storeSmooth(const __m512i iterations, const __m512 norm,
+                 const unsigned int max_iterations, float* smooth) {
+  _mm512_storeu_ps(smooth, vector_math::avx512::smoothIterations(
+                               iterations, norm, max_iterations));
+}
+
+void colorize(const float* smooth, const std::size_t count,
+              const unsigned int max_iterations, const ColorTable& table,
+              const PixelFormat format, std::uint8_t* pixels) {
+  const bool grey = format == PixelFormat::Grey8;
+  const std::uint32_t* lookup = grey ? table.greys : table.colors;
+  const __m512i interior = _mm512_set1_epi32(static_cast<int>(
+      grey ? table.interior_grey : table.interior_color));
+
+  const auto max_float = static_cast<float>(max_iterations);
+  const __m512 max = _mm512_set1_ps(max_float);
+  const __m512 inverse_max = _mm512_set1_ps(1.0f / max_float);
+  const std::size_t bytes = bytesPerPixel(format);
+
+  std::size_t idx = 0;
+
+  for (; idx + lanes <= count; idx += lanes) {
+    const __m512 values = _mm512_loadu_ps(smooth + idx);
+    const __mmask16 inside = _mm512_cmp_ps_mask(values, max, _CMP_GE_OQ);
+
+    const __m512i colors = _mm512_mask_i32gather_epi32(
+        _mm512_setzero_si512(), all,
+        paletteIndices(values, inverse_max, table), lookup, 4);
+
+    storePixels(_mm512_mask_blend_epi32(inside, colors, interior), format,
+                pixels + idx * bytes);
+  }
+
+  serial::colorize(smooth + idx, count - idx, max_iterations, table, format,
+                   pixels + idx * bytes);
+}
+
+void smoothFloat(const unsigned int* iterations, const float* z_reals,
+                 const float* z_imags, const std::size_t count,
+                 const unsigned int max_iterations, float* smooth) {
+  std::size_t idx = 0;
+
+  for (; idx + lanes <= count; idx += lanes) {
+    const __m512 real = _mm512_loadu_ps(z_reals + idx);
+    const __m512 imag = _mm512_loadu_ps(z_imags + idx);
+
+    storeSmooth(
+        _mm512_loadu_si512(iterations + idx),
+        _mm512_add_ps(_mm512_mul_ps(real, real), _mm512_mul_ps(imag, imag)),
+        max_iterations, smooth + idx);
+  }
+
+  for (; idx < count; ++idx) {
+    smooth[idx] = utility::smoothIteration(iterations[idx], max_iterations,
+                                           z_reals[idx], z_imags[idx]);
+  }
+}
+
+void smoothDouble(const unsigned int* iterations, const double* z_reals,
+                  const double* z_imags, const std::size_t count,
+                  const unsigned int max_iterations, float* smooth) {
+  std::size_t idx = 0;
+
+  // The norms of escaped pixels are small, so they are narrowed to `float`.
+  const auto norm = [&](const std::size_t first) {
+    const __m512d real = _mm512_loadu_pd(z_reals + first);
+    const __m512d imag = _mm512_loadu_pd(z_imags + first);
+
+    return _mm256_castps_pd(_mm512_maskz_cvtpd_ps(
+        0xFF,
+        _mm512_add_pd(_mm512_mul_pd(real, real), _mm512_mul_pd(imag, imag))));
+  };
+
+  for (; idx + lanes <= count; idx += lanes) {
+    const __m512d norms = _mm512_maskz_insertf64x4(
+        0xFF, _mm512_castpd256_pd512(norm(idx)), norm(idx + 8), 1);
+
+    storeSmooth(_mm512_loadu_si512(iterations + idx),
+                _mm512_castpd_ps(norms), max_iterations, smooth + idx);
+  }
+
+  for (; idx < count; ++idx) {
+    smooth[idx] = utility::smoothIteration(iterations[idx], max_iterations,
+                                           z_reals[idx], z_imags[idx]);
+  }
+}
+} // namespace
+
+const ColorKernels kernels{&colorize, &smoothFloat, &smoothDouble};
+} // namespace colorize::avx512
+
+#endif
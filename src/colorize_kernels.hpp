@@ -0,0 +1,100 @@
+/*
+ * This file contains the declarations for the colorization kernels.
+ *
+ * A colorization kernel colors a run of pixels by their smooth iteration
+ * counts, or derives the smooth iteration counts of a run of pixels from their
+ * iteration counts and z-values. `Colorizer` picks the kernels for the widest
+ * SIMD instructions that the CPU supports once, when it is created.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "colorize.hpp"
+
+// The palette and mapping of a `Colorizer`, in the form the kernels use.
+struct ColorTable {
+  const std::uint32_t* colors;
+  const std::uint32_t* greys;
+  std::size_t size;
+
+  float exponent;
+  float cycles;
+
+  std::uint32_t interior_color;
+  std::uint32_t interior_grey;
+};
+
+struct ColorKernels {
+  void (*colorize)(const float* smooth, std::size_t count,
+                   unsigned int max_iterations, const ColorTable& table,
+                   PixelFormat format, std::uint8_t* pixels);
+
+  void (*smooth_float)(const unsigned int* iterations, const float* z_reals,
+                       const float* z_imags, std::size_t count,
+                       unsigned int max_iterations, float* smooth);
+  void (*smooth_double)(const unsigned int* iterations, const double* z_reals,
+                        const double* z_imags, std::size_t count,
+                        unsigned int max_iterations, float* smooth);
+};
+
+namespace colorize {
+/*
+ * Get the palette entry of a pixel that escaped.
+ *
+ * @param smooth The smooth iteration count.
+ * @param max_iterations The maximum iterations.
+ * @param table The palette and mapping.
+ *
+ * @returns The index of the palette entry.
+ */
+std::size_t paletteIndex(float smooth, unsigned int max_iterations,
+                         const ColorTable& table) noexcept;
+
+/*
+ * Store a packed RGBA8 color in a pixel format.
+ *
+ * @param color The color.
+ * @param grey The luminance of the color.
+ * @param format The pixel format.
+ * @param pixel The pixel.
+ */
+inline void storeColor(const std::uint32_t color, const std::uint32_t grey,
+                       const PixelFormat format, std::uint8_t* pixel) noexcept {
+  switch (format) {
+  case PixelFormat::Grey8:
+    pixel[0] = static_cast<std::uint8_t>(grey);
+    break;
+  case PixelFormat::RGBA8:
+    pixel[3] = static_cast<std::uint8_t>(color >> 24);
+    [[fallthrough]];
+  case PixelFormat::RGB8:
+    pixel[0] = static_cast<std::uint8_t>(color);
+    pixel[1] = static_cast<std::uint8_t>(color >> 8);
+    pixel[2] = static_cast<std::uint8_t>(color >> 16);
+    break;
+  }
+}
+
+namespace serial {
+extern const ColorKernels kernels;
+
+void colorize(const float* smooth, std::size_t count,
+              unsigned int max_iterations, const ColorTable& table,
+              PixelFormat format, std::uint8_t* pixels);
+} // namespace serial
+
+#if defined(MANDELBROT_HAS_AVX2)
+namespace avx2 {
+extern const ColorKernels kernels;
+} // namespace avx2
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+namespace avx512 {
+extern const ColorKernels kernels;
+} // namespace avx512
+#endif
+} // namespace colorize
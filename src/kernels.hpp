@@ -0,0 +1,522 @@
+/*
+ * This file contains the declarations for the backend kernels.
+ *
+ * A kernel computes either a run of consecutive pixels within a single row, or
+ * a list of arbitrary pixels. Which pixels are computed, and by which thread,
+ * is decided by the execution policy in mandelbrot_engine.cpp. This keeps the
+ * vectorized code in one place per backend, independent of how the work is
+ * scheduled.
+ *
+ * The SIMD kernels come in three variants, see `KernelVariant`. The block
+ * variant iterates a fixed block of pixels until all of them retire. The
+ * lane-refill variant treats the pixels it is given as a queue and loads the
+ * next pending pixel into a lane as soon as the pixel in it retires. The
+ * interleaved variant iterates several blocks together, and is instantiated
+ * for every supported `Interleaving`, see `withInterleaving`.
+ *
+ * A kernel can also resume pixels from the state that an earlier computation
+ * left in the output. Resumed pixels start at different iteration counts, so
+ * the SIMD kernels always resume them with lane refill.
+ *
+ * Kernels compute in either single or double precision. The bounds in
+ * `KernelParams` are rounded to the scalar type of the kernel before use.
+ *
+ * Kernels only store the channels selected by their channel policy, see
+ * `channels::Full`. Resuming pixels needs their z-values, so only kernels that
+ * store every channel can resume. Kernels with a distance estimate also track
+ * the derivative of every orbit, which the SIMD kernels only do in the block
+ * variant.
+ *
+ * Every kernel also has a perturbation variant, used by `PerturbationEngine`.
+ * It iterates the difference of each pixel to a precomputed reference orbit
+ * rather than the pixel itself.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "backends.hpp"
+#include "mandelbrot_engine.hpp"
+#include "resources.hpp"
+#include "utility.hpp"
+
+struct KernelParams {
+  std::size_t width;
+  std::size_t height;
+  ViewBounds bounds;
+  unsigned int max_iterations;
+  bool interior_detection;
+  KernelVariant variant;
+  Interleaving interleaving;
+
+  // The distance estimate below which a pixel counts as part of the set, on
+  // the complex plane. Only channels with a distance estimate use it.
+  double boundary_distance;
+
+  // The square of the bailout radius. A pixel escapes once the norm of its
+  // z-value exceeds it.
+  double bailout_norm;
+};
+
+/*
+ * Call a function once for every index below `N`, passed as a
+ * `std::integral_constant`, so that loops over a fixed number of vectors are
+ * unrolled.
+ *
+ * @tparam N The number of indices.
+ *
+ * @param f The function.
+ */
+template <std::size_t N, typename F> void unroll(F&& f) {
+  [&]<std::size_t... Idx>(std::index_sequence<Idx...>) {
+    (f(std::integral_constant<std::size_t, Idx>{}), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+/*
+ * Call a function template with the shape of the interleaved kernels as
+ * template arguments.
+ *
+ * @param shape The shape, as normalized by
+ * `MandelbrotEngine::set_interleaving`.
+ * @param f The function, called as `f.template operator()<Vectors,
+ * CheckInterval>()`.
+ */
+template <typename F>
+void withInterleaving(const Interleaving shape, F&& f) {
+  const auto with_vectors = [&]<std::size_t Vectors>() {
+    switch (shape.check_interval) {
+    case 1:
+      return f.template operator()<Vectors, 1>();
+    case 2:
+      return f.template operator()<Vectors, 2>();
+    case 4:
+      return f.template operator()<Vectors, 4>();
+    case 8:
+      return f.template operator()<Vectors, 8>();
+    case 16:
+      return f.template operator()<Vectors, 16>();
+    default:
+      return f.template operator()<Vectors, 32>();
+    }
+  };
+
+  switch (shape.vectors) {
+  case 2:
+    return with_vectors.template operator()<2>();
+  case 3:
+    return with_vectors.template operator()<3>();
+  default:
+    return with_vectors.template operator()<4>();
+  }
+}
+
+/*
+ * The buffers that a kernel stores its results in. The buffers of the channels
+ * that `C` doesn't keep are null.
+ */
+template <Scalar T, Channels C = channels::Full> struct KernelOutput {
+  /*
+   * Get the output offset by `idx` pixels.
+   *
+   * @param idx The offset in pixels.
+   *
+   * @returns The offset output.
+   */
+  KernelOutput at(std::size_t idx) const noexcept {
+    KernelOutput out = *this;
+
+    if constexpr (C::iterations) {
+      out.iterations += idx;
+    }
+
+    if constexpr (C::z) {
+      out.z_reals += idx;
+      out.z_imags += idx;
+    }
+
+    if constexpr (C::smooth) {
+      out.smooth += idx;
+    }
+
+    if constexpr (C::distance) {
+      out.distance += idx;
+    }
+
+    return out;
+  }
+
+  typename C::Iteration* iterations;
+  T* z_reals;
+  T* z_imags;
+  float* smooth;
+  float* distance;
+};
+
+/*
+ * Get the output that stores into the buffers of an image on the host.
+ *
+ * @param host The buffers, which must be allocated.
+ *
+ * @returns The output, pointing at the first pixel of the image.
+ */
+template <Backend B, Scalar T, Channels C>
+KernelOutput<T, C> makeOutput(HostResources<B, T, C>& host) noexcept {
+  KernelOutput<T, C> out{nullptr, nullptr, nullptr, nullptr, nullptr};
+
+  if constexpr (C::iterations) {
+    out.iterations = host.iterations.data();
+  }
+
+  if constexpr (C::z) {
+    out.z_reals = host.z_reals.data();
+    out.z_imags = host.z_imags.data();
+  }
+
+  if constexpr (C::smooth) {
+    out.smooth = host.smooth.data();
+  }
+
+  if constexpr (C::distance) {
+    out.distance = host.distance.data();
+  }
+
+  return out;
+}
+
+/*
+ * Store the result of a single pixel in the channels of an output.
+ *
+ * @param out The output.
+ * @param idx The offset of the pixel in the output.
+ * @param iteration The iteration count.
+ * @param z_real The real part of the final z-value.
+ * @param z_imag The imaginary part of the final z-value.
+ * @param max_iterations The maximum iterations.
+ */
+template <Scalar T, Channels C>
+inline void storePixel(const KernelOutput<T, C>& out, const std::size_t idx,
+                       const unsigned int iteration, const T z_real,
+                       const T z_imag, const unsigned int max_iterations) {
+  if constexpr (C::iterations) {
+    out.iterations[idx] = static_cast<typename C::Iteration>(iteration);
+  }
+
+  if constexpr (C::z) {
+    out.z_reals[idx] = z_real;
+    out.z_imags[idx] = z_imag;
+  }
+
+  if constexpr (C::smooth) {
+    out.smooth[idx] =
+        utility::smoothIteration(iteration, max_iterations, z_real, z_imag);
+  }
+}
+
+/*
+ * Store the result of a single pixel, with its distance estimate, in the
+ * channels of an output.
+ *
+ * A pixel closer to the set than the boundary distance of the parameters is
+ * stored as part of the set, with the maximum iterations and a distance of 0.
+ *
+ * @param out The output.
+ * @param idx The offset of the pixel in the output.
+ * @param iteration The iteration count.
+ * @param z_real The real part of the final z-value.
+ * @param z_imag The imaginary part of the final z-value.
+ * @param dz_real The real part of the final derivative.
+ * @param dz_imag The imaginary part of the final derivative.
+ * @param params The parameters of the computation.
+ */
+template <Scalar T, Channels C>
+  requires(C::distance)
+inline void storePixel(const KernelOutput<T, C>& out, const std::size_t idx,
+                       unsigned int iteration, const T z_real, const T z_imag,
+                       const T dz_real, const T dz_imag,
+                       const KernelParams& params) {
+  float distance = utility::distanceEstimate(
+      iteration, params.max_iterations, z_real, z_imag, dz_real, dz_imag);
+
+  if (distance < params.boundary_distance) {
+    iteration = params.max_iterations;
+    distance = 0.0f;
+  }
+
+  storePixel(out, idx, iteration, z_real, z_imag, params.max_iterations);
+  out.distance[idx] = distance;
+}
+
+template <Scalar T> struct PerturbationParams {
+  std::size_t width;
+  std::size_t height;
+
+  // The offset of the top-left pixel to the reference point, and the distance
+  // between two adjacent pixels.
+  double real_offset;
+  double imag_offset;
+  double step;
+
+  unsigned int max_iterations;
+
+  // The reference orbit, starting at zero. It holds at least two points.
+  const T* orbit_reals;
+  const T* orbit_imags;
+  std::size_t orbit_length;
+
+  // The series approximating the first `skipped_iterations` iterations of the
+  // differences, at most `orbit_length - 2`. Its coefficients start at the
+  // linear term, and apply to the offsets divided by `series_scale`.
+  unsigned int skipped_iterations;
+  const T* series_reals;
+  const T* series_imags;
+  std::size_t series_terms;
+  double series_scale;
+
+  // The square of the bailout radius.
+  double bailout_norm;
+};
+
+// The rows and columns of a rectangle of pixels, both inclusive.
+struct Rect {
+  std::size_t row_min, row_max;
+  std::size_t col_min, col_max;
+
+  std::size_t width() const noexcept { return col_max - col_min + 1; }
+  std::size_t height() const noexcept { return row_max - row_min + 1; }
+};
+
+template <Backend B, Scalar T, Channels C = channels::Full> struct Kernel;
+
+template <Scalar T, Channels C> struct Kernel<backend::Serial, T, C> {
+  static constexpr std::size_t lanes = 1;
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const KernelParams& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T, C>& out);
+
+  /*
+   * Compute `count` arbitrary pixels, given by their index in the image.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void compute(const KernelParams& params, const std::size_t* indices,
+                      std::size_t count, const KernelOutput<T, C>& out);
+
+  /*
+   * Continue `count` arbitrary pixels, given by their index in the image, from
+   * the iteration counts and z-values in the output.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void resume(const KernelParams& params, const std::size_t* indices,
+                     std::size_t count, const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`,
+   * by perturbing a reference orbit.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const PerturbationParams<T>& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+};
+
+#if defined(MANDELBROT_HAS_AVX2)
+template <Scalar T, Channels C> struct Kernel<backend::AVX2, T, C> {
+  static constexpr std::size_t lanes = backend::AVX2::alignment / sizeof(T);
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const KernelParams& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T, C>& out);
+
+  /*
+   * Compute `count` arbitrary pixels, given by their index in the image.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void compute(const KernelParams& params, const std::size_t* indices,
+                      std::size_t count, const KernelOutput<T, C>& out);
+
+  /*
+   * Continue `count` arbitrary pixels, given by their index in the image, from
+   * the iteration counts and z-values in the output.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void resume(const KernelParams& params, const std::size_t* indices,
+                     std::size_t count, const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`,
+   * by perturbing a reference orbit.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const PerturbationParams<T>& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+};
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+template <Scalar T, Channels C> struct Kernel<backend::AVX512, T, C> {
+  static constexpr std::size_t lanes = backend::AVX512::alignment / sizeof(T);
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const KernelParams& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T, C>& out);
+
+  /*
+   * Compute `count` arbitrary pixels, given by their index in the image.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void compute(const KernelParams& params, const std::size_t* indices,
+                      std::size_t count, const KernelOutput<T, C>& out);
+
+  /*
+   * Continue `count` arbitrary pixels, given by their index in the image, from
+   * the iteration counts and z-values in the output.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void resume(const KernelParams& params, const std::size_t* indices,
+                     std::size_t count, const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`,
+   * by perturbing a reference orbit.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const PerturbationParams<T>& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+};
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+template <Scalar T, Channels C> struct Kernel<backend::Portable, T, C> {
+  static constexpr std::size_t lanes = backend::Portable::alignment / sizeof(T);
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const KernelParams& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T, C>& out);
+
+  /*
+   * Compute `count` arbitrary pixels, given by their index in the image.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void compute(const KernelParams& params, const std::size_t* indices,
+                      std::size_t count, const KernelOutput<T, C>& out);
+
+  /*
+   * Continue `count` arbitrary pixels, given by their index in the image, from
+   * the iteration counts and z-values in the output.
+   *
+   * @param params The parameters of the computation.
+   * @param indices The indices of the pixels.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel of the image.
+   */
+  static void resume(const KernelParams& params, const std::size_t* indices,
+                     std::size_t count, const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+
+  /*
+   * Compute `count` consecutive pixels in row `row`, starting at column `col`,
+   * by perturbing a reference orbit.
+   *
+   * @param params The parameters of the computation.
+   * @param row The row of the pixels.
+   * @param col The column of the first pixel.
+   * @param count The number of pixels.
+   * @param out The output, pointing at the first pixel.
+   */
+  static void compute(const PerturbationParams<T>& params, std::size_t row,
+                      std::size_t col, std::size_t count,
+                      const KernelOutput<T>& out)
+    requires std::is_same_v<C, channels::Full>;
+};
+#endif
@@ -4,98 +4,1557 @@
 
 #if defined(MANDELBROT_HAS_AVX2)
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
 #include <immintrin.h>
 
 #include "backends.hpp"
-#include "mandelbrot_engine.hpp"
+#include "kernels.hpp"
 #include "utility.hpp"
+#include "vector_math.hpp"
 
+namespace {
 /*
- * Compute the Mandelbrot set with AVX2 acceleration.
+ * Get the permutation of 32-bit elements that moves the first lanes of a
+ * vector into the lanes set in a mask, in order.
+ *
+ * AVX2 doesn't have the expand instructions of AVX512, so they are emulated
+ * with a permute. The permutations for every mask are computed at compile
+ * time.
+ *
+ * @tparam T The scalar type of the lanes.
+ *
+ * @param mask The lanes to expand into, one bit per lane.
  *
- * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ * @returns The permutation.
  */
-template <>
-MandelbrotResult<backend::AVX2> MandelbrotEngine<backend::AVX2>::compute() {
-  constexpr std::size_t lanes = backend::AVX2::alignment / sizeof(float);
+template <Scalar T> __m256i expandPermutation(const unsigned int mask) {
+  constexpr std::size_t lanes = Kernel<backend::AVX2, T>::lanes;
+  constexpr std::size_t elements_per_lane = sizeof(T) / sizeof(std::int32_t);
 
-  for (std::size_t row = 0; row < m_height; ++row) {
-    for (std::size_t col = 0; col < m_width; col += lanes) {
-      const auto [c_real, c_imag] = utility::avx::mapPixelsToComplexPlane(
-          row, col, m_width, m_height, m_bounds.real_min, m_bounds.real_max,
-          m_bounds.imag_min, m_bounds.imag_max);
+  static constexpr auto permutations = [] {
+    std::array<std::array<std::uint8_t, 8>, 1 << lanes> permutations{};
 
-      __m256 z_real = _mm256_setzero_ps();
-      __m256 z_imag = _mm256_setzero_ps();
+    for (std::size_t bits = 0; bits < permutations.size(); ++bits) {
+      std::size_t next{0};
+
+      for (std::size_t lane = 0; lane < lanes; ++lane) {
+        if (bits & (1u << lane)) {
+          for (std::size_t i = 0; i < elements_per_lane; ++i) {
+            permutations[bits][lane * elements_per_lane + i] =
+                static_cast<std::uint8_t>(next * elements_per_lane + i);
+          }
+
+          ++next;
+        }
+      }
+    }
 
-      __m256i iter_counts = _mm256_setzero_si256();
+    return permutations;
+  }();
 
-      for (unsigned int i = 0; i < m_max_iterations; ++i) {
-        const __m256 norm = utility::avx::norm(z_real, z_imag);
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+      reinterpret_cast<const __m128i*>(permutations[mask].data())));
+}
 
-        // Check which pixels have not escaped yet.
-        const __m256 active =
-            _mm256_cmp_ps(norm, _mm256_set1_ps(4.0f), _CMP_LE_OS);
+/*
+ * The AVX2 instructions for a scalar type, so that the kernels can be written
+ * once for both single and double precision.
+ *
+ * Masks are vectors with all bits of a lane set. Iteration counts are kept in
+ * lanes of the same width as the scalar type, so that the same mask applies to
+ * both.
+ */
+template <Scalar T> struct Simd;
 
-        // If all pixels have escaped, stop early.
-        if (_mm256_movemask_ps(active) == 0) {
-          break;
-        }
+template <> struct Simd<float> {
+  using Vec = __m256;
+  using Count = __m256i;
+  using CountElement = std::int32_t;
+  using Mask = __m256;
+
+  static constexpr std::size_t lanes = Kernel<backend::AVX2, float>::lanes;
+
+  static Vec zero() { return _mm256_setzero_ps(); }
+  static Vec set1(const float a) { return _mm256_set1_ps(a); }
+  static Vec add(const Vec a, const Vec b) { return _mm256_add_ps(a, b); }
+  static Vec sub(const Vec a, const Vec b) { return _mm256_sub_ps(a, b); }
+  static Vec mul(const Vec a, const Vec b) { return _mm256_mul_ps(a, b); }
+  static Vec fmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  static Vec fnmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm256_fnmadd_ps(a, b, c);
+  }
+
+  static Mask cmp_le(const Vec a, const Vec b) {
+    return _mm256_cmp_ps(a, b, _CMP_LE_OS);
+  }
+  static Mask cmp_eq(const Vec a, const Vec b) {
+    return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+  }
+  static Mask cmp_lt(const Vec a, const Vec b) {
+    return _mm256_cmp_ps(a, b, _CMP_LT_OS);
+  }
+
+  static Vec mask_and(const Mask k, const Vec a) { return _mm256_and_ps(k, a); }
+  static Vec mask_andnot(const Mask k, const Vec a) {
+    return _mm256_andnot_ps(k, a);
+  }
+  static Mask mask_or(const Mask a, const Mask b) { return _mm256_or_ps(a, b); }
+  static unsigned int mask_bits(const Mask k) {
+    return static_cast<unsigned int>(_mm256_movemask_ps(k));
+  }
+  static Mask mask_from_bits(const unsigned int bits) {
+    const __m256i lane_bits = _mm256_set_epi32(128, 64, 32, 16, 8, 4, 2, 1);
+
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+        _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lane_bits),
+        lane_bits));
+  }
+
+  static Vec blend(const Vec a, const Vec b, const Mask k) {
+    return _mm256_blendv_ps(a, b, k);
+  }
+  static Vec expand(const Vec src, const unsigned int bits, const Vec a) {
+    return _mm256_blendv_ps(
+        src, _mm256_permutevar8x32_ps(a, expandPermutation<float>(bits)),
+        mask_from_bits(bits));
+  }
+
+  static Vec load(const float* src) { return _mm256_load_ps(src); }
+  static Vec gather(const float* base, const Count idx) {
+    return _mm256_i32gather_ps(base, idx, 4);
+  }
+
+  static void store(float* dst, const Vec a) { _mm256_store_ps(dst, a); }
+  static void storeu(float* dst, const Vec a) { _mm256_storeu_ps(dst, a); }
+
+  static Count count_zero() { return _mm256_setzero_si256(); }
+  static Count count_set1(const std::size_t a) {
+    return _mm256_set1_epi32(static_cast<int>(a));
+  }
+  static Count count_lane_offsets() {
+    return _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+  }
+  static Count count_add(const Count a, const Count b) {
+    return _mm256_add_epi32(a, b);
+  }
+  static Count count_mask_and(const Mask k, const Count a) {
+    return _mm256_and_si256(_mm256_castps_si256(k), a);
+  }
+  static Count count_blend(const Count a, const Count b, const Mask k) {
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a),
+                                                _mm256_castsi256_ps(b), k));
+  }
+  static Count count_expand(const Count src, const unsigned int bits,
+                            const Count a) {
+    return _mm256_castps_si256(expand(_mm256_castsi256_ps(src), bits,
+                                      _mm256_castsi256_ps(a)));
+  }
+  static Mask count_cmp_eq(const Count a, const Count b) {
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b));
+  }
+
+  static Count count_load(const std::int32_t* src) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(src));
+  }
+  static void count_store(std::int32_t* dst, const Count a) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(dst), a);
+  }
+  static void count_storeu(unsigned int* dst, const Count a) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), a);
+  }
+  static void count_storeu(std::uint16_t* dst, const Count a) {
+    // Narrow the counts to 16 bits. The pack works within each half of the
+    // vector, so the halves are joined afterwards.
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, a),
+                                                    0b1000);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm256_castsi256_si128(packed));
+  }
+
+  static void smooth_storeu(float* dst, const Count a, const Vec norm,
+                            const unsigned int max_iterations) {
+    _mm256_storeu_ps(dst, vector_math::avx2::smoothIterations(
+                              a, norm, max_iterations));
+  }
+};
+
+template <> struct Simd<double> {
+  using Vec = __m256d;
+  using Count = __m256i;
+  using CountElement = std::int64_t;
+  using Mask = __m256d;
+
+  static constexpr std::size_t lanes = Kernel<backend::AVX2, double>::lanes;
+
+  static Vec zero() { return _mm256_setzero_pd(); }
+  static Vec set1(const double a) { return _mm256_set1_pd(a); }
+  static Vec add(const Vec a, const Vec b) { return _mm256_add_pd(a, b); }
+  static Vec sub(const Vec a, const Vec b) { return _mm256_sub_pd(a, b); }
+  static Vec mul(const Vec a, const Vec b) { return _mm256_mul_pd(a, b); }
+  static Vec fmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  static Vec fnmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm256_fnmadd_pd(a, b, c);
+  }
+
+  static Mask cmp_le(const Vec a, const Vec b) {
+    return _mm256_cmp_pd(a, b, _CMP_LE_OS);
+  }
+  static Mask cmp_eq(const Vec a, const Vec b) {
+    return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+  }
+  static Mask cmp_lt(const Vec a, const Vec b) {
+    return _mm256_cmp_pd(a, b, _CMP_LT_OS);
+  }
+
+  static Vec mask_and(const Mask k, const Vec a) { return _mm256_and_pd(k, a); }
+  static Vec mask_andnot(const Mask k, const Vec a) {
+    return _mm256_andnot_pd(k, a);
+  }
+  static Mask mask_or(const Mask a, const Mask b) { return _mm256_or_pd(a, b); }
+  static unsigned int mask_bits(const Mask k) {
+    return static_cast<unsigned int>(_mm256_movemask_pd(k));
+  }
+  static Mask mask_from_bits(const unsigned int bits) {
+    const __m256i lane_bits = _mm256_set_epi64x(8, 4, 2, 1);
+
+    return _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+        _mm256_and_si256(_mm256_set1_epi64x(bits), lane_bits), lane_bits));
+  }
+
+  static Vec blend(const Vec a, const Vec b, const Mask k) {
+    return _mm256_blendv_pd(a, b, k);
+  }
+  static Vec expand(const Vec src, const unsigned int bits, const Vec a) {
+    const __m256 expanded = _mm256_permutevar8x32_ps(
+        _mm256_castpd_ps(a), expandPermutation<double>(bits));
+
+    return _mm256_blendv_pd(src, _mm256_castps_pd(expanded),
+                            mask_from_bits(bits));
+  }
+
+  static Vec load(const double* src) { return _mm256_load_pd(src); }
+  static Vec gather(const double* base, const Count idx) {
+    return _mm256_i64gather_pd(base, idx, 8);
+  }
+
+  static void store(double* dst, const Vec a) { _mm256_store_pd(dst, a); }
+  static void storeu(double* dst, const Vec a) { _mm256_storeu_pd(dst, a); }
+
+  static Count count_zero() { return _mm256_setzero_si256(); }
+  static Count count_set1(const std::size_t a) {
+    return _mm256_set1_epi64x(static_cast<long long>(a));
+  }
+  static Count count_lane_offsets() { return _mm256_set_epi64x(3, 2, 1, 0); }
+  static Count count_add(const Count a, const Count b) {
+    return _mm256_add_epi64(a, b);
+  }
+  static Count count_mask_and(const Mask k, const Count a) {
+    return _mm256_and_si256(_mm256_castpd_si256(k), a);
+  }
+  static Count count_blend(const Count a, const Count b, const Mask k) {
+    return _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(a),
+                                                _mm256_castsi256_pd(b), k));
+  }
+  static Count count_expand(const Count src, const unsigned int bits,
+                            const Count a) {
+    return _mm256_castpd_si256(expand(_mm256_castsi256_pd(src), bits,
+                                      _mm256_castsi256_pd(a)));
+  }
+  static Mask count_cmp_eq(const Count a, const Count b) {
+    return _mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b));
+  }
+
+  static Count count_load(const std::int64_t* src) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(src));
+  }
+  static void count_store(std::int64_t* dst, const Count a) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(dst), a);
+  }
+  static void count_storeu(unsigned int* dst, const Count a) {
+    // Narrow the counts to 32 bits by gathering their low halves.
+    const __m256i narrowed = _mm256_permutevar8x32_epi32(
+        a, _mm256_set_epi32(6, 4, 2, 0, 6, 4, 2, 0));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm256_castsi256_si128(narrowed));
+  }
+  static void count_storeu(std::uint16_t* dst, const Count a) {
+    // Narrow the counts to 32 bits and then to 16 bits.
+    const __m256i narrowed = _mm256_permutevar8x32_epi32(
+        a, _mm256_set_epi32(6, 4, 2, 0, 6, 4, 2, 0));
+    const __m128i half = _mm256_castsi256_si128(narrowed);
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi32(half, half));
+  }
+
+  static void smooth_storeu(float* dst, const Count a, const Vec norm,
+                            const unsigned int max_iterations) {
+    // Narrow the counts to 32 bits and the norms to `float`, which holds the
+    // norms of escaped pixels, and compute the lower half of the vector.
+    const __m256i narrowed = _mm256_permutevar8x32_epi32(
+        a, _mm256_set_epi32(6, 4, 2, 0, 6, 4, 2, 0));
+    const __m128 norm_narrowed = _mm256_cvtpd_ps(norm);
+    const __m256 smooth = vector_math::avx2::smoothIterations(
+        narrowed, _mm256_set_m128(norm_narrowed, norm_narrowed),
+        max_iterations);
+
+    _mm_storeu_ps(dst, _mm256_castps256_ps128(smooth));
+  }
+};
+
+/*
+ * Map pixels onto the complex plane in the precision of the kernel.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param args The pixels, as accepted by
+ * `utility::avx::mapPixelsToComplexPlane`.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+template <Scalar T, typename... Args>
+auto mapPixels(const KernelParams& params, const Args... args) {
+  return utility::avx::mapPixelsToComplexPlane(
+      args..., params.width, params.height,
+      static_cast<T>(params.bounds.real_min),
+      static_cast<T>(params.bounds.real_max),
+      static_cast<T>(params.bounds.imag_min),
+      static_cast<T>(params.bounds.imag_max));
+}
+
+/*
+ * Advance a vector of points by one iteration, with fused multiply-adds.
+ *
+ * Every kernel iterates with it. The fused multiply-adds are explicit, so the
+ * compiler can neither contract nor reassociate the iteration differently
+ * from one kernel to the next, and the kernels round alike.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param z_real The real parts of the z-values.
+ * @param z_imag The imaginary parts of the z-values.
+ */
+template <Scalar T>
+void step(const typename Simd<T>::Vec c_real,
+          const typename Simd<T>::Vec c_imag, typename Simd<T>::Vec& z_real,
+          typename Simd<T>::Vec& z_imag) {
+  using S = Simd<T>;
+
+  // z_real^2 - z_imag^2 + c_real and 2 * z_real * z_imag + c_imag.
+  const typename S::Vec z_real_new =
+      S::fmadd(z_real, z_real, S::fnmadd(z_imag, z_imag, c_real));
+  z_imag = S::fmadd(S::add(z_real, z_real), z_imag, c_imag);
+  z_real = z_real_new;
+}
+
+/*
+ * Iterate a vector of points until they escape or reach the maximum
+ * iterations.
+ *
+ * With interior detection enabled, lanes within the main cardioid or period-2
+ * bulb are retired before iterating, and the orbits are checked for
+ * periodicity using Brent's method. A lane whose orbit repeats exactly is
+ * retired as interior, keeping its z-value at the time of detection.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Derivative Whether to track the derivatives of the orbits.
+ *
+ * @param params The parameters of the computation.
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param dz_real The real parts of the final derivatives, if tracked.
+ * @param dz_imag The imaginary parts of the final derivatives, if tracked.
+ *
+ * @returns The iteration counts.
+ */
+template <Scalar T, bool InteriorDetection, bool Derivative = false>
+typename Simd<T>::Count
+iterate(const KernelParams& params, const typename Simd<T>::Vec c_real,
+        const typename Simd<T>::Vec c_imag, typename Simd<T>::Vec& z_real,
+        typename Simd<T>::Vec& z_imag,
+        [[maybe_unused]] typename Simd<T>::Vec* dz_real = nullptr,
+        [[maybe_unused]] typename Simd<T>::Vec* dz_imag = nullptr) {
+  using S = Simd<T>;
+  using Mask = typename S::Mask;
+
+  const typename S::Vec bailout =
+      S::set1(static_cast<T>(params.bailout_norm));
+
+  z_real = S::zero();
+  z_imag = S::zero();
+
+  if constexpr (Derivative) {
+    *dz_real = S::zero();
+    *dz_imag = S::zero();
+  }
+
+  typename S::Count iter_counts = S::count_zero();
+
+  // Lanes that are known to never escape.
+  Mask interior = S::zero();
+
+  [[maybe_unused]] typename S::Vec z_real_saved = z_real;
+  [[maybe_unused]] typename S::Vec z_imag_saved = z_imag;
+  [[maybe_unused]] unsigned int save_at{1};
+
+  if constexpr (InteriorDetection) {
+    interior = utility::avx::isInMainCardioidOrBulb(c_real, c_imag);
+  }
+
+  for (unsigned int i = 0; i < params.max_iterations; ++i) {
+    const typename S::Vec norm = utility::avx::norm(z_real, z_imag);
+
+    // Check which pixels have not escaped yet.
+    Mask active = S::cmp_le(norm, bailout);
+
+    if constexpr (InteriorDetection) {
+      active = S::mask_andnot(interior, active);
+    }
+
+    // If all pixels have escaped, stop early.
+    if (S::mask_bits(active) == 0) {
+      break;
+    }
+
+    // Only update the iteration count for active pixels.
+    iter_counts = S::count_add(iter_counts,
+                               S::count_mask_and(active, S::count_set1(1)));
+
+    if constexpr (Derivative) {
+      // dz = 2 * z * dz + 1, from the z-values before this iteration.
+      const typename S::Vec z_real_2 = S::add(z_real, z_real);
+      const typename S::Vec z_imag_2 = S::add(z_imag, z_imag);
+      const typename S::Vec dz_real_new = S::fmadd(
+          z_real_2, *dz_real, S::fnmadd(z_imag_2, *dz_imag, S::set1(T{1})));
+      const typename S::Vec dz_imag_new =
+          S::fmadd(z_real_2, *dz_imag, S::mul(z_imag_2, *dz_real));
+
+      *dz_real = S::blend(*dz_real, dz_real_new, active);
+      *dz_imag = S::blend(*dz_imag, dz_imag_new, active);
+    }
+
+    typename S::Vec z_real_new = z_real;
+    typename S::Vec z_imag_new = z_imag;
+    step<T>(c_real, c_imag, z_real_new, z_imag_new);
+
+    // Only update the real and imaginary parts for active pixels.
+    z_real = S::blend(z_real, z_real_new, active);
+    z_imag = S::blend(z_imag, z_imag_new, active);
+
+    if constexpr (InteriorDetection) {
+      // An active orbit that returns exactly to its saved point is periodic.
+      const Mask periodic = S::mask_and(
+          active, S::mask_and(S::cmp_eq(z_real, z_real_saved),
+                              S::cmp_eq(z_imag, z_imag_saved)));
+      interior = S::mask_or(interior, periodic);
+
+      if (i + 1 == save_at) {
+        z_real_saved = z_real;
+        z_imag_saved = z_imag;
+        save_at <<= 1;
+      }
+    }
+  }
+
+  if constexpr (InteriorDetection) {
+    iter_counts = S::count_blend(
+        iter_counts, S::count_set1(params.max_iterations), interior);
+  }
+
+  return iter_counts;
+}
+
+/*
+ * Store the results of up to one vector of consecutive pixels.
+ *
+ * Full vectors are stored directly, with the smooth iteration counts computed
+ * by the vector approximation of the logarithm in src/vector_math.hpp, as
+ * AVX2 doesn't have one. Partial vectors are stored per lane.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, Channels C>
+void storeBlock(const std::size_t count,
+                const typename Simd<T>::Count iter_counts,
+                const typename Simd<T>::Vec z_real,
+                const typename Simd<T>::Vec z_imag,
+                const unsigned int max_iterations,
+                const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  if (count == S::lanes) {
+    if constexpr (C::iterations) {
+      S::count_storeu(out.iterations, iter_counts);
+    }
+
+    if constexpr (C::z) {
+      S::storeu(out.z_reals, z_real);
+      S::storeu(out.z_imags, z_imag);
+    }
+
+    if constexpr (C::smooth) {
+      S::smooth_storeu(out.smooth, iter_counts,
+                       utility::avx::norm(z_real, z_imag), max_iterations);
+    }
+
+    return;
+  }
+
+  // AVX2 doesn't have masked stores so we have to manually copy the remaining
+  // elements if it doesn't fit perfectly in a lane.
+  alignas(backend::AVX2::alignment) typename S::CountElement
+      lane_iters[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_real[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_imag[S::lanes];
+
+  S::count_store(lane_iters, iter_counts);
+  S::store(lane_real, z_real);
+  S::store(lane_imag, z_imag);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, i, static_cast<unsigned int>(lane_iters[i]), lane_real[i],
+               lane_imag[i], max_iterations);
+  }
+}
+
+/*
+ * Store the results of up to one vector of arbitrary pixels.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, Channels C>
+void storeList(const std::size_t* indices, const std::size_t count,
+               const typename Simd<T>::Count iter_counts,
+               const typename Simd<T>::Vec z_real,
+               const typename Simd<T>::Vec z_imag,
+               const unsigned int max_iterations,
+               const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  alignas(backend::AVX2::alignment) typename S::CountElement
+      lane_iters[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_real[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_imag[S::lanes];
+
+  S::count_store(lane_iters, iter_counts);
+  S::store(lane_real, z_real);
+  S::store(lane_imag, z_imag);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, indices[i], static_cast<unsigned int>(lane_iters[i]),
+               lane_real[i], lane_imag[i], max_iterations);
+  }
+}
+
+/*
+ * Store the results of up to one vector of pixels with their distance
+ * estimates, which are computed per lane.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param indices The indices of the pixels, or null for consecutive pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param dz_real The real parts of the final derivatives.
+ * @param dz_imag The imaginary parts of the final derivatives.
+ * @param params The parameters of the computation.
+ * @param out The output, pointing at the first pixel, or at the first pixel of
+ * the image with indices.
+ */
+template <Scalar T, Channels C>
+void storeDistances(const std::size_t* indices, const std::size_t count,
+                    const typename Simd<T>::Count iter_counts,
+                    const typename Simd<T>::Vec z_real,
+                    const typename Simd<T>::Vec z_imag,
+                    const typename Simd<T>::Vec dz_real,
+                    const typename Simd<T>::Vec dz_imag,
+                    const KernelParams& params,
+                    const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  alignas(backend::AVX2::alignment) typename S::CountElement
+      lane_iters[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_real[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_imag[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_dz_real[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_dz_imag[S::lanes];
+
+  S::count_store(lane_iters, iter_counts);
+  S::store(lane_real, z_real);
+  S::store(lane_imag, z_imag);
+  S::store(lane_dz_real, dz_real);
+  S::store(lane_dz_imag, dz_imag);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, indices != nullptr ? indices[i] : i,
+               static_cast<unsigned int>(lane_iters[i]), lane_real[i],
+               lane_imag[i], lane_dz_real[i], lane_dz_imag[i], params);
+  }
+}
+
+/*
+ * Compute up to one vector of consecutive pixels in the same row.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, bool InteriorDetection, Channels C>
+void computeBlock(const KernelParams& params, const std::size_t row,
+                  const std::size_t col, const std::size_t count,
+                  const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  const auto [c_real, c_imag] = mapPixels<T>(params, row, col);
+
+  typename S::Vec z_real, z_imag;
+
+  if constexpr (C::distance) {
+    typename S::Vec dz_real, dz_imag;
+    const typename S::Count iter_counts = iterate<T, InteriorDetection, true>(
+        params, c_real, c_imag, z_real, z_imag, &dz_real, &dz_imag);
+
+    storeDistances(nullptr, count, iter_counts, z_real, z_imag, dz_real,
+                   dz_imag, params, out);
+  } else {
+    const typename S::Count iter_counts =
+        iterate<T, InteriorDetection>(params, c_real, c_imag, z_real, z_imag);
+
+    storeBlock(count, iter_counts, z_real, z_imag, params.max_iterations, out);
+  }
+}
+
+/*
+ * Compute up to one vector of arbitrary pixels.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, bool InteriorDetection, Channels C>
+void computeBlock(const KernelParams& params, const std::size_t* indices,
+                  const std::size_t count, const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  const auto [c_real, c_imag] = mapPixels<T>(params, indices, count);
+
+  typename S::Vec z_real, z_imag;
+
+  if constexpr (C::distance) {
+    typename S::Vec dz_real, dz_imag;
+    const typename S::Count iter_counts = iterate<T, InteriorDetection, true>(
+        params, c_real, c_imag, z_real, z_imag, &dz_real, &dz_imag);
+
+    storeDistances(indices, count, iter_counts, z_real, z_imag, dz_real,
+                   dz_imag, params, out);
+  } else {
+    const typename S::Count iter_counts =
+        iterate<T, InteriorDetection>(params, c_real, c_imag, z_real, z_imag);
+
+    storeList(indices, count, iter_counts, z_real, z_imag,
+              params.max_iterations, out);
+  }
+}
+
+/*
+ * The pending pixels of a run of consecutive pixels in the same row.
+ */
+template <Scalar T> struct RunQueue {
+  static constexpr bool resumes = false;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   *
+   * @returns The mapped positions of one vector of pixels starting at `first`.
+   */
+  auto map(const std::size_t first, const std::size_t /* count */) const {
+    return mapPixels<T>(params, row, col + first);
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the output of the run.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return position;
+  }
+
+  const KernelParams& params;
+  std::size_t row;
+  std::size_t col;
+};
+
+/*
+ * The pending pixels of a list of arbitrary pixels.
+ */
+template <Scalar T> struct ListQueue {
+  static constexpr bool resumes = false;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The mapped positions of the pixels.
+   */
+  auto map(const std::size_t first, const std::size_t count) const {
+    return mapPixels<T>(params, indices + first, count);
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the first pixel of the image.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return indices[position];
+  }
+
+  const KernelParams& params;
+  const std::size_t* indices;
+};
+
+/*
+ * The pending pixels of a list of arbitrary pixels that continue from the state
+ * in the output.
+ */
+template <Scalar T> struct ResumeQueue {
+  static constexpr bool resumes = true;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The mapped positions of the pixels.
+   */
+  auto map(const std::size_t first, const std::size_t count) const {
+    return mapPixels<T>(params, indices + first, count);
+  }
+
+  /*
+   * Load the state that pending pixels continue from.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The z-values and iteration counts of the pixels, in the lowest
+   * lanes.
+   */
+  auto start(const std::size_t first, const std::size_t count) const {
+    using S = Simd<T>;
+
+    alignas(backend::AVX2::alignment) T lane_real[S::lanes]{};
+    alignas(backend::AVX2::alignment) T lane_imag[S::lanes]{};
+    alignas(backend::AVX2::alignment) typename S::CountElement
+        lane_iters[S::lanes]{};
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::size_t idx = indices[first + i];
+
+      lane_real[i] = out.z_reals[idx];
+      lane_imag[i] = out.z_imags[idx];
+      lane_iters[i] =
+          static_cast<typename S::CountElement>(out.iterations[idx]);
+    }
+
+    return std::tuple{S::load(lane_real), S::load(lane_imag),
+                      S::count_load(lane_iters)};
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the first pixel of the image.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return indices[position];
+  }
+
+  const KernelParams& params;
+  const std::size_t* indices;
+  const KernelOutput<T>& out;
+};
+
+/*
+ * Select the lowest lanes of a mask.
+ *
+ * @param mask The mask, one bit per lane.
+ * @param count The number of lanes to select.
+ *
+ * @returns The lowest `count` lanes set in `mask`.
+ */
+unsigned int lowestLanes(const unsigned int mask, const std::size_t count) {
+  unsigned int rest = mask;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    rest &= rest - 1;
+  }
+
+  return mask & ~rest;
+}
+
+/*
+ * Compute a queue of pixels, refilling each lane with the next pending pixel as
+ * soon as its pixel retires.
+ *
+ * The lanes iterate together until at least one of them retires. The results
+ * of the retired lanes are written, after which the next pending pixels are
+ * expanded into the free lanes. The results are identical to those of the
+ * block kernel.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Queue The type of the queue, `RunQueue`, `ListQueue` or
+ * `ResumeQueue`.
+ *
+ * @param params The parameters of the computation.
+ * @param queue The pending pixels.
+ * @param count The number of pixels in the queue.
+ * @param out The output that the offsets of the queue are relative to.
+ */
+template <Scalar T, bool InteriorDetection, typename Queue, Channels C>
+void computeRefill(const KernelParams& params, const Queue& queue,
+                   const std::size_t count, const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+  using Vec = typename S::Vec;
+  using Count = typename S::Count;
+  using Mask = typename S::Mask;
+
+  constexpr unsigned int all_lanes = (1u << S::lanes) - 1;
+
+  const Count max_iterations = S::count_set1(params.max_iterations);
+  const Vec bailout = S::set1(static_cast<T>(params.bailout_norm));
+
+  Vec c_real = S::zero();
+  Vec c_imag = S::zero();
+  Vec z_real = S::zero();
+  Vec z_imag = S::zero();
+  Count iter_counts = S::count_zero();
+
+  // The position in the queue of the pixel in each lane.
+  Count positions = S::count_zero();
+
+  // Brent's method needs a saved point and save interval per lane, as the lanes
+  // started iterating at different times.
+  [[maybe_unused]] Vec z_real_saved = S::zero();
+  [[maybe_unused]] Vec z_imag_saved = S::zero();
+  [[maybe_unused]] Count save_at = S::count_zero();
+
+  // Lanes holding a pixel that hasn't retired yet, one bit per lane.
+  unsigned int occupied{0};
+  std::size_t next{0};
+
+  while (true) {
+    if (next < count) {
+      const std::size_t free_lanes =
+          S::lanes - static_cast<std::size_t>(std::popcount(occupied));
+      const std::size_t loaded = std::min(free_lanes, count - next);
+      const unsigned int refill = lowestLanes(~occupied & all_lanes, loaded);
+      const Mask refill_mask = S::mask_from_bits(refill);
+
+      const auto [new_real, new_imag] = queue.map(next, loaded);
+
+      c_real = S::expand(c_real, refill, new_real);
+      c_imag = S::expand(c_imag, refill, new_imag);
+      positions = S::count_expand(
+          positions, refill,
+          S::count_add(S::count_set1(next), S::count_lane_offsets()));
+
+      if constexpr (Queue::resumes) {
+        const auto [start_real, start_imag, start_iters] =
+            queue.start(next, loaded);
+
+        z_real = S::expand(z_real, refill, start_real);
+        z_imag = S::expand(z_imag, refill, start_imag);
+        iter_counts = S::count_expand(iter_counts, refill, start_iters);
+      } else {
+        z_real = S::mask_andnot(refill_mask, z_real);
+        z_imag = S::mask_andnot(refill_mask, z_imag);
+        iter_counts =
+            S::count_blend(iter_counts, S::count_zero(), refill_mask);
+      }
+
+      if constexpr (InteriorDetection) {
+        z_real_saved = S::blend(z_real_saved, z_real, refill_mask);
+        z_imag_saved = S::blend(z_imag_saved, z_imag, refill_mask);
+        save_at = S::count_blend(
+            save_at, S::count_add(iter_counts, S::count_set1(1)), refill_mask);
+
+        // Points within the main cardioid or period-2 bulb retire right away.
+        const Mask interior = S::mask_and(
+            refill_mask, utility::avx::isInMainCardioidOrBulb(c_real, c_imag));
+        iter_counts = S::count_blend(iter_counts, max_iterations, interior);
+      }
+
+      occupied |= refill;
+      next += loaded;
+    }
+
+    if (occupied == 0) {
+      return;
+    }
+
+    // Keep lanes without a pixel from drifting off to infinity.
+    const Mask occupied_mask = S::mask_from_bits(occupied);
+    c_real = S::mask_and(occupied_mask, c_real);
+    c_imag = S::mask_and(occupied_mask, c_imag);
+    z_real = S::mask_and(occupied_mask, z_real);
+    z_imag = S::mask_and(occupied_mask, z_imag);
+
+    unsigned int retired;
 
-        const __m256i iter_inc = _mm256_castps_si256(active);
+    while (true) {
+      const Vec norm = utility::avx::norm(z_real, z_imag);
 
-        // Only update the iteration count for active pixels.
-        iter_counts = _mm256_add_epi32(
-            iter_counts, _mm256_and_si256(iter_inc, _mm256_set1_epi32(1)));
+      // A pixel retires when it escapes or reaches the maximum iterations.
+      const Mask active =
+          S::mask_andnot(S::count_cmp_eq(iter_counts, max_iterations),
+                         S::cmp_le(norm, bailout));
+      retired = occupied & ~S::mask_bits(active);
 
-        // Calculate the new real parts.
-        const __m256 z_real_new =
-            _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(z_real, z_real),
-                                        _mm256_mul_ps(z_imag, z_imag)),
-                          c_real);
+      if (retired != 0) {
+        break;
+      }
+
+      // Every occupied lane is active, so no blending is needed.
+      iter_counts = S::count_add(iter_counts, S::count_set1(1));
+
+      step<T>(c_real, c_imag, z_real, z_imag);
+
+      if constexpr (InteriorDetection) {
+        // Periodic lanes reach the maximum iterations, so that they retire at
+        // the next check with their current z-value.
+        const Mask periodic = S::mask_and(
+            occupied_mask, S::mask_and(S::cmp_eq(z_real, z_real_saved),
+                                       S::cmp_eq(z_imag, z_imag_saved)));
+        iter_counts = S::count_blend(iter_counts, max_iterations, periodic);
+
+        const Mask save = S::count_cmp_eq(iter_counts, save_at);
+        z_real_saved = S::blend(z_real_saved, z_real, save);
+        z_imag_saved = S::blend(z_imag_saved, z_imag, save);
+        save_at = S::count_add(save_at, S::count_mask_and(save, save_at));
+      }
+    }
+
+    alignas(backend::AVX2::alignment) typename S::CountElement
+        lane_positions[S::lanes];
+    alignas(backend::AVX2::alignment) typename S::CountElement
+        lane_iters[S::lanes];
+    alignas(backend::AVX2::alignment) T lane_real[S::lanes];
+    alignas(backend::AVX2::alignment) T lane_imag[S::lanes];
+
+    S::count_store(lane_positions, positions);
+    S::count_store(lane_iters, iter_counts);
+    S::store(lane_real, z_real);
+    S::store(lane_imag, z_imag);
+
+    for (unsigned int lanes_left = retired; lanes_left != 0;
+         lanes_left &= lanes_left - 1) {
+      const int lane = std::countr_zero(lanes_left);
+      const std::size_t offset =
+          queue.offset(static_cast<std::size_t>(lane_positions[lane]));
+
+      storePixel(out, offset, static_cast<unsigned int>(lane_iters[lane]),
+                 lane_real[lane], lane_imag[lane], params.max_iterations);
+    }
+
+    occupied &= ~retired;
+  }
+}
+
+/*
+ * The registers of the vectors that the interleaved kernels iterate together.
+ *
+ * They are plain arrays rather than `std::array`s, as GCC drops the attributes
+ * of vector types that are passed as template arguments, and warns about it.
+ */
+template <Scalar T, std::size_t Vectors> struct VectorGroup {
+  using S = Simd<T>;
+
+  typename S::Vec c_real[Vectors];
+  typename S::Vec c_imag[Vectors];
+  typename S::Vec z_real[Vectors];
+  typename S::Vec z_imag[Vectors];
+  typename S::Mask retired[Vectors];
+  typename S::Count iter_counts[Vectors];
+};
+
+/*
+ * Iterate several independent vectors of points together until they escape
+ * or reach the maximum iterations.
+ *
+ * Every lane iterates without masks or counters for `CheckInterval`
+ * iterations, interleaving the vectors so that each one hides the latency of
+ * the others. A vector in which a lane escaped during the interval is then
+ * rolled back to the start of the interval, and repeats it one iteration at a
+ * time as the block kernel does. An escaped orbit only grows, so a lane that
+ * is still within the escape radius at the end of an interval was within it
+ * throughout.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param group The vectors, with their points and the lanes without a point
+ * set. The final z-values and iteration counts are stored into it.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval>
+void iterateInterleaved(const KernelParams& params,
+                        VectorGroup<T, Vectors>& group) {
+  using S = Simd<T>;
+  using Vec = typename S::Vec;
+  using Mask = typename S::Mask;
+
+  const auto& c_real = group.c_real;
+  const auto& c_imag = group.c_imag;
+  auto& z_real = group.z_real;
+  auto& z_imag = group.z_imag;
+  auto& retired = group.retired;
+  auto& iter_counts = group.iter_counts;
 
-        // Calculate the new imaginary parts.
-        const __m256 z_imag_new =
-            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(z_real, z_imag),
-                                        _mm256_mul_ps(z_real, z_imag)),
-                          c_imag);
+  constexpr unsigned int all_lanes = (1u << S::lanes) - 1;
 
-        // Only update the real and imaginary parts for active pixels.
-        z_real = _mm256_blendv_ps(z_real, z_real_new, active);
-        z_imag = _mm256_blendv_ps(z_imag, z_imag_new, active);
+  const Mask all = S::mask_from_bits(all_lanes);
+  const Vec bailout = S::set1(static_cast<T>(params.bailout_norm));
+
+  unroll<Vectors>([&](const auto v) {
+    z_real[v] = S::zero();
+    z_imag[v] = S::zero();
+    iter_counts[v] = S::count_zero();
+  });
+
+  const auto step_all = [&](auto) {
+    unroll<Vectors>([&](const auto v) {
+      step<T>(c_real[v], c_imag[v], z_real[v], z_imag[v]);
+    });
+  };
+
+  for (unsigned int i = 0; i < params.max_iterations;) {
+    const unsigned int steps =
+        std::min(CheckInterval, params.max_iterations - i);
+    Vec start_real[Vectors];
+    Vec start_imag[Vectors];
+
+    unroll<Vectors>([&](const auto v) {
+      start_real[v] = z_real[v];
+      start_imag[v] = z_imag[v];
+    });
+
+    if (steps == CheckInterval) {
+      unroll<CheckInterval>(step_all);
+    } else {
+      for (unsigned int j = 0; j < steps; ++j) {
+        step_all(j);
       }
+    }
+
+    i += steps;
+    bool finished = true;
 
-      const std::size_t base_idx = row * m_width + col;
-      const std::size_t remaining = std::min(lanes, m_width - col);
+    unroll<Vectors>([&](const auto v) {
+      const Mask inside =
+          S::cmp_le(utility::avx::norm(z_real[v], z_imag[v]), bailout);
 
-      if (remaining == lanes) {
-        _mm256_store_si256(
-            reinterpret_cast<__m256i*>(&m_host.iterations[base_idx]),
-            iter_counts);
-        _mm256_store_ps(&m_host.z_reals[base_idx], z_real);
-        _mm256_store_ps(&m_host.z_imags[base_idx], z_imag);
+      if (S::mask_bits(S::mask_or(retired[v], inside)) == all_lanes) {
+        // Retired lanes keep the z-value they retired with.
+        z_real[v] = S::blend(z_real[v], start_real[v], retired[v]);
+        z_imag[v] = S::blend(z_imag[v], start_imag[v], retired[v]);
+        iter_counts[v] = S::count_blend(
+            S::count_add(iter_counts[v], S::count_set1(steps)),
+            iter_counts[v], retired[v]);
       } else {
-        // AVX2 doesn't have masked stores so we have to manually copy the
-        // remaining elements if it doesn't fit perfectly in a lane.
-        alignas(backend::AVX2::alignment) int lane_iters[lanes];
-        alignas(backend::AVX2::alignment) float lane_real[lanes];
-        alignas(backend::AVX2::alignment) float lane_imag[lanes];
-
-        _mm256_store_si256(reinterpret_cast<__m256i*>(lane_iters), iter_counts);
-        _mm256_store_ps(lane_real, z_real);
-        _mm256_store_ps(lane_imag, z_imag);
-
-        for (std::size_t i = 0; i < std::min(lanes, m_width - col); ++i) {
-          m_host.iterations[base_idx + i] =
-              static_cast<unsigned int>(lane_iters[i]);
-          m_host.z_reals[base_idx + i] = lane_real[i];
-          m_host.z_imags[base_idx + i] = lane_imag[i];
+        z_real[v] = start_real[v];
+        z_imag[v] = start_imag[v];
+
+        for (unsigned int j = 0; j < steps; ++j) {
+          const Mask active = S::mask_andnot(
+              retired[v], S::cmp_le(utility::avx::norm(z_real[v], z_imag[v]),
+                                    bailout));
+          retired[v] = S::mask_andnot(active, all);
+
+          if (S::mask_bits(active) == 0) {
+            break;
+          }
+
+          iter_counts[v] = S::count_add(
+              iter_counts[v], S::count_mask_and(active, S::count_set1(1)));
+
+          Vec z_real_new = z_real[v];
+          Vec z_imag_new = z_imag[v];
+          step<T>(c_real[v], c_imag[v], z_real_new, z_imag_new);
+
+          z_real[v] = S::blend(z_real[v], z_real_new, active);
+          z_imag[v] = S::blend(z_imag[v], z_imag_new, active);
         }
       }
+
+      finished = finished && S::mask_bits(retired[v]) == all_lanes;
+    });
+
+    if (finished) {
+      break;
+    }
+  }
+}
+
+/*
+ * Compute consecutive pixels in the same row, several vectors at a time.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors iterated together.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval,
+          Channels C>
+void computeInterleaved(const KernelParams& params, const std::size_t row,
+                        const std::size_t col, const std::size_t count,
+                        const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  constexpr unsigned int all_lanes = (1u << S::lanes) - 1;
+
+  for (std::size_t offset = 0; offset < count; offset += Vectors * S::lanes) {
+    VectorGroup<T, Vectors> group;
+    std::array<std::size_t, Vectors> pixels;
+
+    unroll<Vectors>([&](const auto v) {
+      const std::size_t first = offset + v * S::lanes;
+      pixels[v] = first < count ? std::min(S::lanes, count - first) : 0;
+
+      const auto [c_real, c_imag] = mapPixels<T>(params, row, col + first);
+      group.c_real[v] = c_real;
+      group.c_imag[v] = c_imag;
+      group.retired[v] =
+          S::mask_from_bits(all_lanes & ~((1u << pixels[v]) - 1));
+    });
+
+    iterateInterleaved<T, Vectors, CheckInterval>(params, group);
+
+    unroll<Vectors>([&](const auto v) {
+      if (pixels[v] != 0) {
+        storeBlock(pixels[v], group.iter_counts[v], group.z_real[v],
+                   group.z_imag[v], params.max_iterations,
+                   out.at(offset + v * S::lanes));
+      }
+    });
+  }
+}
+
+/*
+ * Compute arbitrary pixels, several vectors at a time.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors iterated together.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval,
+          Channels C>
+void computeInterleaved(const KernelParams& params,
+                        const std::size_t* indices, const std::size_t count,
+                        const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  constexpr unsigned int all_lanes = (1u << S::lanes) - 1;
+
+  for (std::size_t offset = 0; offset < count; offset += Vectors * S::lanes) {
+    VectorGroup<T, Vectors> group;
+    std::array<std::size_t, Vectors> pixels;
+
+    unroll<Vectors>([&](const auto v) {
+      const std::size_t first = offset + v * S::lanes;
+      pixels[v] = first < count ? std::min(S::lanes, count - first) : 0;
+
+      group.retired[v] =
+          S::mask_from_bits(all_lanes & ~((1u << pixels[v]) - 1));
+
+      if (pixels[v] != 0) {
+        const auto [c_real, c_imag] =
+            mapPixels<T>(params, indices + first, pixels[v]);
+        group.c_real[v] = c_real;
+        group.c_imag[v] = c_imag;
+      } else {
+        group.c_real[v] = S::zero();
+        group.c_imag[v] = S::zero();
+      }
+    });
+
+    iterateInterleaved<T, Vectors, CheckInterval>(params, group);
+
+    unroll<Vectors>([&](const auto v) {
+      if (pixels[v] != 0) {
+        storeList(indices + offset + v * S::lanes, pixels[v],
+                  group.iter_counts[v], group.z_real[v], group.z_imag[v],
+                  params.max_iterations, out);
+      }
+    });
+  }
+}
+
+/*
+ * Evaluate the series approximation of the differences to the reference orbit
+ * with Horner's method.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param u_real The real parts of the offsets divided by the series scale.
+ * @param u_imag The imaginary parts of the offsets divided by the series
+ * scale.
+ * @param dz_real The real parts of the differences.
+ * @param dz_imag The imaginary parts of the differences.
+ */
+template <Scalar T>
+void evaluateSeries(const PerturbationParams<T>& params,
+                    const typename Simd<T>::Vec u_real,
+                    const typename Simd<T>::Vec u_imag,
+                    typename Simd<T>::Vec& dz_real,
+                    typename Simd<T>::Vec& dz_imag) {
+  using S = Simd<T>;
+
+  dz_real = S::zero();
+  dz_imag = S::zero();
+
+  for (std::size_t k = params.series_terms; k-- > 0;) {
+    const typename S::Vec a_real =
+        S::add(dz_real, S::set1(params.series_reals[k]));
+    const typename S::Vec a_imag =
+        S::add(dz_imag, S::set1(params.series_imags[k]));
+
+    dz_real = S::sub(S::mul(a_real, u_real), S::mul(a_imag, u_imag));
+    dz_imag = S::add(S::mul(a_real, u_imag), S::mul(a_imag, u_real));
+  }
+}
+
+/*
+ * Compute up to one vector of consecutive pixels in the same row by perturbing
+ * a reference orbit.
+ *
+ * Each lane tracks its own position in the reference orbit, as lanes are
+ * rebased independently. See `iteratePerturbed` in mandelbrot_serial.cpp for
+ * the rebasing condition.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T>
+void computePerturbedBlock(const PerturbationParams<T>& params,
+                           const std::size_t row, const std::size_t col,
+                           const std::size_t count,
+                           const KernelOutput<T>& out) {
+  using S = Simd<T>;
+  using Vec = typename S::Vec;
+  using Count = typename S::Count;
+  using Mask = typename S::Mask;
+
+  // The offsets are computed in double precision before rounding them, so that
+  // single precision kernels don't lose the position of the pixels.
+  alignas(backend::AVX2::alignment) T lane_dc[S::lanes];
+  alignas(backend::AVX2::alignment) T lane_u[S::lanes];
+
+  for (std::size_t i = 0; i < S::lanes; ++i) {
+    const double dc =
+        params.real_offset + static_cast<double>(col + i) * params.step;
+
+    lane_dc[i] = static_cast<T>(dc);
+    lane_u[i] = static_cast<T>(dc / params.series_scale);
+  }
+
+  const double dc_imag_offset =
+      params.imag_offset - static_cast<double>(row) * params.step;
+
+  const Vec dc_real = S::load(lane_dc);
+  const Vec dc_imag = S::set1(static_cast<T>(dc_imag_offset));
+
+  // Start after the skipped iterations, as given by the series.
+  Vec dz_real, dz_imag;
+  evaluateSeries<T>(params, S::load(lane_u),
+                    S::set1(static_cast<T>(dc_imag_offset /
+                                           params.series_scale)),
+                    dz_real, dz_imag);
+
+  const std::size_t skipped = params.skipped_iterations;
+
+  // The reference point at the position of each lane.
+  Vec ref_real = S::set1(params.orbit_reals[skipped]);
+  Vec ref_imag = S::set1(params.orbit_imags[skipped]);
+
+  Vec z_real = S::add(ref_real, dz_real);
+  Vec z_imag = S::add(ref_imag, dz_imag);
+  Count iter_counts = S::count_set1(skipped);
+
+  // The position of each lane in the reference orbit.
+  Count n = S::count_set1(skipped);
+
+  const Count one = S::count_set1(1);
+  const Count last = S::count_set1(params.orbit_length - 1);
+  const Vec bailout = S::set1(static_cast<T>(params.bailout_norm));
+
+  Mask active = S::mask_from_bits(~0u);
+
+  for (unsigned int i = params.skipped_iterations; i < params.max_iterations;
+       ++i) {
+    // dz = (2 * Z + dz) * dz + dc
+    const Vec a_real = S::add(S::add(ref_real, ref_real), dz_real);
+    const Vec a_imag = S::add(S::add(ref_imag, ref_imag), dz_imag);
+
+    const Vec dz_real_new = S::add(
+        S::sub(S::mul(a_real, dz_real), S::mul(a_imag, dz_imag)), dc_real);
+    const Vec dz_imag_new = S::add(
+        S::add(S::mul(a_real, dz_imag), S::mul(a_imag, dz_real)), dc_imag);
+
+    dz_real = S::blend(dz_real, dz_real_new, active);
+    dz_imag = S::blend(dz_imag, dz_imag_new, active);
+    n = S::count_add(n, S::count_mask_and(active, one));
+    iter_counts = S::count_add(iter_counts, S::count_mask_and(active, one));
+
+    // Lanes that are no longer active keep their position, so that they can
+    // load their reference point as well.
+    ref_real = S::gather(params.orbit_reals, n);
+    ref_imag = S::gather(params.orbit_imags, n);
+
+    z_real = S::blend(z_real, S::add(ref_real, dz_real), active);
+    z_imag = S::blend(z_imag, S::add(ref_imag, dz_imag), active);
+
+    const Vec norm = utility::avx::norm(z_real, z_imag);
+
+    // Check which pixels have not escaped yet.
+    active = S::mask_and(active, S::cmp_le(norm, bailout));
+
+    // If all pixels have escaped, stop early.
+    if (S::mask_bits(active) == 0) {
+      break;
+    }
+
+    const Mask rebase = S::mask_and(
+        active,
+        S::mask_or(S::cmp_lt(norm, utility::avx::norm(dz_real, dz_imag)),
+                   S::count_cmp_eq(n, last)));
+
+    // Rebasing is rare, so keep it off the dependency chain of the iteration.
+    if (S::mask_bits(rebase) != 0) {
+      dz_real = S::blend(dz_real, z_real, rebase);
+      dz_imag = S::blend(dz_imag, z_imag, rebase);
+      ref_real = S::mask_andnot(rebase, ref_real);
+      ref_imag = S::mask_andnot(rebase, ref_imag);
+      n = S::count_blend(n, S::count_zero(), rebase);
+    }
+  }
+
+  storeBlock(count, iter_counts, z_real, z_imag, params.max_iterations, out);
+}
+} // namespace
+
+/*
+ * Compute the Mandelbrot set for a run of pixels with AVX2 acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX2, T, C>::compute(const KernelParams& params,
+                                          std::size_t row, std::size_t col,
+                                          std::size_t count,
+                                          const KernelOutput<T, C>& out) {
+  // Only the block variant tracks the derivatives, see `channels::Distance`.
+  if constexpr (!C::distance) {
+    if (params.variant == KernelVariant::Interleaved &&
+        !params.interior_detection) {
+      withInterleaving(params.interleaving, [&]<std::size_t Vectors,
+                                                unsigned int CheckInterval>() {
+        computeInterleaved<T, Vectors, CheckInterval>(params, row, col, count,
+                                                      out);
+      });
+
+      return;
+    }
+
+    if (params.variant == KernelVariant::LaneRefill) {
+      const RunQueue<T> queue{params, row, col};
+
+      if (params.interior_detection) {
+        computeRefill<T, true>(params, queue, count, out);
+      } else {
+        computeRefill<T, false>(params, queue, count, out);
+      }
+
+      return;
+    }
+  }
+
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    const std::size_t block = std::min(lanes, count - offset);
+
+    if (params.interior_detection) {
+      computeBlock<T, true>(params, row, col + offset, block, out.at(offset));
+    } else {
+      computeBlock<T, false>(params, row, col + offset, block,
+                             out.at(offset));
+    }
+  }
+}
+
+/*
+ * Compute the Mandelbrot set for a list of pixels with AVX2 acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX2, T, C>::compute(const KernelParams& params,
+                                          const std::size_t* indices,
+                                          std::size_t count,
+                                          const KernelOutput<T, C>& out) {
+  // Only the block variant tracks the derivatives, see `channels::Distance`.
+  if constexpr (!C::distance) {
+    if (params.variant == KernelVariant::Interleaved &&
+        !params.interior_detection) {
+      withInterleaving(params.interleaving, [&]<std::size_t Vectors,
+                                                unsigned int CheckInterval>() {
+        computeInterleaved<T, Vectors, CheckInterval>(params, indices, count,
+                                                      out);
+      });
+
+      return;
+    }
+
+    if (params.variant == KernelVariant::LaneRefill) {
+      const ListQueue<T> queue{params, indices};
+
+      if (params.interior_detection) {
+        computeRefill<T, true>(params, queue, count, out);
+      } else {
+        computeRefill<T, false>(params, queue, count, out);
+      }
+
+      return;
     }
   }
 
-  return {m_host, m_width, m_height};
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    const std::size_t block = std::min(lanes, count - offset);
+
+    if (params.interior_detection) {
+      computeBlock<T, true>(params, indices + offset, block, out);
+    } else {
+      computeBlock<T, false>(params, indices + offset, block, out);
+    }
+  }
 }
 
+/*
+ * Continue computing the Mandelbrot set for a list of pixels with AVX2
+ * acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX2, T, C>::resume(const KernelParams& params,
+                                         const std::size_t* indices,
+                                         std::size_t count,
+                                         const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  const ResumeQueue<T> queue{params, indices, out};
+
+  if (params.interior_detection) {
+    computeRefill<T, true>(params, queue, count, out);
+  } else {
+    computeRefill<T, false>(params, queue, count, out);
+  }
+}
+
+/*
+ * Compute the Mandelbrot set for a run of pixels by perturbation with AVX2
+ * acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX2, T, C>::compute(const PerturbationParams<T>& params,
+                                          std::size_t row, std::size_t col,
+                                          std::size_t count,
+                                          const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    computePerturbedBlock(params, row, col + offset,
+                          std::min(lanes, count - offset), out.at(offset));
+  }
+}
+
+template struct Kernel<backend::AVX2, float>;
+template struct Kernel<backend::AVX2, double>;
+
+template struct Kernel<backend::AVX2, float, channels::Iterations>;
+template struct Kernel<backend::AVX2, double, channels::Iterations>;
+template struct Kernel<backend::AVX2, float, channels::Iterations16>;
+template struct Kernel<backend::AVX2, double, channels::Iterations16>;
+template struct Kernel<backend::AVX2, float, channels::Smooth>;
+template struct Kernel<backend::AVX2, double, channels::Smooth>;
+template struct Kernel<backend::AVX2, float, channels::Distance>;
+template struct Kernel<backend::AVX2, double, channels::Distance>;
+
 #endif
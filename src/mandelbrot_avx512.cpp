@@ -4,77 +4,1490 @@
 
 #if defined(MANDELBROT_HAS_AVX512)
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
 #include <immintrin.h>
 
 #include "backends.hpp"
-#include "mandelbrot_engine.hpp"
+#include "kernels.hpp"
 #include "utility.hpp"
+#include "vector_math.hpp"
+
+namespace {
+/*
+ * The AVX512 instructions for a scalar type, so that the kernels can be
+ * written once for both single and double precision.
+ *
+ * Iteration counts are kept in lanes of the same width as the scalar type, so
+ * that the same mask applies to both.
+ */
+template <Scalar T> struct Simd;
+
+template <> struct Simd<float> {
+  using Vec = __m512;
+  using Count = __m512i;
+  using CountElement = std::int32_t;
+  using Mask = __mmask16;
+
+  static constexpr std::size_t lanes = Kernel<backend::AVX512, float>::lanes;
+
+  static Vec zero() { return _mm512_setzero_ps(); }
+  static Vec set1(const float a) { return _mm512_set1_ps(a); }
+  static Vec add(const Vec a, const Vec b) { return _mm512_add_ps(a, b); }
+  static Vec sub(const Vec a, const Vec b) { return _mm512_sub_ps(a, b); }
+  static Vec mul(const Vec a, const Vec b) { return _mm512_mul_ps(a, b); }
+  static Vec fmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  static Vec fnmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm512_fnmadd_ps(a, b, c);
+  }
+
+  static Mask cmp_le(const Vec a, const Vec b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_LE_OS);
+  }
+  static Mask mask_cmp_eq(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_cmpeq_ps_mask(k, a, b);
+  }
+  static Mask mask_cmp_le(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_cmp_ps_mask(k, a, b, _CMP_LE_OS);
+  }
+  static Mask mask_cmp_lt(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_cmp_ps_mask(k, a, b, _CMP_LT_OS);
+  }
+
+  static Vec blend(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_blend_ps(k, a, b);
+  }
+  static Vec mask_mov(const Vec src, const Mask k, const Vec a) {
+    return _mm512_mask_mov_ps(src, k, a);
+  }
+  static Vec maskz_mov(const Mask k, const Vec a) {
+    return _mm512_maskz_mov_ps(k, a);
+  }
+  static Vec mask_expand(const Vec src, const Mask k, const Vec a) {
+    return _mm512_mask_expand_ps(src, k, a);
+  }
+
+  static Vec load(const float* src) { return _mm512_load_ps(src); }
+  static Vec gather(const float* base, const Count idx) {
+    // The unmasked gather trips -Wmaybe-uninitialized in GCC's headers.
+    return _mm512_mask_i32gather_ps(zero(), 0xFFFF, idx, base, 4);
+  }
+
+  static void store(float* dst, const Vec a) { _mm512_store_ps(dst, a); }
+  static void mask_storeu(float* dst, const Mask k, const Vec a) {
+    _mm512_mask_storeu_ps(dst, k, a);
+  }
+  static void mask_compressstoreu(float* dst, const Mask k, const Vec a) {
+    _mm512_mask_compressstoreu_ps(dst, k, a);
+  }
+
+  static Count count_zero() { return _mm512_setzero_epi32(); }
+  static Count count_set1(const std::size_t a) {
+    return _mm512_set1_epi32(static_cast<int>(a));
+  }
+  static Count count_lane_offsets() {
+    return _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+                            0);
+  }
+  static Count count_add(const Count a, const Count b) {
+    return _mm512_add_epi32(a, b);
+  }
+  static Count count_mask_add(const Count src, const Mask k, const Count a,
+                              const Count b) {
+    return _mm512_mask_add_epi32(src, k, a, b);
+  }
+  static Count count_mask_mov(const Count src, const Mask k, const Count a) {
+    return _mm512_mask_mov_epi32(src, k, a);
+  }
+  static Count count_mask_expand(const Count src, const Mask k,
+                                 const Count a) {
+    return _mm512_mask_expand_epi32(src, k, a);
+  }
+  static Count count_mask_double(const Count src, const Mask k) {
+    return _mm512_mask_slli_epi32(src, k, src, 1);
+  }
+  static Mask count_cmp_eq(const Count a, const Count b) {
+    return _mm512_cmpeq_epi32_mask(a, b);
+  }
+  static Mask count_mask_cmp_neq(const Mask k, const Count a, const Count b) {
+    return _mm512_mask_cmpneq_epi32_mask(k, a, b);
+  }
+  static Mask count_mask_cmp_eq(const Mask k, const Count a, const Count b) {
+    return _mm512_mask_cmpeq_epi32_mask(k, a, b);
+  }
+
+  static Count count_load(const std::int32_t* src) {
+    return _mm512_load_epi32(src);
+  }
+  static void count_store(std::int32_t* dst, const Count a) {
+    _mm512_store_epi32(dst, a);
+  }
+  static void count_mask_storeu(unsigned int* dst, const Mask k,
+                                const Count a) {
+    _mm512_mask_storeu_epi32(dst, k, a);
+  }
+  static void count_mask_storeu(std::uint16_t* dst, const Mask k,
+                                const Count a) {
+    // Narrow the counts to 16 bits while storing them.
+    _mm512_mask_cvtepi32_storeu_epi16(dst, k, a);
+  }
+  static void count_mask_compressstoreu(std::int32_t* dst, const Mask k,
+                                        const Count a) {
+    _mm512_mask_compressstoreu_epi32(dst, k, a);
+  }
+
+  static void smooth_mask_storeu(float* dst, const Mask k, const Count a,
+                                 const Vec norm,
+                                 const unsigned int max_iterations) {
+    _mm512_mask_storeu_ps(dst, k,
+                          vector_math::avx512::smoothIterations(
+                              a, norm, max_iterations));
+  }
+};
+
+template <> struct Simd<double> {
+  using Vec = __m512d;
+  using Count = __m512i;
+  using CountElement = std::int64_t;
+  using Mask = __mmask8;
+
+  static constexpr std::size_t lanes = Kernel<backend::AVX512, double>::lanes;
+
+  static Vec zero() { return _mm512_setzero_pd(); }
+  static Vec set1(const double a) { return _mm512_set1_pd(a); }
+  static Vec add(const Vec a, const Vec b) { return _mm512_add_pd(a, b); }
+  static Vec sub(const Vec a, const Vec b) { return _mm512_sub_pd(a, b); }
+  static Vec mul(const Vec a, const Vec b) { return _mm512_mul_pd(a, b); }
+  static Vec fmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm512_fmadd_pd(a, b, c);
+  }
+  static Vec fnmadd(const Vec a, const Vec b, const Vec c) {
+    return _mm512_fnmadd_pd(a, b, c);
+  }
+
+  static Mask cmp_le(const Vec a, const Vec b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_LE_OS);
+  }
+  static Mask mask_cmp_eq(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_cmpeq_pd_mask(k, a, b);
+  }
+  static Mask mask_cmp_le(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_cmp_pd_mask(k, a, b, _CMP_LE_OS);
+  }
+  static Mask mask_cmp_lt(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_cmp_pd_mask(k, a, b, _CMP_LT_OS);
+  }
+
+  static Vec blend(const Mask k, const Vec a, const Vec b) {
+    return _mm512_mask_blend_pd(k, a, b);
+  }
+  static Vec mask_mov(const Vec src, const Mask k, const Vec a) {
+    return _mm512_mask_mov_pd(src, k, a);
+  }
+  static Vec maskz_mov(const Mask k, const Vec a) {
+    return _mm512_maskz_mov_pd(k, a);
+  }
+  static Vec mask_expand(const Vec src, const Mask k, const Vec a) {
+    return _mm512_mask_expand_pd(src, k, a);
+  }
+
+  static Vec load(const double* src) { return _mm512_load_pd(src); }
+  static Vec gather(const double* base, const Count idx) {
+    return _mm512_mask_i64gather_pd(zero(), 0xFF, idx, base, 8);
+  }
+
+  static void store(double* dst, const Vec a) { _mm512_store_pd(dst, a); }
+  static void mask_storeu(double* dst, const Mask k, const Vec a) {
+    _mm512_mask_storeu_pd(dst, k, a);
+  }
+  static void mask_compressstoreu(double* dst, const Mask k, const Vec a) {
+    _mm512_mask_compressstoreu_pd(dst, k, a);
+  }
+
+  static Count count_zero() { return _mm512_setzero_si512(); }
+  static Count count_set1(const std::size_t a) {
+    return _mm512_set1_epi64(static_cast<long long>(a));
+  }
+  static Count count_lane_offsets() {
+    return _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+  }
+  static Count count_add(const Count a, const Count b) {
+    return _mm512_add_epi64(a, b);
+  }
+  static Count count_mask_add(const Count src, const Mask k, const Count a,
+                              const Count b) {
+    return _mm512_mask_add_epi64(src, k, a, b);
+  }
+  static Count count_mask_mov(const Count src, const Mask k, const Count a) {
+    return _mm512_mask_mov_epi64(src, k, a);
+  }
+  static Count count_mask_expand(const Count src, const Mask k,
+                                 const Count a) {
+    return _mm512_mask_expand_epi64(src, k, a);
+  }
+  static Count count_mask_double(const Count src, const Mask k) {
+    return _mm512_mask_slli_epi64(src, k, src, 1);
+  }
+  static Mask count_cmp_eq(const Count a, const Count b) {
+    return _mm512_cmpeq_epi64_mask(a, b);
+  }
+  static Mask count_mask_cmp_neq(const Mask k, const Count a, const Count b) {
+    return _mm512_mask_cmpneq_epi64_mask(k, a, b);
+  }
+  static Mask count_mask_cmp_eq(const Mask k, const Count a, const Count b) {
+    return _mm512_mask_cmpeq_epi64_mask(k, a, b);
+  }
+
+  static Count count_load(const std::int64_t* src) {
+    return _mm512_load_epi64(src);
+  }
+  static void count_store(std::int64_t* dst, const Count a) {
+    _mm512_store_epi64(dst, a);
+  }
+  static void count_mask_storeu(unsigned int* dst, const Mask k,
+                                const Count a) {
+    // Narrow the counts to 32 bits while storing them.
+    _mm512_mask_cvtepi64_storeu_epi32(dst, k, a);
+  }
+  static void count_mask_storeu(std::uint16_t* dst, const Mask k,
+                                const Count a) {
+    // Narrow the counts to 16 bits while storing them.
+    _mm512_mask_cvtepi64_storeu_epi16(dst, k, a);
+  }
+  static void count_mask_compressstoreu(std::int64_t* dst, const Mask k,
+                                        const Count a) {
+    _mm512_mask_compressstoreu_epi64(dst, k, a);
+  }
+
+  static void smooth_mask_storeu(float* dst, const Mask k, const Count a,
+                                 const Vec norm,
+                                 const unsigned int max_iterations) {
+    // Narrow the counts to 32 bits and the norms to `float`, which holds the
+    // norms of escaped pixels. Eight lanes only need AVX2. The unmasked
+    // conversions trip -Wuninitialized in GCC's headers.
+    const __m256 smooth = vector_math::avx2::smoothIterations(
+        _mm512_maskz_cvtepi64_epi32(0xFF, a), _mm512_maskz_cvtpd_ps(0xFF, norm),
+        max_iterations);
+
+    _mm512_mask_storeu_ps(dst, k,
+                          _mm512_castpd_ps(_mm512_maskz_insertf64x4(
+                              0xFF, _mm512_setzero_pd(),
+                              _mm256_castps_pd(smooth), 0)));
+  }
+};
+
+/*
+ * Map pixels onto the complex plane in the precision of the kernel.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param args The pixels, as accepted by
+ * `utility::avx512::mapPixelsToComplexPlane`.
+ *
+ * @returns The mapped positions of the pixels on the complex plane.
+ */
+template <Scalar T, typename... Args>
+auto mapPixels(const KernelParams& params, const Args... args) {
+  return utility::avx512::mapPixelsToComplexPlane(
+      args..., params.width, params.height,
+      static_cast<T>(params.bounds.real_min),
+      static_cast<T>(params.bounds.real_max),
+      static_cast<T>(params.bounds.imag_min),
+      static_cast<T>(params.bounds.imag_max));
+}
+
+/*
+ * Advance a vector of points by one iteration, with fused multiply-adds.
+ *
+ * Every kernel iterates with it. The fused multiply-adds are explicit, so the
+ * compiler can neither contract nor reassociate the iteration differently
+ * from one kernel to the next, and the kernels round alike.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param z_real The real parts of the z-values.
+ * @param z_imag The imaginary parts of the z-values.
+ */
+template <Scalar T>
+void step(const typename Simd<T>::Vec c_real,
+          const typename Simd<T>::Vec c_imag, typename Simd<T>::Vec& z_real,
+          typename Simd<T>::Vec& z_imag) {
+  using S = Simd<T>;
+
+  // z_real^2 - z_imag^2 + c_real and 2 * z_real * z_imag + c_imag.
+  const typename S::Vec z_real_new =
+      S::fmadd(z_real, z_real, S::fnmadd(z_imag, z_imag, c_real));
+  z_imag = S::fmadd(S::add(z_real, z_real), z_imag, c_imag);
+  z_real = z_real_new;
+}
+
+/*
+ * Iterate a vector of points until they escape or reach the maximum
+ * iterations.
+ *
+ * With interior detection enabled, lanes within the main cardioid or period-2
+ * bulb are retired before iterating, and the orbits are checked for
+ * periodicity using Brent's method. A lane whose orbit repeats exactly is
+ * retired as interior, keeping its z-value at the time of detection.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Derivative Whether to track the derivatives of the orbits.
+ *
+ * @param params The parameters of the computation.
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param dz_real The real parts of the final derivatives, if tracked.
+ * @param dz_imag The imaginary parts of the final derivatives, if tracked.
+ *
+ * @returns The iteration counts.
+ */
+template <Scalar T, bool InteriorDetection, bool Derivative = false>
+typename Simd<T>::Count
+iterate(const KernelParams& params, const typename Simd<T>::Vec c_real,
+        const typename Simd<T>::Vec c_imag, typename Simd<T>::Vec& z_real,
+        typename Simd<T>::Vec& z_imag,
+        [[maybe_unused]] typename Simd<T>::Vec* dz_real = nullptr,
+        [[maybe_unused]] typename Simd<T>::Vec* dz_imag = nullptr) {
+  using S = Simd<T>;
+  using Mask = typename S::Mask;
+
+  const typename S::Vec bailout =
+      S::set1(static_cast<T>(params.bailout_norm));
+
+  z_real = S::zero();
+  z_imag = S::zero();
+
+  if constexpr (Derivative) {
+    *dz_real = S::zero();
+    *dz_imag = S::zero();
+  }
+
+  typename S::Count iter_counts = S::count_zero();
+
+  // Lanes that are known to never escape.
+  Mask interior = 0;
+
+  [[maybe_unused]] typename S::Vec z_real_saved = z_real;
+  [[maybe_unused]] typename S::Vec z_imag_saved = z_imag;
+  [[maybe_unused]] unsigned int save_at{1};
+
+  if constexpr (InteriorDetection) {
+    interior = utility::avx512::isInMainCardioidOrBulb(c_real, c_imag);
+  }
+
+  for (unsigned int i = 0; i < params.max_iterations; ++i) {
+    const typename S::Vec norm = utility::avx512::norm(z_real, z_imag);
+
+    // Check which pixels have not escaped yet.
+    Mask active = S::cmp_le(norm, bailout);
+
+    if constexpr (InteriorDetection) {
+      active = static_cast<Mask>(~interior & active);
+    }
+
+    // If all pixels have escaped, stop early.
+    if (active == 0) {
+      break;
+    }
+
+    iter_counts =
+        S::count_mask_add(iter_counts, active, iter_counts, S::count_set1(1));
+
+    if constexpr (Derivative) {
+      // dz = 2 * z * dz + 1, from the z-values before this iteration.
+      const typename S::Vec z_real_2 = S::add(z_real, z_real);
+      const typename S::Vec z_imag_2 = S::add(z_imag, z_imag);
+      const typename S::Vec dz_real_new = S::fmadd(
+          z_real_2, *dz_real, S::fnmadd(z_imag_2, *dz_imag, S::set1(T{1})));
+      const typename S::Vec dz_imag_new =
+          S::fmadd(z_real_2, *dz_imag, S::mul(z_imag_2, *dz_real));
+
+      *dz_real = S::blend(active, *dz_real, dz_real_new);
+      *dz_imag = S::blend(active, *dz_imag, dz_imag_new);
+    }
+
+    typename S::Vec z_real_new = z_real;
+    typename S::Vec z_imag_new = z_imag;
+    step<T>(c_real, c_imag, z_real_new, z_imag_new);
+
+    // Only update the real and imaginary parts for active pixels.
+    z_real = S::blend(active, z_real, z_real_new);
+    z_imag = S::blend(active, z_imag, z_imag_new);
+
+    if constexpr (InteriorDetection) {
+      // An active orbit that returns exactly to its saved point is periodic.
+      const Mask periodic = S::mask_cmp_eq(
+          S::mask_cmp_eq(active, z_real, z_real_saved), z_imag, z_imag_saved);
+      interior = static_cast<Mask>(interior | periodic);
+
+      if (i + 1 == save_at) {
+        z_real_saved = z_real;
+        z_imag_saved = z_imag;
+        save_at <<= 1;
+      }
+    }
+  }
+
+  if constexpr (InteriorDetection) {
+    iter_counts = S::count_mask_mov(iter_counts, interior,
+                                    S::count_set1(params.max_iterations));
+  }
+
+  return iter_counts;
+}
+
+/*
+ * Store the results of up to one vector of consecutive pixels.
+ *
+ * The results are stored with masked stores. The smooth iteration counts need
+ * a logarithm, which AVX512F doesn't have, so they use the vector
+ * approximation in src/vector_math.hpp.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, Channels C>
+void storeBlock(const std::size_t count,
+                const typename Simd<T>::Count iter_counts,
+                const typename Simd<T>::Vec z_real,
+                const typename Simd<T>::Vec z_imag,
+                const unsigned int max_iterations,
+                const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  const auto store_mask = static_cast<typename S::Mask>(
+      (count == S::lanes) ? ~0u : (1u << count) - 1);
+
+  if constexpr (C::iterations) {
+    S::count_mask_storeu(out.iterations, store_mask, iter_counts);
+  }
+
+  if constexpr (C::z) {
+    S::mask_storeu(out.z_reals, store_mask, z_real);
+    S::mask_storeu(out.z_imags, store_mask, z_imag);
+  }
+
+  if constexpr (C::smooth) {
+    S::smooth_mask_storeu(out.smooth, store_mask, iter_counts,
+                          utility::avx512::norm(z_real, z_imag),
+                          max_iterations);
+  }
+}
+
+/*
+ * Store the results of up to one vector of arbitrary pixels.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, Channels C>
+void storeList(const std::size_t* indices, const std::size_t count,
+               const typename Simd<T>::Count iter_counts,
+               const typename Simd<T>::Vec z_real,
+               const typename Simd<T>::Vec z_imag,
+               const unsigned int max_iterations,
+               const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  alignas(backend::AVX512::alignment) typename S::CountElement
+      lane_iters[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_real[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_imag[S::lanes];
+
+  S::count_store(lane_iters, iter_counts);
+  S::store(lane_real, z_real);
+  S::store(lane_imag, z_imag);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, indices[i], static_cast<unsigned int>(lane_iters[i]),
+               lane_real[i], lane_imag[i], max_iterations);
+  }
+}
+
+/*
+ * Store the results of up to one vector of pixels with their distance
+ * estimates, which are computed per lane.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param indices The indices of the pixels, or null for consecutive pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param dz_real The real parts of the final derivatives.
+ * @param dz_imag The imaginary parts of the final derivatives.
+ * @param params The parameters of the computation.
+ * @param out The output, pointing at the first pixel, or at the first pixel of
+ * the image with indices.
+ */
+template <Scalar T, Channels C>
+void storeDistances(const std::size_t* indices, const std::size_t count,
+                    const typename Simd<T>::Count iter_counts,
+                    const typename Simd<T>::Vec z_real,
+                    const typename Simd<T>::Vec z_imag,
+                    const typename Simd<T>::Vec dz_real,
+                    const typename Simd<T>::Vec dz_imag,
+                    const KernelParams& params,
+                    const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  alignas(backend::AVX512::alignment) typename S::CountElement
+      lane_iters[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_real[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_imag[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_dz_real[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_dz_imag[S::lanes];
+
+  S::count_store(lane_iters, iter_counts);
+  S::store(lane_real, z_real);
+  S::store(lane_imag, z_imag);
+  S::store(lane_dz_real, dz_real);
+  S::store(lane_dz_imag, dz_imag);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, indices != nullptr ? indices[i] : i,
+               static_cast<unsigned int>(lane_iters[i]), lane_real[i],
+               lane_imag[i], lane_dz_real[i], lane_dz_imag[i], params);
+  }
+}
 
 /*
- * Compute the Mandelbrot set with AVX512 acceleration.
+ * Compute up to one vector of consecutive pixels in the same row.
  *
- * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel.
  */
-template <>
-MandelbrotResult<backend::AVX512> MandelbrotEngine<backend::AVX512>::compute() {
-  constexpr std::size_t lanes = backend::AVX512::alignment / sizeof(float);
+template <Scalar T, bool InteriorDetection, Channels C>
+void computeBlock(const KernelParams& params, const std::size_t row,
+                  const std::size_t col, const std::size_t count,
+                  const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+
+  const auto [c_real, c_imag] = mapPixels<T>(params, row, col);
 
-  for (std::size_t row = 0; row < m_height; ++row) {
-    for (std::size_t col = 0; col < m_width; col += lanes) {
-      const auto [c_real, c_imag] = utility::avx512::mapPixelsToComplexPlane(
-          row, col, m_width, m_height, m_bounds.real_min, m_bounds.real_max,
-          m_bounds.imag_min, m_bounds.imag_max);
+  typename S::Vec z_real, z_imag;
 
-      __m512 z_real = _mm512_setzero_ps();
-      __m512 z_imag = _mm512_setzero_ps();
+  if constexpr (C::distance) {
+    typename S::Vec dz_real, dz_imag;
+    const typename S::Count iter_counts = iterate<T, InteriorDetection, true>(
+        params, c_real, c_imag, z_real, z_imag, &dz_real, &dz_imag);
 
-      __m512i iter_counts = _mm512_setzero_epi32();
+    storeDistances(nullptr, count, iter_counts, z_real, z_imag, dz_real,
+                   dz_imag, params, out);
+  } else {
+    const typename S::Count iter_counts =
+        iterate<T, InteriorDetection>(params, c_real, c_imag, z_real, z_imag);
 
-      for (unsigned int i = 0; i < m_max_iterations; ++i) {
-        const __m512 norm = utility::avx512::norm(z_real, z_imag);
+    storeBlock(count, iter_counts, z_real, z_imag, params.max_iterations, out);
+  }
+}
+
+/*
+ * Compute up to one vector of arbitrary pixels.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, bool InteriorDetection, Channels C>
+void computeBlock(const KernelParams& params, const std::size_t* indices,
+                  const std::size_t count, const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
 
-        // Check which pixels have not escaped yet.
-        const __mmask16 active =
-            _mm512_cmple_ps_mask(norm, _mm512_set1_ps(4.0f));
+  const auto [c_real, c_imag] = mapPixels<T>(params, indices, count);
+
+  typename S::Vec z_real, z_imag;
+
+  if constexpr (C::distance) {
+    typename S::Vec dz_real, dz_imag;
+    const typename S::Count iter_counts = iterate<T, InteriorDetection, true>(
+        params, c_real, c_imag, z_real, z_imag, &dz_real, &dz_imag);
+
+    storeDistances(indices, count, iter_counts, z_real, z_imag, dz_real,
+                   dz_imag, params, out);
+  } else {
+    const typename S::Count iter_counts =
+        iterate<T, InteriorDetection>(params, c_real, c_imag, z_real, z_imag);
+
+    storeList(indices, count, iter_counts, z_real, z_imag,
+              params.max_iterations, out);
+  }
+}
+
+/*
+ * The pending pixels of a run of consecutive pixels in the same row.
+ */
+template <Scalar T> struct RunQueue {
+  static constexpr bool resumes = false;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   *
+   * @returns The mapped positions of one vector of pixels starting at `first`.
+   */
+  auto map(const std::size_t first, const std::size_t /* count */) const {
+    return mapPixels<T>(params, row, col + first);
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the output of the run.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return position;
+  }
+
+  const KernelParams& params;
+  std::size_t row;
+  std::size_t col;
+};
+
+/*
+ * The pending pixels of a list of arbitrary pixels.
+ */
+template <Scalar T> struct ListQueue {
+  static constexpr bool resumes = false;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The mapped positions of the pixels.
+   */
+  auto map(const std::size_t first, const std::size_t count) const {
+    return mapPixels<T>(params, indices + first, count);
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the first pixel of the image.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return indices[position];
+  }
+
+  const KernelParams& params;
+  const std::size_t* indices;
+};
+
+/*
+ * The pending pixels of a list of arbitrary pixels that continue from the state
+ * in the output.
+ */
+template <Scalar T> struct ResumeQueue {
+  static constexpr bool resumes = true;
 
-        // If all pixels have escaped, stop early.
-        if (active == 0) {
-          break;
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The mapped positions of the pixels.
+   */
+  auto map(const std::size_t first, const std::size_t count) const {
+    return mapPixels<T>(params, indices + first, count);
+  }
+
+  /*
+   * Load the state that pending pixels continue from.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The z-values and iteration counts of the pixels, in the lowest
+   * lanes.
+   */
+  auto start(const std::size_t first, const std::size_t count) const {
+    using S = Simd<T>;
+
+    alignas(backend::AVX512::alignment) T lane_real[S::lanes]{};
+    alignas(backend::AVX512::alignment) T lane_imag[S::lanes]{};
+    alignas(backend::AVX512::alignment) typename S::CountElement
+        lane_iters[S::lanes]{};
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::size_t idx = indices[first + i];
+
+      lane_real[i] = out.z_reals[idx];
+      lane_imag[i] = out.z_imags[idx];
+      lane_iters[i] =
+          static_cast<typename S::CountElement>(out.iterations[idx]);
+    }
+
+    return std::tuple{S::load(lane_real), S::load(lane_imag),
+                      S::count_load(lane_iters)};
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the first pixel of the image.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return indices[position];
+  }
+
+  const KernelParams& params;
+  const std::size_t* indices;
+  const KernelOutput<T>& out;
+};
+
+/*
+ * Select the lowest lanes of a mask.
+ *
+ * @param mask The mask.
+ * @param count The number of lanes to select.
+ *
+ * @returns The lowest `count` lanes set in `mask`.
+ */
+template <typename Mask>
+Mask lowestLanes(const Mask mask, const std::size_t count) {
+  unsigned int rest = mask;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    rest &= rest - 1;
+  }
+
+  return static_cast<Mask>(mask & ~rest);
+}
+
+/*
+ * Compute a queue of pixels, refilling each lane with the next pending pixel as
+ * soon as its pixel retires.
+ *
+ * The lanes iterate together until at least one of them retires. The results
+ * of the retired lanes are compressed out and written, after which the next
+ * pending pixels are expanded into the free lanes. The results are identical
+ * to those of the block kernel.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Queue The type of the queue, `RunQueue`, `ListQueue` or
+ * `ResumeQueue`.
+ *
+ * @param params The parameters of the computation.
+ * @param queue The pending pixels.
+ * @param count The number of pixels in the queue.
+ * @param out The output that the offsets of the queue are relative to.
+ */
+template <Scalar T, bool InteriorDetection, typename Queue, Channels C>
+void computeRefill(const KernelParams& params, const Queue& queue,
+                   const std::size_t count, const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+  using Vec = typename S::Vec;
+  using Count = typename S::Count;
+  using Mask = typename S::Mask;
+
+  const Count max_iterations = S::count_set1(params.max_iterations);
+  const Vec bailout = S::set1(static_cast<T>(params.bailout_norm));
+
+  Vec c_real = S::zero();
+  Vec c_imag = S::zero();
+  Vec z_real = S::zero();
+  Vec z_imag = S::zero();
+  Count iter_counts = S::count_zero();
+
+  // The position in the queue of the pixel in each lane.
+  Count positions = S::count_zero();
+
+  // Brent's method needs a saved point and save interval per lane, as the lanes
+  // started iterating at different times.
+  [[maybe_unused]] Vec z_real_saved = S::zero();
+  [[maybe_unused]] Vec z_imag_saved = S::zero();
+  [[maybe_unused]] Count save_at = S::count_zero();
+
+  // Lanes holding a pixel that hasn't retired yet.
+  Mask occupied = 0;
+  std::size_t next{0};
+
+  while (true) {
+    if (next < count) {
+      const std::size_t free_lanes =
+          S::lanes - static_cast<std::size_t>(std::popcount(occupied));
+      const std::size_t loaded = std::min(free_lanes, count - next);
+      const Mask refill = lowestLanes(static_cast<Mask>(~occupied), loaded);
+
+      const auto [new_real, new_imag] = queue.map(next, loaded);
+
+      // Expand the new pixels into the free lanes, in order.
+      c_real = S::mask_expand(c_real, refill, new_real);
+      c_imag = S::mask_expand(c_imag, refill, new_imag);
+      positions = S::count_mask_expand(
+          positions, refill,
+          S::count_add(S::count_set1(next), S::count_lane_offsets()));
+
+      if constexpr (Queue::resumes) {
+        const auto [start_real, start_imag, start_iters] =
+            queue.start(next, loaded);
+
+        z_real = S::mask_expand(z_real, refill, start_real);
+        z_imag = S::mask_expand(z_imag, refill, start_imag);
+        iter_counts = S::count_mask_expand(iter_counts, refill, start_iters);
+      } else {
+        z_real = S::mask_mov(z_real, refill, S::zero());
+        z_imag = S::mask_mov(z_imag, refill, S::zero());
+        iter_counts = S::count_mask_mov(iter_counts, refill, S::count_zero());
+      }
+
+      if constexpr (InteriorDetection) {
+        z_real_saved = S::mask_mov(z_real_saved, refill, z_real);
+        z_imag_saved = S::mask_mov(z_imag_saved, refill, z_imag);
+        save_at = S::count_mask_add(save_at, refill, iter_counts,
+                                    S::count_set1(1));
+
+        // Points within the main cardioid or period-2 bulb retire right away.
+        const Mask interior = static_cast<Mask>(
+            refill & utility::avx512::isInMainCardioidOrBulb(c_real, c_imag));
+        iter_counts =
+            S::count_mask_mov(iter_counts, interior, max_iterations);
+      }
+
+      occupied = static_cast<Mask>(occupied | refill);
+      next += loaded;
+    }
+
+    if (occupied == 0) {
+      return;
+    }
+
+    // Keep lanes without a pixel from drifting off to infinity.
+    c_real = S::maskz_mov(occupied, c_real);
+    c_imag = S::maskz_mov(occupied, c_imag);
+    z_real = S::maskz_mov(occupied, z_real);
+    z_imag = S::maskz_mov(occupied, z_imag);
+
+    Mask retired;
+
+    while (true) {
+      const Vec norm = utility::avx512::norm(z_real, z_imag);
+
+      // A pixel retires when it escapes or reaches the maximum iterations.
+      const Mask active = S::count_mask_cmp_neq(
+          S::cmp_le(norm, bailout), iter_counts, max_iterations);
+      retired = static_cast<Mask>(occupied & ~active);
+
+      if (retired != 0) {
+        break;
+      }
+
+      // Every occupied lane is active, so no blending is needed.
+      iter_counts = S::count_add(iter_counts, S::count_set1(1));
+
+      step<T>(c_real, c_imag, z_real, z_imag);
+
+      if constexpr (InteriorDetection) {
+        // Periodic lanes reach the maximum iterations, so that they retire at
+        // the next check with their current z-value.
+        const Mask periodic =
+            S::mask_cmp_eq(S::mask_cmp_eq(occupied, z_real, z_real_saved),
+                           z_imag, z_imag_saved);
+        iter_counts = S::count_mask_mov(iter_counts, periodic, max_iterations);
+
+        const Mask save = S::count_cmp_eq(iter_counts, save_at);
+        z_real_saved = S::mask_mov(z_real_saved, save, z_real);
+        z_imag_saved = S::mask_mov(z_imag_saved, save, z_imag);
+        save_at = S::count_mask_double(save_at, save);
+      }
+    }
+
+    // Compress the retired lanes so that only they have to be written.
+    alignas(backend::AVX512::alignment) typename S::CountElement
+        lane_positions[S::lanes];
+    alignas(backend::AVX512::alignment) typename S::CountElement
+        lane_iters[S::lanes];
+    alignas(backend::AVX512::alignment) T lane_real[S::lanes];
+    alignas(backend::AVX512::alignment) T lane_imag[S::lanes];
+
+    S::count_mask_compressstoreu(lane_positions, retired, positions);
+    S::count_mask_compressstoreu(lane_iters, retired, iter_counts);
+    S::mask_compressstoreu(lane_real, retired, z_real);
+    S::mask_compressstoreu(lane_imag, retired, z_imag);
+
+    const int retired_count = std::popcount(retired);
+
+    for (int i = 0; i < retired_count; ++i) {
+      const std::size_t offset =
+          queue.offset(static_cast<std::size_t>(lane_positions[i]));
+
+      storePixel(out, offset, static_cast<unsigned int>(lane_iters[i]),
+                 lane_real[i], lane_imag[i], params.max_iterations);
+    }
+
+    occupied = static_cast<Mask>(occupied & ~retired);
+  }
+}
+
+/*
+ * The registers of the vectors that the interleaved kernels iterate together,
+ * see `VectorGroup` in mandelbrot_avx2.cpp.
+ */
+template <Scalar T, std::size_t Vectors> struct VectorGroup {
+  using S = Simd<T>;
+
+  typename S::Vec c_real[Vectors];
+  typename S::Vec c_imag[Vectors];
+  typename S::Vec z_real[Vectors];
+  typename S::Vec z_imag[Vectors];
+  typename S::Mask retired[Vectors];
+  typename S::Count iter_counts[Vectors];
+};
+
+/*
+ * Iterate several independent vectors of points together until they escape
+ * or reach the maximum iterations.
+ *
+ * See `iterateInterleaved` in mandelbrot_avx2.cpp. The masks of the retired
+ * lanes are kept in mask registers.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param group The vectors, with their points and the lanes without a point
+ * set. The final z-values and iteration counts are stored into it.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval>
+void iterateInterleaved(const KernelParams& params,
+                        VectorGroup<T, Vectors>& group) {
+  using S = Simd<T>;
+  using Vec = typename S::Vec;
+  using Mask = typename S::Mask;
+
+  const auto& c_real = group.c_real;
+  const auto& c_imag = group.c_imag;
+  auto& z_real = group.z_real;
+  auto& z_imag = group.z_imag;
+  auto& retired = group.retired;
+  auto& iter_counts = group.iter_counts;
+
+  constexpr auto all = static_cast<Mask>((1u << S::lanes) - 1);
+  const Vec bailout = S::set1(static_cast<T>(params.bailout_norm));
+
+  unroll<Vectors>([&](const auto v) {
+    z_real[v] = S::zero();
+    z_imag[v] = S::zero();
+    iter_counts[v] = S::count_zero();
+  });
+
+  const auto step_all = [&](auto) {
+    unroll<Vectors>([&](const auto v) {
+      step<T>(c_real[v], c_imag[v], z_real[v], z_imag[v]);
+    });
+  };
+
+  for (unsigned int i = 0; i < params.max_iterations;) {
+    const unsigned int steps =
+        std::min(CheckInterval, params.max_iterations - i);
+    Vec start_real[Vectors];
+    Vec start_imag[Vectors];
+
+    unroll<Vectors>([&](const auto v) {
+      start_real[v] = z_real[v];
+      start_imag[v] = z_imag[v];
+    });
+
+    if (steps == CheckInterval) {
+      unroll<CheckInterval>(step_all);
+    } else {
+      for (unsigned int j = 0; j < steps; ++j) {
+        step_all(j);
+      }
+    }
+
+    i += steps;
+    bool finished = true;
+
+    unroll<Vectors>([&](const auto v) {
+      const Mask inside = S::cmp_le(utility::avx512::norm(z_real[v], z_imag[v]),
+                                    bailout);
+
+      if ((retired[v] | inside) == all) {
+        // Retired lanes keep the z-value they retired with.
+        z_real[v] = S::mask_mov(z_real[v], retired[v], start_real[v]);
+        z_imag[v] = S::mask_mov(z_imag[v], retired[v], start_imag[v]);
+        iter_counts[v] =
+            S::count_mask_add(iter_counts[v], static_cast<Mask>(~retired[v]),
+                              iter_counts[v], S::count_set1(steps));
+      } else {
+        z_real[v] = start_real[v];
+        z_imag[v] = start_imag[v];
+
+        for (unsigned int j = 0; j < steps; ++j) {
+          const Mask active = S::mask_cmp_le(
+              static_cast<Mask>(~retired[v]),
+              utility::avx512::norm(z_real[v], z_imag[v]), bailout);
+          retired[v] = static_cast<Mask>(~active);
+
+          if (active == 0) {
+            break;
+          }
+
+          iter_counts[v] = S::count_mask_add(iter_counts[v], active,
+                                             iter_counts[v], S::count_set1(1));
+
+          Vec z_real_new = z_real[v];
+          Vec z_imag_new = z_imag[v];
+          step<T>(c_real[v], c_imag[v], z_real_new, z_imag_new);
+
+          z_real[v] = S::mask_mov(z_real[v], active, z_real_new);
+          z_imag[v] = S::mask_mov(z_imag[v], active, z_imag_new);
         }
+      }
+
+      finished = finished && retired[v] == all;
+    });
+
+    if (finished) {
+      break;
+    }
+  }
+}
 
-        iter_counts = _mm512_mask_add_epi32(iter_counts, active, iter_counts,
-                                            _mm512_set1_epi32(1));
+/*
+ * Compute consecutive pixels in the same row, several vectors at a time.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors iterated together.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval,
+          Channels C>
+void computeInterleaved(const KernelParams& params, const std::size_t row,
+                        const std::size_t col, const std::size_t count,
+                        const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+  using Mask = typename S::Mask;
 
-        // Calculate the new real parts.
-        const __m512 z_real_new =
-            _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(z_real, z_real),
-                                        _mm512_mul_ps(z_imag, z_imag)),
-                          c_real);
+  for (std::size_t offset = 0; offset < count; offset += Vectors * S::lanes) {
+    VectorGroup<T, Vectors> group;
+    std::array<std::size_t, Vectors> pixels;
 
-        // Calculate the new imaginary parts.
-        const __m512 z_imag_new =
-            _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(z_real, z_imag),
-                                        _mm512_mul_ps(z_real, z_imag)),
-                          c_imag);
+    unroll<Vectors>([&](const auto v) {
+      const std::size_t first = offset + v * S::lanes;
+      pixels[v] = first < count ? std::min(S::lanes, count - first) : 0;
 
-        // Only update the real and imaginary parts for active pixels.
-        z_real = _mm512_mask_blend_ps(active, z_real, z_real_new);
-        z_imag = _mm512_mask_blend_ps(active, z_imag, z_imag_new);
+      const auto [c_real, c_imag] = mapPixels<T>(params, row, col + first);
+      group.c_real[v] = c_real;
+      group.c_imag[v] = c_imag;
+      group.retired[v] = static_cast<Mask>(~((1u << pixels[v]) - 1));
+    });
+
+    iterateInterleaved<T, Vectors, CheckInterval>(params, group);
+
+    unroll<Vectors>([&](const auto v) {
+      if (pixels[v] != 0) {
+        storeBlock(pixels[v], group.iter_counts[v], group.z_real[v],
+                   group.z_imag[v], params.max_iterations,
+                   out.at(offset + v * S::lanes));
+      }
+    });
+  }
+}
+
+/*
+ * Compute arbitrary pixels, several vectors at a time.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors iterated together.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval,
+          Channels C>
+void computeInterleaved(const KernelParams& params,
+                        const std::size_t* indices, const std::size_t count,
+                        const KernelOutput<T, C>& out) {
+  using S = Simd<T>;
+  using Mask = typename S::Mask;
+
+  for (std::size_t offset = 0; offset < count; offset += Vectors * S::lanes) {
+    VectorGroup<T, Vectors> group;
+    std::array<std::size_t, Vectors> pixels;
+
+    unroll<Vectors>([&](const auto v) {
+      const std::size_t first = offset + v * S::lanes;
+      pixels[v] = first < count ? std::min(S::lanes, count - first) : 0;
+      group.retired[v] = static_cast<Mask>(~((1u << pixels[v]) - 1));
+
+      if (pixels[v] != 0) {
+        const auto [c_real, c_imag] =
+            mapPixels<T>(params, indices + first, pixels[v]);
+        group.c_real[v] = c_real;
+        group.c_imag[v] = c_imag;
+      } else {
+        group.c_real[v] = S::zero();
+        group.c_imag[v] = S::zero();
       }
+    });
+
+    iterateInterleaved<T, Vectors, CheckInterval>(params, group);
+
+    unroll<Vectors>([&](const auto v) {
+      if (pixels[v] != 0) {
+        storeList(indices + offset + v * S::lanes, pixels[v],
+                  group.iter_counts[v], group.z_real[v], group.z_imag[v],
+                  params.max_iterations, out);
+      }
+    });
+  }
+}
+
+/*
+ * Evaluate the series approximation of the differences to the reference orbit
+ * with Horner's method.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param u_real The real parts of the offsets divided by the series scale.
+ * @param u_imag The imaginary parts of the offsets divided by the series
+ * scale.
+ * @param dz_real The real parts of the differences.
+ * @param dz_imag The imaginary parts of the differences.
+ */
+template <Scalar T>
+void evaluateSeries(const PerturbationParams<T>& params,
+                    const typename Simd<T>::Vec u_real,
+                    const typename Simd<T>::Vec u_imag,
+                    typename Simd<T>::Vec& dz_real,
+                    typename Simd<T>::Vec& dz_imag) {
+  using S = Simd<T>;
+
+  dz_real = S::zero();
+  dz_imag = S::zero();
+
+  for (std::size_t k = params.series_terms; k-- > 0;) {
+    const typename S::Vec a_real =
+        S::add(dz_real, S::set1(params.series_reals[k]));
+    const typename S::Vec a_imag =
+        S::add(dz_imag, S::set1(params.series_imags[k]));
+
+    dz_real = S::sub(S::mul(a_real, u_real), S::mul(a_imag, u_imag));
+    dz_imag = S::add(S::mul(a_real, u_imag), S::mul(a_imag, u_real));
+  }
+}
+
+/*
+ * Compute up to one vector of consecutive pixels in the same row by perturbing
+ * a reference orbit.
+ *
+ * Each lane tracks its own position in the reference orbit, as lanes are
+ * rebased independently. See `iteratePerturbed` in mandelbrot_serial.cpp for
+ * the rebasing condition.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T>
+void computePerturbedBlock(const PerturbationParams<T>& params,
+                           const std::size_t row, const std::size_t col,
+                           const std::size_t count,
+                           const KernelOutput<T>& out) {
+  using S = Simd<T>;
+  using Vec = typename S::Vec;
+  using Count = typename S::Count;
+  using Mask = typename S::Mask;
+
+  // The offsets are computed in double precision before rounding them, so that
+  // single precision kernels don't lose the position of the pixels.
+  alignas(backend::AVX512::alignment) T lane_dc[S::lanes];
+  alignas(backend::AVX512::alignment) T lane_u[S::lanes];
+
+  for (std::size_t i = 0; i < S::lanes; ++i) {
+    const double dc =
+        params.real_offset + static_cast<double>(col + i) * params.step;
+
+    lane_dc[i] = static_cast<T>(dc);
+    lane_u[i] = static_cast<T>(dc / params.series_scale);
+  }
+
+  const double dc_imag_offset =
+      params.imag_offset - static_cast<double>(row) * params.step;
+
+  const Vec dc_real = S::load(lane_dc);
+  const Vec dc_imag = S::set1(static_cast<T>(dc_imag_offset));
+
+  // Start after the skipped iterations, as given by the series.
+  Vec dz_real, dz_imag;
+  evaluateSeries<T>(params, S::load(lane_u),
+                    S::set1(static_cast<T>(dc_imag_offset /
+                                           params.series_scale)),
+                    dz_real, dz_imag);
+
+  const std::size_t skipped = params.skipped_iterations;
+
+  // The reference point at the position of each lane.
+  Vec ref_real = S::set1(params.orbit_reals[skipped]);
+  Vec ref_imag = S::set1(params.orbit_imags[skipped]);
+
+  Vec z_real = S::add(ref_real, dz_real);
+  Vec z_imag = S::add(ref_imag, dz_imag);
+  Count iter_counts = S::count_set1(skipped);
+
+  // The position of each lane in the reference orbit.
+  Count n = S::count_set1(skipped);
+
+  const Count one = S::count_set1(1);
+  const Count last = S::count_set1(params.orbit_length - 1);
+  const Vec bailout = S::set1(static_cast<T>(params.bailout_norm));
+
+  auto active = static_cast<Mask>(~0u);
+
+  for (unsigned int i = params.skipped_iterations; i < params.max_iterations;
+       ++i) {
+    // dz = (2 * Z + dz) * dz + dc
+    const Vec a_real = S::add(S::add(ref_real, ref_real), dz_real);
+    const Vec a_imag = S::add(S::add(ref_imag, ref_imag), dz_imag);
+
+    const Vec dz_real_new = S::add(
+        S::sub(S::mul(a_real, dz_real), S::mul(a_imag, dz_imag)), dc_real);
+    const Vec dz_imag_new = S::add(
+        S::add(S::mul(a_real, dz_imag), S::mul(a_imag, dz_real)), dc_imag);
+
+    dz_real = S::blend(active, dz_real, dz_real_new);
+    dz_imag = S::blend(active, dz_imag, dz_imag_new);
+    n = S::count_mask_add(n, active, n, one);
+    iter_counts = S::count_mask_add(iter_counts, active, iter_counts, one);
+
+    // Lanes that are no longer active keep their position, so that they can
+    // load their reference point as well.
+    ref_real = S::gather(params.orbit_reals, n);
+    ref_imag = S::gather(params.orbit_imags, n);
 
-      const std::size_t base_idx = row * m_width + col;
-      const std::size_t remaining = std::min(lanes, m_width - col);
-      const __mmask16 store_mask =
-          (remaining == lanes) ? 0xFFFF : (1 << remaining) - 1;
+    z_real = S::blend(active, z_real, S::add(ref_real, dz_real));
+    z_imag = S::blend(active, z_imag, S::add(ref_imag, dz_imag));
 
-      _mm512_mask_store_ps(&m_host.z_reals[base_idx], store_mask, z_real);
-      _mm512_mask_store_ps(&m_host.z_imags[base_idx], store_mask, z_imag);
-      _mm512_mask_store_epi32(&m_host.iterations[base_idx], store_mask,
-                              iter_counts);
+    const Vec norm = utility::avx512::norm(z_real, z_imag);
+
+    // Check which pixels have not escaped yet.
+    active = S::mask_cmp_le(active, norm, bailout);
+
+    // If all pixels have escaped, stop early.
+    if (active == 0) {
+      break;
+    }
+
+    const Mask rebase = static_cast<Mask>(
+        S::mask_cmp_lt(active, norm, utility::avx512::norm(dz_real, dz_imag)) |
+        S::count_mask_cmp_eq(active, n, last));
+
+    // Rebasing is rare, so keep it off the dependency chain of the iteration.
+    if (rebase != 0) {
+      dz_real = S::mask_mov(dz_real, rebase, z_real);
+      dz_imag = S::mask_mov(dz_imag, rebase, z_imag);
+      ref_real = S::maskz_mov(static_cast<Mask>(~rebase), ref_real);
+      ref_imag = S::maskz_mov(static_cast<Mask>(~rebase), ref_imag);
+      n = S::count_mask_mov(n, rebase, S::count_zero());
+    }
+  }
+
+  storeBlock(count, iter_counts, z_real, z_imag, params.max_iterations, out);
+}
+} // namespace
+
+/*
+ * Compute the Mandelbrot set for a run of pixels with AVX512 acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX512, T, C>::compute(const KernelParams& params,
+                                            std::size_t row, std::size_t col,
+                                            std::size_t count,
+                                            const KernelOutput<T, C>& out) {
+  // Only the block variant tracks the derivatives, see `channels::Distance`.
+  if constexpr (!C::distance) {
+    if (params.variant == KernelVariant::Interleaved &&
+        !params.interior_detection) {
+      withInterleaving(params.interleaving, [&]<std::size_t Vectors,
+                                                unsigned int CheckInterval>() {
+        computeInterleaved<T, Vectors, CheckInterval>(params, row, col, count,
+                                                      out);
+      });
+
+      return;
+    }
+
+    if (params.variant == KernelVariant::LaneRefill) {
+      const RunQueue<T> queue{params, row, col};
+
+      if (params.interior_detection) {
+        computeRefill<T, true>(params, queue, count, out);
+      } else {
+        computeRefill<T, false>(params, queue, count, out);
+      }
+
+      return;
+    }
+  }
+
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    const std::size_t block = std::min(lanes, count - offset);
+
+    if (params.interior_detection) {
+      computeBlock<T, true>(params, row, col + offset, block, out.at(offset));
+    } else {
+      computeBlock<T, false>(params, row, col + offset, block,
+                             out.at(offset));
+    }
+  }
+}
+
+/*
+ * Compute the Mandelbrot set for a list of pixels with AVX512 acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX512, T, C>::compute(const KernelParams& params,
+                                            const std::size_t* indices,
+                                            std::size_t count,
+                                            const KernelOutput<T, C>& out) {
+  // Only the block variant tracks the derivatives, see `channels::Distance`.
+  if constexpr (!C::distance) {
+    if (params.variant == KernelVariant::Interleaved &&
+        !params.interior_detection) {
+      withInterleaving(params.interleaving, [&]<std::size_t Vectors,
+                                                unsigned int CheckInterval>() {
+        computeInterleaved<T, Vectors, CheckInterval>(params, indices, count,
+                                                      out);
+      });
+
+      return;
+    }
+
+    if (params.variant == KernelVariant::LaneRefill) {
+      const ListQueue<T> queue{params, indices};
+
+      if (params.interior_detection) {
+        computeRefill<T, true>(params, queue, count, out);
+      } else {
+        computeRefill<T, false>(params, queue, count, out);
+      }
+
+      return;
     }
   }
 
-  return {m_host, m_width, m_height};
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    const std::size_t block = std::min(lanes, count - offset);
+
+    if (params.interior_detection) {
+      computeBlock<T, true>(params, indices + offset, block, out);
+    } else {
+      computeBlock<T, false>(params, indices + offset, block, out);
+    }
+  }
 }
 
+/*
+ * Continue computing the Mandelbrot set for a list of pixels with AVX512
+ * acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX512, T, C>::resume(const KernelParams& params,
+                                           const std::size_t* indices,
+                                           std::size_t count,
+                                           const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  const ResumeQueue<T> queue{params, indices, out};
+
+  if (params.interior_detection) {
+    computeRefill<T, true>(params, queue, count, out);
+  } else {
+    computeRefill<T, false>(params, queue, count, out);
+  }
+}
+
+/*
+ * Compute the Mandelbrot set for a run of pixels by perturbation with AVX512
+ * acceleration.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::AVX512, T, C>::compute(
+    const PerturbationParams<T>& params, std::size_t row, std::size_t col,
+    std::size_t count, const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    computePerturbedBlock(params, row, col + offset,
+                          std::min(lanes, count - offset), out.at(offset));
+  }
+}
+
+template struct Kernel<backend::AVX512, float>;
+template struct Kernel<backend::AVX512, double>;
+
+template struct Kernel<backend::AVX512, float, channels::Iterations>;
+template struct Kernel<backend::AVX512, double, channels::Iterations>;
+template struct Kernel<backend::AVX512, float, channels::Iterations16>;
+template struct Kernel<backend::AVX512, double, channels::Iterations16>;
+template struct Kernel<backend::AVX512, float, channels::Smooth>;
+template struct Kernel<backend::AVX512, double, channels::Smooth>;
+template struct Kernel<backend::AVX512, float, channels::Distance>;
+template struct Kernel<backend::AVX512, double, channels::Distance>;
+
 #endif
@@ -21,12 +21,15 @@
  * @param imag_min The lower bound of the imaginary axis.
  * @param imag_max The upper bound of the imaginary axis.
  * @param max_iterations The maximum iterations for each pixel.
+ * @param interior_detection Whether interior detection is enabled.
+ * @param bailout_norm The square of the bailout radius.
  */
 __global__ void mandelbrot_cuda_kernel(
     unsigned int* iterations_out, float* z_reals_out, float* z_imags_out,
     const std::size_t width, const std::size_t height, const float real_min,
     const float real_max, const float imag_min, const float imag_max,
-    const unsigned int max_iterations) {
+    const unsigned int max_iterations, const bool interior_detection,
+    const float bailout_norm) {
   const std::size_t col = threadIdx.x + blockIdx.x * blockDim.x;
   const std::size_t row = threadIdx.y + blockIdx.y * blockDim.y;
 
@@ -41,10 +44,39 @@ __global__ void mandelbrot_cuda_kernel(
 
   unsigned int iteration{0};
 
-  while (cuda::std::norm(z) <= 4.0f && iteration < max_iterations) {
+  if (interior_detection) {
+    // Main cardioid and period-2 bulb check.
+    const float real_shifted = c.real() - 0.25f;
+    const float imag_squared = c.imag() * c.imag();
+    const float q = real_shifted * real_shifted + imag_squared;
+    const float real_bulb = c.real() + 1.0f;
+
+    if (q * (q + real_shifted) <= 0.25f * imag_squared ||
+        real_bulb * real_bulb + imag_squared <= 0.0625f) {
+      iteration = max_iterations;
+    }
+  }
+
+  cuda::std::complex<float> z_saved = z;
+  unsigned int save_at{1};
+
+  while (cuda::std::norm(z) <= bailout_norm && iteration < max_iterations) {
     z = z * z + c;
 
     ++iteration;
+
+    if (interior_detection) {
+      // Brent-style periodicity check against the last saved orbit point.
+      if (z == z_saved) {
+        iteration = max_iterations;
+        break;
+      }
+
+      if (iteration == save_at) {
+        z_saved = z;
+        save_at <<= 1;
+      }
+    }
   }
 
   iterations_out[row * width + col] = iteration;
@@ -64,8 +96,16 @@ MandelbrotResult<backend::CUDA> MandelbrotEngine<backend::CUDA>::compute() {
                  (m_height + block_size.y + 1) / block_size.y);
 
   mandelbrot_cuda_kernel<<<grid_size, block_size>>>(
-      m_device.iterations, m_device.z_reals, m_device.z_imags, m_width, m_height, m_bounds.real_min, m_bounds.real_max,
-      m_bounds.imag_min, m_bounds.imag_max, m_max_iterations);
+      m_device.iterations, m_device.z_reals, m_device.z_imags, m_width, m_height,
+      static_cast<float>(m_bounds.real_min),
+      static_cast<float>(m_bounds.real_max),
+      static_cast<float>(m_bounds.imag_min),
+      static_cast<float>(m_bounds.imag_max), m_max_iterations,
+      m_interior_detection, static_cast<float>(bailout_norm()));
+
+  m_iterated_pixels = m_width * m_height;
+
+  m_host.allocate();
 
   cudaMemcpy(m_host.iterations.data(), m_device.iterations,
              m_width * m_height * sizeof(unsigned int), cudaMemcpyDeviceToHost);
@@ -77,3 +117,23 @@ MandelbrotResult<backend::CUDA> MandelbrotEngine<backend::CUDA>::compute() {
   return {m_host,
           m_width, m_height};
 }
+
+/*
+ * Continue the last computation up to a higher maximum iterations. The CUDA
+ * backend doesn't keep the state of its pixels, so it starts over.
+ *
+ * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ */
+template<>
+MandelbrotResult<backend::CUDA>
+MandelbrotEngine<backend::CUDA>::resume(unsigned int max_iterations) {
+  if (max_iterations < m_max_iterations) {
+    throw std::invalid_argument(
+        std::format("Cannot resume from {} down to {} iterations.",
+                    m_max_iterations, max_iterations));
+  }
+
+  m_max_iterations = max_iterations;
+
+  return compute();
+}
@@ -0,0 +1,1408 @@
+/*
+ * This file contains the execution policies of the engine.
+ *
+ * The pixels are computed by the backend kernels in kernels.hpp. The execution
+ * policy decides how the image is split into runs of pixels and which thread
+ * computes each run.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(MANDELBROT_HAS_OMP)
+#include <omp.h>
+#endif
+
+#include "backends.hpp"
+#include "kernels.hpp"
+#include "mandelbrot_engine.hpp"
+#include "numa.hpp"
+#include "result_file.hpp"
+#include "scheduler.hpp"
+#include "subdivision.hpp"
+
+namespace {
+// The largest fraction of a pixel by which two views may be misaligned for
+// their pixels to be reused.
+constexpr double pixel_tolerance = 1e-3;
+
+// The number of resumed pixels that a thread takes at a time.
+constexpr std::size_t resume_batch = 1024;
+
+// The number of edge pixels that a thread supersamples at a time.
+constexpr std::size_t supersample_batch = 256;
+
+// The number of frames of a batch that are computed at the same time: the one
+// being finished, and the next.
+constexpr std::size_t frames_in_flight = 2;
+
+/*
+ * Find the translation between two views of the same size and scale, if it is
+ * a whole number of pixels.
+ *
+ * @param from The bounds of the previous view.
+ * @param to The bounds of the new view.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param rows The number of rows that the image moved up by.
+ * @param cols The number of columns that the image moved left by.
+ *
+ * @returns Whether the views overlap and differ by a whole number of pixels.
+ */
+bool findPixelShift(const ViewBounds& from, const ViewBounds& to,
+                    const std::size_t width, const std::size_t height,
+                    std::ptrdiff_t& rows, std::ptrdiff_t& cols) {
+  if (width < 2 || height < 2) {
+    return false;
+  }
+
+  const double step_real =
+      (from.real_max - from.real_min) / static_cast<double>(width - 1);
+  const double step_imag =
+      (from.imag_max - from.imag_min) / static_cast<double>(height - 1);
+
+  // Both views must have the same extent, up to a fraction of a pixel.
+  const double max_error_real = pixel_tolerance * std::abs(step_real);
+  const double max_error_imag = pixel_tolerance * std::abs(step_imag);
+
+  if (std::abs((to.real_max - to.real_min) - (from.real_max - from.real_min)) >
+          max_error_real ||
+      std::abs((to.imag_max - to.imag_min) - (from.imag_max - from.imag_min)) >
+          max_error_imag) {
+    return false;
+  }
+
+  const double shift_cols = (to.real_min - from.real_min) / step_real;
+  const double shift_rows = (from.imag_max - to.imag_max) / step_imag;
+
+  if (std::abs(shift_cols - std::round(shift_cols)) > pixel_tolerance ||
+      std::abs(shift_rows - std::round(shift_rows)) > pixel_tolerance ||
+      std::abs(shift_cols) >= static_cast<double>(width) ||
+      std::abs(shift_rows) >= static_cast<double>(height)) {
+    return false;
+  }
+
+  cols = static_cast<std::ptrdiff_t>(std::round(shift_cols));
+  rows = static_cast<std::ptrdiff_t>(std::round(shift_rows));
+
+  return true;
+}
+
+/*
+ * Shift the pixels of an image in place, so that the pixel at (`row + rows`,
+ * `col + cols`) moves to (`row`, `col`). Pixels without a source are left
+ * untouched.
+ *
+ * @param data The pixels.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param rows The number of rows to shift by.
+ * @param cols The number of columns to shift by.
+ */
+template <typename V>
+void shiftPixels(V* data, const std::size_t width, const std::size_t height,
+                 const std::ptrdiff_t rows, const std::ptrdiff_t cols) {
+  const auto w = static_cast<std::ptrdiff_t>(width);
+  const auto h = static_cast<std::ptrdiff_t>(height);
+
+  const std::ptrdiff_t col_begin = std::max<std::ptrdiff_t>(0, -cols);
+  const auto count = static_cast<std::size_t>(w - std::abs(cols));
+
+  const auto shift_row = [&](const std::ptrdiff_t row) {
+    std::memmove(data + row * w + col_begin,
+                 data + (row + rows) * w + col_begin + cols,
+                 count * sizeof(V));
+  };
+
+  // Visit the rows in the order that reads every source before it is
+  // overwritten.
+  if (rows >= 0) {
+    for (std::ptrdiff_t row = 0; row + rows < h; ++row) {
+      shift_row(row);
+    }
+  } else {
+    for (std::ptrdiff_t row = h - 1; row + rows >= 0; --row) {
+      shift_row(row);
+    }
+  }
+}
+
+/*
+ * Get the strips along the edges of an image that a shift exposes.
+ *
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param rows The number of rows that the image was shifted by.
+ * @param cols The number of columns that the image was shifted by.
+ *
+ * @returns The strips, which don't overlap.
+ */
+std::vector<Rect> exposedStrips(const std::size_t width,
+                                const std::size_t height,
+                                const std::ptrdiff_t rows,
+                                const std::ptrdiff_t cols) {
+  std::vector<Rect> strips;
+
+  const auto shifted_rows = static_cast<std::size_t>(std::abs(rows));
+  const auto shifted_cols = static_cast<std::size_t>(std::abs(cols));
+
+  // The rows that were kept, between the horizontal strips.
+  std::size_t row_min = 0;
+  std::size_t row_max = height - 1;
+
+  if (rows > 0) {
+    strips.push_back({height - shifted_rows, height - 1, 0, width - 1});
+    row_max = height - shifted_rows - 1;
+  } else if (rows < 0) {
+    strips.push_back({0, shifted_rows - 1, 0, width - 1});
+    row_min = shifted_rows;
+  }
+
+  if (cols > 0) {
+    strips.push_back({row_min, row_max, width - shifted_cols, width - 1});
+  } else if (cols < 0) {
+    strips.push_back({row_min, row_max, 0, shifted_cols - 1});
+  }
+
+  return strips;
+}
+
+/*
+ * Compute regions of the image.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy. Any parallel policy computes the rows of
+ * a region in parallel.
+ * @tparam T The scalar type.
+ * @tparam C The channels.
+ *
+ * @param params The parameters of the computation.
+ * @param out The output, pointing at the first pixel of the image.
+ * @param regions The regions, which must not overlap.
+ * @param mode The render mode, applied to each region separately.
+ * @param cancelled A flag that is checked before every row, or with
+ * subdivision before every rectangle, if any. Once it is set, the remaining
+ * pixels are skipped and left as they were.
+ *
+ * @returns The number of pixels that were iterated.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+std::size_t computeRegions(const KernelParams& params,
+                           const KernelOutput<T, C>& out,
+                           const std::vector<Rect>& regions,
+                           const RenderMode mode,
+                           const std::atomic<bool>* cancelled = nullptr) {
+  using K = Kernel<B, T, C>;
+
+  if constexpr (C::iterations) {
+    if (mode == RenderMode::Subdivision) {
+      subdivision::Renderer<B, Exec, T, C> renderer{params, out, cancelled};
+
+#if defined(MANDELBROT_HAS_OMP)
+      if constexpr (std::is_same_v<Exec, exec::OMP>) {
+#pragma omp parallel
+#pragma omp single
+        for (const Rect& region : regions) {
+          renderer.render(region);
+        }
+
+        return renderer.iterated();
+      }
+#endif
+
+      for (const Rect& region : regions) {
+        renderer.render(region);
+      }
+
+      return renderer.iterated();
+    }
+  }
+
+  [[maybe_unused]] constexpr bool parallel =
+      !std::is_same_v<Exec, exec::Default>;
+  std::size_t iterated{0};
+
+  for (const Rect& region : regions) {
+    const auto row_min = static_cast<std::ptrdiff_t>(region.row_min);
+    const auto row_max = static_cast<std::ptrdiff_t>(region.row_max);
+
+#if defined(MANDELBROT_HAS_OMP)
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+    for (std::ptrdiff_t row = row_min; row <= row_max; ++row) {
+      if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed)) {
+        continue;
+      }
+
+      const std::size_t idx =
+          static_cast<std::size_t>(row) * params.width + region.col_min;
+
+      K::compute(params, static_cast<std::size_t>(row), region.col_min,
+                 region.width(), out.at(idx));
+    }
+
+    iterated += region.width() * region.height();
+  }
+
+  return iterated;
+}
+
+/*
+ * Write zeros to a run of pixels in every channel of an output.
+ *
+ * @param out The output, pointing at the first pixel of the run.
+ * @param count The number of pixels.
+ */
+template <Scalar T, Channels C>
+void clearRun(const KernelOutput<T, C>& out, const std::size_t count) {
+  if constexpr (C::iterations) {
+    std::fill_n(out.iterations, count, typename C::Iteration{0});
+  }
+
+  if constexpr (C::z) {
+    std::fill_n(out.z_reals, count, T{0});
+    std::fill_n(out.z_imags, count, T{0});
+  }
+
+  if constexpr (C::smooth) {
+    std::fill_n(out.smooth, count, 0.0f);
+  }
+
+  if constexpr (C::distance) {
+    std::fill_n(out.distance, count, 0.0f);
+  }
+}
+
+/*
+ * Record the bounds and maximum iterations of a computation in the result
+ * file, if the results are mapped to one.
+ *
+ * @param host The results.
+ * @param bounds The bounds of the computation.
+ * @param max_iterations The maximum iterations of the computation.
+ */
+template <Backend B, Scalar T, Channels C>
+void describeResults(HostResources<B, T, C>& host, const ViewBounds& bounds,
+                     const unsigned int max_iterations) {
+  if (!host.mapping) {
+    return;
+  }
+
+  result_file::Header& header = host.mapping->header();
+  header.real_min = bounds.real_min;
+  header.real_max = bounds.real_max;
+  header.imag_min = bounds.imag_min;
+  header.imag_max = bounds.imag_max;
+  header.max_iterations = max_iterations;
+}
+
+/*
+ * Resume a list of pixels.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy. Any parallel policy resumes batches of
+ * the list in parallel.
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param out The output, pointing at the first pixel of the image.
+ * @param indices The indices of the pixels.
+ */
+template <Backend B, Execution Exec, Scalar T>
+void resumePixels(const KernelParams& params, const KernelOutput<T>& out,
+                  const std::vector<std::size_t>& indices) {
+  using K = Kernel<B, T>;
+
+  if constexpr (std::is_same_v<Exec, exec::Default>) {
+    K::resume(params, indices.data(), indices.size(), out);
+  }
+#if defined(MANDELBROT_HAS_OMP)
+  else {
+    const std::size_t batches =
+        (indices.size() + resume_batch - 1) / resume_batch;
+    const auto resume = [&](const std::size_t batch) {
+      const std::size_t first = batch * resume_batch;
+
+      K::resume(params, indices.data() + first,
+                std::min(resume_batch, indices.size() - first), out);
+    };
+
+    if constexpr (std::is_same_v<Exec, exec::OMP>) {
+#pragma omp parallel for schedule(dynamic)
+      for (std::size_t batch = 0; batch < batches; ++batch) {
+        resume(batch);
+      }
+    } else {
+      scheduler::runWorkStealing(batches, resume);
+    }
+  }
+#endif
+}
+
+/*
+ * Run `count` independent tasks with an execution policy.
+ *
+ * @tparam Exec The execution policy.
+ *
+ * @param count The number of tasks.
+ * @param task The task to run, called with the index of the task.
+ *
+ * @returns The statistics of each thread with work stealing, otherwise none.
+ */
+template <Execution Exec>
+std::vector<WorkerStats>
+runTasks(const std::size_t count,
+         const std::function<void(std::size_t)>& task) {
+#if defined(MANDELBROT_HAS_OMP)
+  if constexpr (std::is_same_v<Exec, exec::OMP>) {
+#pragma omp parallel for schedule(dynamic)
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      task(idx);
+    }
+
+    return {};
+  } else if constexpr (std::is_same_v<Exec, exec::WorkStealing>) {
+    return scheduler::runWorkStealing(count, task);
+  }
+#endif
+
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    task(idx);
+  }
+
+  return {};
+}
+
+/*
+ * Add the statistics of the threads during another run to their totals.
+ *
+ * @param totals The statistics so far.
+ * @param stats The statistics of the other run.
+ */
+void addStats(std::vector<WorkerStats>& totals,
+              const std::vector<WorkerStats>& stats) {
+  totals.resize(std::max(totals.size(), stats.size()));
+
+  for (std::size_t thread = 0; thread < stats.size(); ++thread) {
+    totals[thread].busy += stats[thread].busy;
+    totals[thread].idle += stats[thread].idle;
+    totals[thread].tasks += stats[thread].tasks;
+    totals[thread].steals += stats[thread].steals;
+  }
+}
+
+/*
+ * Get the positions of the samples of a supersampled pixel.
+ *
+ * @param factor The number of samples along each axis.
+ * @param pattern The placement of the samples.
+ *
+ * @returns The offsets of the samples to the center of the pixel, in pixels,
+ * along the rows and down the columns.
+ */
+std::vector<std::pair<double, double>>
+samplePositions(const unsigned int factor, const SamplePattern pattern) {
+  // A fixed seed, so that jittered images are reproducible.
+  std::mt19937 generator{5489u};
+  std::uniform_real_distribution<double> jitter{0.0, 1.0};
+
+  const auto position = [&](const unsigned int cell) {
+    const double offset =
+        pattern == SamplePattern::Jittered ? jitter(generator) : 0.5;
+
+    return (static_cast<double>(cell) + offset) / static_cast<double>(factor) -
+           0.5;
+  };
+
+  std::vector<std::pair<double, double>> positions;
+  positions.reserve(factor * factor);
+
+  for (unsigned int row = 0; row < factor; ++row) {
+    for (unsigned int col = 0; col < factor; ++col) {
+      const double x = position(col);
+      const double y = position(row);
+
+      positions.emplace_back(x, y);
+    }
+  }
+
+  return positions;
+}
+
+/*
+ * Move the bounds of a view by a fraction of a pixel.
+ *
+ * @param bounds The bounds of the view.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param x The offset along the rows, in pixels.
+ * @param y The offset down the columns, in pixels.
+ *
+ * @returns The moved bounds.
+ */
+ViewBounds offsetBounds(const ViewBounds& bounds, const std::size_t width,
+                        const std::size_t height, const double x,
+                        const double y) {
+  const double real = x * (bounds.real_max - bounds.real_min) /
+                      static_cast<double>(width - 1);
+  // The rows run from the top of the view down.
+  const double imag = -y * (bounds.imag_max - bounds.imag_min) /
+                      static_cast<double>(height - 1);
+
+  return {bounds.real_min + real, bounds.real_max + real,
+          bounds.imag_min + imag, bounds.imag_max + imag};
+}
+
+/*
+ * Find the pixels of a row that lie on an edge, see
+ * `MandelbrotEngine::set_supersampling`.
+ *
+ * @param smooth The smooth iteration counts of the image.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param row The row.
+ * @param max_iterations The maximum iterations.
+ * @param threshold The difference in smooth iteration counts above which
+ * neighbouring pixels lie on an edge.
+ * @param edges The indices of the pixels on an edge, appended to.
+ */
+void findEdges(const float* smooth, const std::size_t width,
+               const std::size_t height, const std::size_t row,
+               const unsigned int max_iterations, const float threshold,
+               std::vector<std::size_t>& edges) {
+  const auto max = static_cast<float>(max_iterations);
+  const std::size_t row_min = row == 0 ? 0 : row - 1;
+  const std::size_t row_max = std::min(row + 1, height - 1);
+
+  for (std::size_t col = 0; col < width; ++col) {
+    const float value = smooth[row * width + col];
+    const bool inside = value >= max;
+    const std::size_t col_min = col == 0 ? 0 : col - 1;
+    const std::size_t col_max = std::min(col + 1, width - 1);
+
+    bool edge = false;
+
+    for (std::size_t r = row_min; r <= row_max && !edge; ++r) {
+      for (std::size_t c = col_min; c <= col_max && !edge; ++c) {
+        const float neighbour = smooth[r * width + c];
+
+        edge = (neighbour >= max) != inside ||
+               std::abs(neighbour - value) > threshold;
+      }
+    }
+
+    if (edge) {
+      edges.push_back(row * width + col);
+    }
+  }
+}
+
+/*
+ * Compute the Mandelbrot set and color it row by row, supersampling the pixels
+ * on the edges if asked to.
+ *
+ * The image doesn't depend on the channels of the engine, so this is shared by
+ * all of them rather than instantiated for each.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy.
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param supersampling The number of samples along each axis of an edge pixel.
+ * @param pattern The placement of the samples.
+ * @param edge_threshold The difference of smooth iteration counts that makes
+ * an edge, see `MandelbrotEngine::set_supersampling`.
+ * @param colorizer The colorizer.
+ * @param format The pixel format.
+ * @param pixels The pixels of the image.
+ * @param iterated_pixels The number of pixels and samples that were iterated.
+ * @param supersampled_pixels The number of pixels that were supersampled.
+ *
+ * @returns The statistics of each thread with work stealing, otherwise none.
+ */
+template <Backend B, Execution Exec, Scalar T>
+std::vector<WorkerStats>
+renderImage(const KernelParams& params, const unsigned int supersampling,
+            const SamplePattern pattern, const float edge_threshold,
+            const Colorizer& colorizer, const PixelFormat format,
+            std::uint8_t* pixels, std::size_t& iterated_pixels,
+            std::size_t& supersampled_pixels) {
+  using K = Kernel<B, T, channels::Smooth>;
+  using Output = KernelOutput<T, channels::Smooth>;
+
+  const std::size_t width = params.width;
+  const std::size_t height = params.height;
+  const std::size_t bytes = bytesPerPixel(format);
+  const std::size_t stride = width * bytes;
+
+  iterated_pixels = width * height;
+  supersampled_pixels = 0;
+
+  if (supersampling == 1) {
+    return runTasks<Exec>(height, [&](const std::size_t row) {
+      thread_local std::vector<float> smooth;
+      smooth.resize(width);
+
+      K::compute(params, row, 0, width,
+                 Output{nullptr, nullptr, nullptr, smooth.data(), nullptr});
+      colorizer.colorize(smooth.data(), width, params.max_iterations, format,
+                         pixels + row * stride);
+    });
+  }
+
+  // Finding the edges needs the neighbouring rows, so the smooth iteration
+  // counts of the whole image are kept.
+  std::vector<float> smooth(width * height);
+  const Output out{nullptr, nullptr, nullptr, smooth.data(), nullptr};
+
+  std::vector<WorkerStats> stats =
+      runTasks<Exec>(height, [&](const std::size_t row) {
+        const std::size_t first = row * width;
+
+        K::compute(params, row, 0, width, out.at(first));
+        colorizer.colorize(smooth.data() + first, width, params.max_iterations,
+                           format, pixels + row * stride);
+      });
+
+  std::vector<std::vector<std::size_t>> row_edges(height);
+
+  addStats(stats, runTasks<Exec>(height, [&](const std::size_t row) {
+             findEdges(smooth.data(), width, height, row, params.max_iterations,
+                       edge_threshold, row_edges[row]);
+           }));
+
+  std::vector<std::size_t> edges;
+
+  for (const std::vector<std::size_t>& row : row_edges) {
+    edges.insert(edges.end(), row.begin(), row.end());
+  }
+
+  // Every position within the pixels is a view moved by a fraction of a
+  // pixel, so the samples are computed like the pixels of that view.
+  std::vector<KernelParams> samples;
+
+  for (const auto& [x, y] : samplePositions(supersampling, pattern)) {
+    KernelParams sample = params;
+    sample.bounds = offsetBounds(params.bounds, width, height, x, y);
+    samples.push_back(sample);
+  }
+
+  // The samples are colored with an alpha channel, which RGB8 drops.
+  const PixelFormat sample_format =
+      format == PixelFormat::Grey8 ? PixelFormat::Grey8 : PixelFormat::RGBA8;
+  const std::size_t sample_bytes = bytesPerPixel(sample_format);
+  const std::size_t count = samples.size();
+  const std::size_t batches =
+      (edges.size() + supersample_batch - 1) / supersample_batch;
+
+  addStats(stats, runTasks<Exec>(batches, [&](const std::size_t batch) {
+    const std::size_t first = batch * supersample_batch;
+    const std::size_t size = std::min(supersample_batch, edges.size() - first);
+    const std::size_t* indices = edges.data() + first;
+
+    thread_local std::vector<float> values;
+    thread_local std::vector<std::uint8_t> colors;
+    values.resize(size * count);
+    colors.resize(size * count * sample_bytes);
+
+    // The pixels of the batch are computed at one position at a time. The
+    // samples overwrite the smooth iteration counts of their pixels, which
+    // aren't needed anymore, and are gathered per pixel.
+    for (std::size_t sample = 0; sample < count; ++sample) {
+      K::compute(samples[sample], indices, size, out);
+
+      for (std::size_t idx = 0; idx < size; ++idx) {
+        values[idx * count + sample] = smooth[indices[idx]];
+      }
+    }
+
+    colorizer.colorize(values.data(), values.size(), params.max_iterations,
+                       sample_format, colors.data());
+
+    for (std::size_t idx = 0; idx < size; ++idx) {
+      const std::uint8_t* sample_colors =
+          colors.data() + idx * count * sample_bytes;
+      std::uint8_t* pixel = pixels + indices[idx] * bytes;
+
+      for (std::size_t channel = 0; channel < bytes; ++channel) {
+        std::size_t sum = count / 2;
+
+        for (std::size_t sample = 0; sample < count; ++sample) {
+          sum += sample_colors[sample * sample_bytes + channel];
+        }
+
+        pixel[channel] = static_cast<std::uint8_t>(sum / count);
+      }
+    }
+  }));
+
+  iterated_pixels += edges.size() * count;
+  supersampled_pixels = edges.size();
+
+  return stats;
+}
+} // namespace
+
+#if defined(MANDELBROT_HAS_OMP)
+namespace {
+/*
+ * Compute the image tile by tile, balancing the tiles over the threads with
+ * work stealing.
+ *
+ * @tparam B The backend.
+ * @tparam T The scalar type.
+ * @tparam C The channels.
+ *
+ * @param params The parameters of the computation.
+ * @param out The output, pointing at the first pixel of the image.
+ * @param tile_width The width of a tile.
+ * @param tile_height The height of a tile.
+ * @param mode The render mode, applied to each tile separately.
+ * @param placement The placement of the threads.
+ * @param place Whether to place the pages of the output on the NUMA nodes of
+ * the threads that start with their tiles, because it was just allocated.
+ * @param iterated_pixels The number of pixels that were iterated.
+ *
+ * @returns The statistics per thread.
+ */
+template <Backend B, Scalar T, Channels C>
+std::vector<WorkerStats>
+computeTiles(const KernelParams& params, const KernelOutput<T, C>& out,
+             std::size_t tile_width, const std::size_t tile_height,
+             const RenderMode mode, const ThreadPlacement placement,
+             const bool place, std::size_t& iterated_pixels) {
+  using K = Kernel<B, T, C>;
+
+  // Round the width up to whole vectors.
+  tile_width = (tile_width + K::lanes - 1) / K::lanes * K::lanes;
+
+  const std::size_t tiles_x = (params.width + tile_width - 1) / tile_width;
+  const std::size_t tiles_y = (params.height + tile_height - 1) / tile_height;
+
+  // The pixels of a tile.
+  const auto tile_rect = [&](const std::size_t tile) {
+    const std::size_t row_min = tile / tiles_x * tile_height;
+    const std::size_t col_min = tile % tiles_x * tile_width;
+
+    return Rect{row_min, std::min(row_min + tile_height, params.height) - 1,
+                col_min, std::min(col_min + tile_width, params.width) - 1};
+  };
+
+  if (place && placement != ThreadPlacement::None) {
+    scheduler::runPartitioned(
+        tiles_x * tiles_y,
+        [&](const std::size_t tile) {
+          const Rect rect = tile_rect(tile);
+
+          for (std::size_t row = rect.row_min; row <= rect.row_max; ++row) {
+            clearRun(out.at(row * params.width + rect.col_min), rect.width());
+          }
+        },
+        placement);
+  }
+
+  if constexpr (C::iterations) {
+    if (mode == RenderMode::Subdivision) {
+      subdivision::Renderer<B, exec::WorkStealing, T, C> renderer{params,
+                                                                  out};
+
+      std::vector<WorkerStats> stats = scheduler::runWorkStealing(
+          tiles_x * tiles_y,
+          [&](const std::size_t tile) { renderer.render(tile_rect(tile)); },
+          placement);
+      iterated_pixels = renderer.iterated();
+
+      return stats;
+    }
+  }
+
+  std::vector<WorkerStats> stats = scheduler::runWorkStealing(
+      tiles_x * tiles_y, [&](const std::size_t tile) {
+        const Rect rect = tile_rect(tile);
+
+        if (params.variant == KernelVariant::LaneRefill) {
+          // Queue the whole tile, so that lanes are refilled across its rows.
+          thread_local std::vector<std::size_t> indices;
+          indices.clear();
+
+          for (std::size_t row = rect.row_min; row <= rect.row_max; ++row) {
+            for (std::size_t col = rect.col_min; col <= rect.col_max; ++col) {
+              indices.push_back(row * params.width + col);
+            }
+          }
+
+          K::compute(params, indices.data(), indices.size(), out);
+          return;
+        }
+
+        for (std::size_t row = rect.row_min; row <= rect.row_max; ++row) {
+          K::compute(params, row, rect.col_min, rect.width(),
+                     out.at(row * params.width + rect.col_min));
+        }
+      },
+      placement);
+  iterated_pixels = params.width * params.height;
+
+  return stats;
+}
+} // namespace
+#endif
+
+/*
+ * Compute the Mandelbrot set.
+ *
+ * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+MandelbrotResult<B, T, C> MandelbrotEngine<B, Exec, T, C>::compute() {
+  using K = Kernel<B, T, C>;
+
+  [[maybe_unused]] const bool allocated = m_host.allocate();
+
+  const KernelParams params{m_width, m_height, m_bounds, m_max_iterations,
+                            m_interior_detection, m_kernel_variant,
+                            m_interleaving, boundary_distance(m_bounds),
+                            bailout_norm()};
+  const KernelOutput<T, C> out = makeOutput(m_host);
+
+  // Subdivision compares iteration counts.
+  const RenderMode mode = C::iterations ? m_render_mode : RenderMode::Full;
+
+#if defined(MANDELBROT_HAS_OMP)
+  if constexpr (std::is_same_v<Exec, exec::OMP>) {
+    if (allocated && m_thread_placement != ThreadPlacement::None) {
+      // Write every row from the thread that computes it, see below.
+#pragma omp parallel
+      {
+        const numa::ThreadPin pin{
+            m_thread_placement, static_cast<std::size_t>(omp_get_thread_num())};
+
+#pragma omp for schedule(static, 1)
+        for (std::size_t row = 0; row < m_height; ++row) {
+          clearRun(out.at(row * m_width), m_width);
+        }
+      }
+    }
+  }
+#endif
+
+  m_resumable_bounds = m_bounds;
+  describeResults(m_host, m_bounds, m_max_iterations);
+
+  // Reuse the previous pixels if the view was only panned.
+  const std::optional<ViewBounds> previous_bounds =
+      std::exchange(m_rendered_bounds, m_incremental
+                                           ? std::optional{m_bounds}
+                                           : std::nullopt);
+  std::ptrdiff_t shift_rows{0}, shift_cols{0};
+
+  if (previous_bounds && findPixelShift(*previous_bounds, m_bounds, m_width,
+                                        m_height, shift_rows, shift_cols)) {
+    if constexpr (C::iterations) {
+      shiftPixels(out.iterations, m_width, m_height, shift_rows, shift_cols);
+    }
+
+    if constexpr (C::z) {
+      shiftPixels(out.z_reals, m_width, m_height, shift_rows, shift_cols);
+      shiftPixels(out.z_imags, m_width, m_height, shift_rows, shift_cols);
+    }
+
+    if constexpr (C::smooth) {
+      shiftPixels(out.smooth, m_width, m_height, shift_rows, shift_cols);
+    }
+
+    if constexpr (C::distance) {
+      shiftPixels(out.distance, m_width, m_height, shift_rows, shift_cols);
+    }
+
+    m_iterated_pixels = computeRegions<B, Exec, T, C>(
+        params, out,
+        exposedStrips(m_width, m_height, shift_rows, shift_cols), mode);
+
+    return {m_host, m_width, m_height};
+  }
+
+  if (m_host.mapping) {
+    // Sweep the file from the front, a row per task, so that the threads write
+    // neighbouring pages.
+    if (mode == RenderMode::Full) {
+      m_host.mapping->advise_sequential();
+    }
+
+    m_iterated_pixels = computeRegions<B, Exec, T, C>(
+        params, out, {Rect{0, m_height - 1, 0, m_width - 1}}, mode);
+
+    return {m_host, m_width, m_height};
+  }
+
+#if defined(MANDELBROT_HAS_OMP)
+  if constexpr (std::is_same_v<Exec, exec::WorkStealing>) {
+    m_worker_stats = computeTiles<B, T, C>(
+        params, out, m_tile_width, m_tile_height, mode, m_thread_placement,
+        allocated, m_iterated_pixels);
+
+    return {m_host, m_width, m_height};
+  }
+#endif
+
+  if constexpr (C::iterations) {
+    if (mode == RenderMode::Subdivision) {
+      m_iterated_pixels =
+          subdivision::Renderer<B, Exec, T, C>{params, out}.render();
+
+      return {m_host, m_width, m_height};
+    }
+  }
+
+  m_iterated_pixels = m_width * m_height;
+
+  if constexpr (std::is_same_v<Exec, exec::Default>) {
+    for (std::size_t row = 0; row < m_height; ++row) {
+      K::compute(params, row, 0, m_width, out.at(row * m_width));
+    }
+  }
+#if defined(MANDELBROT_HAS_OMP)
+  else if constexpr (std::is_same_v<Exec, exec::OMP>) {
+    if (m_thread_placement != ThreadPlacement::None) {
+      // Hand out the rows in turn, so that a row is computed by the same
+      // thread every time, on the node that its memory was placed on.
+#pragma omp parallel
+      {
+        const numa::ThreadPin pin{
+            m_thread_placement, static_cast<std::size_t>(omp_get_thread_num())};
+
+#pragma omp for schedule(static, 1)
+        for (std::size_t row = 0; row < m_height; ++row) {
+          K::compute(params, row, 0, m_width, out.at(row * m_width));
+        }
+      }
+
+      return {m_host, m_width, m_height};
+    }
+
+    if (m_kernel_variant != KernelVariant::Block) {
+      // Hand out whole rows, so that lanes are refilled across the row, or
+      // vectors are interleaved.
+#pragma omp parallel for schedule(dynamic)
+      for (std::size_t row = 0; row < m_height; ++row) {
+        K::compute(params, row, 0, m_width, out.at(row * m_width));
+      }
+
+      return {m_host, m_width, m_height};
+    }
+
+#pragma omp parallel for collapse(2) schedule(guided)
+    for (std::size_t row = 0; row < m_height; ++row) {
+      for (std::size_t col = 0; col < m_width; col += K::lanes) {
+        K::compute(params, row, col, std::min(K::lanes, m_width - col),
+                   out.at(row * m_width + col));
+      }
+    }
+  }
+#endif
+
+  return {m_host, m_width, m_height};
+}
+
+/*
+ * Compute the Mandelbrot set into a buffer of its own, on another thread.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+std::future<std::optional<MandelbrotResult<B, T, C>>>
+MandelbrotEngine<B, Exec, T, C>::compute_async(const bool cancel_previous)
+  requires HostBackend<B>
+{
+  if (cancel_previous) {
+    cancel_async();
+  }
+
+  // A buffer is free once the pool holds the only reference to it.
+  auto free = std::ranges::find_if(m_async_buffers, [](const auto& buffer) {
+    return buffer.use_count() == 1;
+  });
+
+  std::shared_ptr<HostResources<B, T, C>> buffer =
+      free != m_async_buffers.end()
+          ? *free
+          : m_async_buffers.emplace_back(
+                std::make_shared<HostResources<B, T, C>>(m_width * m_height,
+                                                         m_arena));
+  buffer->resize(m_width * m_height);
+  buffer->allocate();
+
+  const KernelParams params{m_width, m_height, m_bounds, m_max_iterations,
+                            m_interior_detection, m_kernel_variant,
+                            m_interleaving, boundary_distance(m_bounds),
+                            bailout_norm()};
+  const RenderMode mode = C::iterations ? m_render_mode : RenderMode::Full;
+  const std::size_t width = m_width;
+  const std::size_t height = m_height;
+
+  m_async_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+  return std::async(
+      std::launch::async,
+      [=, cancelled = m_async_cancelled]()
+          -> std::optional<MandelbrotResult<B, T, C>> {
+        computeRegions<B, Exec, T, C>(params, makeOutput(*buffer),
+                                      {Rect{0, height - 1, 0, width - 1}},
+                                      mode, cancelled.get());
+
+        // A cancelled computation skipped the rest of its pixels.
+        if (cancelled->load()) {
+          return std::nullopt;
+        }
+
+        return MandelbrotResult<B, T, C>{buffer, width, height};
+      });
+}
+
+/*
+ * Continue the last computation up to a higher maximum iterations.
+ *
+ * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+MandelbrotResult<B, T>
+MandelbrotEngine<B, Exec, T, C>::resume(const unsigned int max_iterations)
+  requires std::is_same_v<C, channels::Full>
+{
+  if (max_iterations < m_max_iterations) {
+    throw std::invalid_argument(
+        std::format("Cannot resume from {} down to {} iterations.",
+                    m_max_iterations, max_iterations));
+  }
+
+  if (m_resumable_bounds != m_bounds) {
+    m_max_iterations = max_iterations;
+    return compute();
+  }
+
+  const KernelParams params{m_width, m_height, m_bounds, max_iterations,
+                            m_interior_detection, m_kernel_variant,
+                            m_interleaving, boundary_distance(m_bounds),
+                            bailout_norm()};
+  const KernelOutput<T> out = makeOutput(m_host);
+
+  // Only the pixels that reached the maximum iterations may iterate further.
+  std::vector<std::size_t> indices;
+
+  for (std::size_t idx = 0; idx < m_width * m_height; ++idx) {
+    if (out.iterations[idx] == m_max_iterations) {
+      indices.push_back(idx);
+    }
+  }
+
+  if (m_render_mode == RenderMode::Subdivision) {
+    for (const std::size_t idx : indices) {
+      out.iterations[idx] = 0;
+      out.z_reals[idx] = T{0};
+      out.z_imags[idx] = T{0};
+    }
+  }
+
+  m_max_iterations = max_iterations;
+  m_iterated_pixels = indices.size();
+  describeResults(m_host, m_bounds, m_max_iterations);
+
+  resumePixels<B, Exec, T>(params, out, indices);
+
+  return {m_host, m_width, m_height};
+}
+
+/*
+ * Store the results of the engine in a file.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+void MandelbrotEngine<B, Exec, T, C>::map_results(
+    const std::filesystem::path& path)
+  requires HostBackend<B> && std::is_same_v<C, channels::Full>
+{
+  m_host.map(result_file::Mapping::create(
+      path, result_file::makeHeader(m_width, m_height, sizeof(T))));
+
+  m_rendered_bounds.reset();
+  m_resumable_bounds.reset();
+}
+
+/*
+ * Compute the Mandelbrot set in bands of rows.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+void MandelbrotEngine<B, Exec, T, C>::compute_bands(
+    const std::size_t band_height,
+    const std::function<void(const MandelbrotBand<T>&)>& sink)
+  requires HostBackend<B> && std::is_same_v<C, channels::Full>
+{
+  using K = Kernel<B, T>;
+
+  const std::size_t rows_per_band = std::max<std::size_t>(band_height, 1);
+  const std::size_t bands = (m_height + rows_per_band - 1) / rows_per_band;
+
+  const KernelParams params{m_width, m_height, m_bounds, m_max_iterations,
+                            m_interior_detection, m_kernel_variant,
+                            m_interleaving, boundary_distance(m_bounds),
+                            bailout_norm()};
+
+  // Compute a band into buffers of the size of one band.
+  const auto compute_band = [&](const std::size_t band,
+                                HostResources<B, T>& buffers) {
+    const std::size_t first_row = band * rows_per_band;
+    const std::size_t rows = std::min(rows_per_band, m_height - first_row);
+    const KernelOutput<T> out = makeOutput(buffers);
+
+    for (std::size_t row = 0; row < rows; ++row) {
+      K::compute(params, first_row + row, 0, m_width, out.at(row * m_width));
+    }
+
+    return MandelbrotBand<T>{first_row,      m_width,     rows,
+                             out.iterations, out.z_reals, out.z_imags};
+  };
+
+  m_iterated_pixels = m_width * m_height;
+
+  if constexpr (std::is_same_v<Exec, exec::Default>) {
+    HostResources<B, T> buffers{m_width * rows_per_band, m_arena};
+    buffers.allocate();
+
+    for (std::size_t band = 0; band < bands; ++band) {
+      sink(compute_band(band, buffers));
+    }
+  }
+#if defined(MANDELBROT_HAS_OMP)
+  else {
+    // Every thread computes into its own buffers, and hands its band over once
+    // the bands before it have been.
+#pragma omp parallel
+    {
+      HostResources<B, T> buffers{m_width * rows_per_band, m_arena};
+      buffers.allocate();
+
+#pragma omp for ordered schedule(dynamic)
+      for (std::size_t band = 0; band < bands; ++band) {
+        const MandelbrotBand<T> result = compute_band(band, buffers);
+
+#pragma omp ordered
+        sink(result);
+      }
+    }
+  }
+#endif
+}
+
+/*
+ * Compute a sequence of frames, overlapping the end of each frame with the
+ * start of the next.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+void MandelbrotEngine<B, Exec, T, C>::compute_batch(
+    const std::span<const ViewBounds> frames,
+    const std::function<void(std::size_t, const MandelbrotResult<B, T, C>&)>&
+        sink)
+  requires HostBackend<B>
+{
+  using K = Kernel<B, T, C>;
+
+  const auto frame_params = [&](const std::size_t frame) {
+    return KernelParams{m_width,
+                        m_height,
+                        frames[frame],
+                        m_max_iterations,
+                        m_interior_detection,
+                        m_kernel_variant,
+                        m_interleaving,
+                        boundary_distance(frames[frame]),
+                        bailout_norm()};
+  };
+
+  m_iterated_pixels = frames.size() * m_width * m_height;
+
+  if (frames.empty()) {
+    return;
+  }
+
+  const std::size_t depth = std::min(frames.size(), frames_in_flight);
+
+  while (m_frames.size() < depth) {
+    m_frames.emplace_back(m_width * m_height, m_arena);
+  }
+
+  // The size of the image may have changed since the last batch.
+  for (HostResources<B, T, C>& frame : m_frames) {
+    frame.resize(m_width * m_height);
+    frame.allocate();
+  }
+
+  if constexpr (std::is_same_v<Exec, exec::Default>) {
+    const KernelOutput<T, C> out = makeOutput(m_frames.front());
+
+    for (std::size_t frame = 0; frame < frames.size(); ++frame) {
+      const KernelParams params = frame_params(frame);
+
+      for (std::size_t row = 0; row < m_height; ++row) {
+        K::compute(params, row, 0, m_width, out.at(row * m_width));
+      }
+
+      sink(frame, {m_frames.front(), m_width, m_height});
+    }
+  }
+#if defined(MANDELBROT_HAS_OMP)
+  else {
+    // Round the width up to whole vectors.
+    const std::size_t tile_width =
+        (m_tile_width + K::lanes - 1) / K::lanes * K::lanes;
+    const std::size_t tiles_x = (m_width + tile_width - 1) / tile_width;
+    const std::size_t tiles =
+        tiles_x * ((m_height + m_tile_height - 1) / m_tile_height);
+
+    std::vector<KernelOutput<T, C>> outputs;
+
+    for (std::size_t slot = 0; slot < depth; ++slot) {
+      outputs.push_back(makeOutput(m_frames[slot]));
+    }
+
+    // The tiles of every frame, frame after frame.
+    std::atomic<std::size_t> next_task{0};
+
+    // The number of tiles of the frame in each buffer that aren't finished.
+    std::vector<std::atomic<std::size_t>> remaining(depth);
+
+    for (std::atomic<std::size_t>& count : remaining) {
+      count.store(tiles);
+    }
+
+    // The number of frames handed to the sink. A buffer can be reused once
+    // the frame in it has been handed over.
+    std::atomic<std::size_t> delivered{0};
+
+    std::mutex delivery;
+    std::vector<bool> finished(frames.size(), false);
+
+#pragma omp parallel
+    for (std::size_t task = next_task++; task < frames.size() * tiles;
+         task = next_task++) {
+      const std::size_t frame = task / tiles;
+      const std::size_t tile = task % tiles;
+      const std::size_t slot = frame % depth;
+
+      for (std::size_t handed = delivered.load(); handed + depth <= frame;
+           handed = delivered.load()) {
+        delivered.wait(handed);
+      }
+
+      const KernelParams params = frame_params(frame);
+      const std::size_t row_min = tile / tiles_x * m_tile_height;
+      const std::size_t row_max = std::min(row_min + m_tile_height, m_height);
+      const std::size_t col_min = tile % tiles_x * tile_width;
+      const std::size_t cols = std::min(tile_width, m_width - col_min);
+
+      for (std::size_t row = row_min; row < row_max; ++row) {
+        K::compute(params, row, col_min, cols,
+                   outputs[slot].at(row * m_width + col_min));
+      }
+
+      if (remaining[slot].fetch_sub(1) != 1) {
+        continue;
+      }
+
+      // The last tile of the frame. Hand over the frames that are finished,
+      // up to the first one that isn't.
+      const std::lock_guard lock{delivery};
+      finished[frame] = true;
+
+      for (std::size_t next = delivered.load();
+           next < frames.size() && finished[next]; ++next) {
+        sink(next, {m_frames[next % depth], m_width, m_height});
+
+        remaining[next % depth].store(tiles);
+        delivered.store(next + 1);
+        delivered.notify_all();
+      }
+    }
+  }
+#endif
+}
+
+/*
+ * Compute the Mandelbrot set and color it row by row.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> &&
+           SupportsChannels<B, C>
+void MandelbrotEngine<B, Exec, T, C>::compute_image(
+    const Colorizer& colorizer, const PixelFormat format, std::uint8_t* pixels)
+  requires HostBackend<B>
+{
+  const KernelParams params{m_width, m_height, m_bounds, m_max_iterations,
+                            m_interior_detection, m_kernel_variant,
+                            m_interleaving, boundary_distance(m_bounds),
+                            bailout_norm()};
+
+  m_worker_stats = renderImage<B, Exec, T>(
+      params, m_supersampling, m_sample_pattern, m_edge_threshold, colorizer,
+      format, pixels, m_iterated_pixels, m_supersampled_pixels);
+}
+
+#define INSTANTIATE_BATCH(B, Exec, T, C)                                       \
+  template std::future<std::optional<MandelbrotResult<B, T, C>>>               \
+  MandelbrotEngine<B, Exec, T, C>::compute_async(bool);                        \
+  template void MandelbrotEngine<B, Exec, T, C>::compute_batch(                \
+      std::span<const ViewBounds>,                                             \
+      const std::function<void(std::size_t,                                    \
+                               const MandelbrotResult<B, T, C>&)>&);
+
+// The full channels support every operation of the engine.
+#define INSTANTIATE_ENGINE(B, Exec, T)                                         \
+  template MandelbrotResult<B, T> MandelbrotEngine<B, Exec, T>::compute();     \
+  template MandelbrotResult<B, T> MandelbrotEngine<B, Exec, T>::resume(        \
+      unsigned int);                                                           \
+  template void MandelbrotEngine<B, Exec, T>::compute_bands(                   \
+      std::size_t, const std::function<void(const MandelbrotBand<T>&)>&);      \
+  template void MandelbrotEngine<B, Exec, T>::map_results(                     \
+      const std::filesystem::path&);                                           \
+  template void MandelbrotEngine<B, Exec, T>::compute_image(                   \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  INSTANTIATE_BATCH(B, Exec, T, channels::Full)
+
+// The compact channels only support `compute()`, `compute_async()`,
+// `compute_batch()` and `compute_image()`.
+#define INSTANTIATE_CHANNELS(B, Exec)                                          \
+  template MandelbrotResult<B, float, channels::Iterations>                    \
+  MandelbrotEngine<B, Exec, float, channels::Iterations>::compute();           \
+  template MandelbrotResult<B, double, channels::Iterations>                   \
+  MandelbrotEngine<B, Exec, double, channels::Iterations>::compute();          \
+  template MandelbrotResult<B, float, channels::Iterations16>                  \
+  MandelbrotEngine<B, Exec, float, channels::Iterations16>::compute();         \
+  template MandelbrotResult<B, double, channels::Iterations16>                 \
+  MandelbrotEngine<B, Exec, double, channels::Iterations16>::compute();        \
+  template MandelbrotResult<B, float, channels::Smooth>                        \
+  MandelbrotEngine<B, Exec, float, channels::Smooth>::compute();               \
+  template MandelbrotResult<B, double, channels::Smooth>                       \
+  MandelbrotEngine<B, Exec, double, channels::Smooth>::compute();              \
+  template MandelbrotResult<B, float, channels::Distance>                      \
+  MandelbrotEngine<B, Exec, float, channels::Distance>::compute();             \
+  template MandelbrotResult<B, double, channels::Distance>                     \
+  MandelbrotEngine<B, Exec, double, channels::Distance>::compute();            \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, float, channels::Iterations>::compute_image(       \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, double, channels::Iterations>::compute_image(      \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, float, channels::Iterations16>::compute_image(     \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, double, channels::Iterations16>::compute_image(    \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, float, channels::Smooth>::compute_image(           \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, double, channels::Smooth>::compute_image(          \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, float, channels::Distance>::compute_image(         \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  template void                                                                \
+  MandelbrotEngine<B, Exec, double, channels::Distance>::compute_image(        \
+      const Colorizer&, PixelFormat, std::uint8_t*);                           \
+  INSTANTIATE_BATCH(B, Exec, float, channels::Iterations)                      \
+  INSTANTIATE_BATCH(B, Exec, double, channels::Iterations)                     \
+  INSTANTIATE_BATCH(B, Exec, float, channels::Iterations16)                    \
+  INSTANTIATE_BATCH(B, Exec, double, channels::Iterations16)                   \
+  INSTANTIATE_BATCH(B, Exec, float, channels::Smooth)                          \
+  INSTANTIATE_BATCH(B, Exec, double, channels::Smooth)                         \
+  INSTANTIATE_BATCH(B, Exec, float, channels::Distance)                        \
+  INSTANTIATE_BATCH(B, Exec, double, channels::Distance)
+
+INSTANTIATE_ENGINE(backend::Serial, exec::Default, float)
+INSTANTIATE_ENGINE(backend::Serial, exec::Default, double)
+INSTANTIATE_CHANNELS(backend::Serial, exec::Default)
+
+#if defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::Serial, exec::OMP, float)
+INSTANTIATE_ENGINE(backend::Serial, exec::OMP, double)
+INSTANTIATE_CHANNELS(backend::Serial, exec::OMP)
+INSTANTIATE_ENGINE(backend::Serial, exec::WorkStealing, float)
+INSTANTIATE_ENGINE(backend::Serial, exec::WorkStealing, double)
+INSTANTIATE_CHANNELS(backend::Serial, exec::WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX2)
+INSTANTIATE_ENGINE(backend::AVX2, exec::Default, float)
+INSTANTIATE_ENGINE(backend::AVX2, exec::Default, double)
+INSTANTIATE_CHANNELS(backend::AVX2, exec::Default)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX2) && defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::AVX2, exec::OMP, float)
+INSTANTIATE_ENGINE(backend::AVX2, exec::OMP, double)
+INSTANTIATE_CHANNELS(backend::AVX2, exec::OMP)
+INSTANTIATE_ENGINE(backend::AVX2, exec::WorkStealing, float)
+INSTANTIATE_ENGINE(backend::AVX2, exec::WorkStealing, double)
+INSTANTIATE_CHANNELS(backend::AVX2, exec::WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+INSTANTIATE_ENGINE(backend::AVX512, exec::Default, float)
+INSTANTIATE_ENGINE(backend::AVX512, exec::Default, double)
+INSTANTIATE_CHANNELS(backend::AVX512, exec::Default)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512) && defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::AVX512, exec::OMP, float)
+INSTANTIATE_ENGINE(backend::AVX512, exec::OMP, double)
+INSTANTIATE_CHANNELS(backend::AVX512, exec::OMP)
+INSTANTIATE_ENGINE(backend::AVX512, exec::WorkStealing, float)
+INSTANTIATE_ENGINE(backend::AVX512, exec::WorkStealing, double)
+INSTANTIATE_CHANNELS(backend::AVX512, exec::WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+INSTANTIATE_ENGINE(backend::Portable, exec::Default, float)
+INSTANTIATE_ENGINE(backend::Portable, exec::Default, double)
+INSTANTIATE_CHANNELS(backend::Portable, exec::Default)
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE) && defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::Portable, exec::OMP, float)
+INSTANTIATE_ENGINE(backend::Portable, exec::OMP, double)
+INSTANTIATE_CHANNELS(backend::Portable, exec::OMP)
+INSTANTIATE_ENGINE(backend::Portable, exec::WorkStealing, float)
+INSTANTIATE_ENGINE(backend::Portable, exec::WorkStealing, double)
+INSTANTIATE_CHANNELS(backend::Portable, exec::WorkStealing)
+#endif
+
+#undef INSTANTIATE_CHANNELS
+#undef INSTANTIATE_ENGINE
+#undef INSTANTIATE_BATCH
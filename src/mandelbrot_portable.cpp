@@ -0,0 +1,1303 @@
+/*
+ * This file contains the portable SIMD implementation.
+ *
+ * The kernels are written once against `std::experimental::simd`, and compiled
+ * for the instruction set selected by `MANDELBROT_PORTABLE_FLAGS`, from SSE2
+ * up to AVX512. Vectors always hold 64 bytes, so that the number of lanes
+ * doesn't depend on the instruction set. Narrower instruction sets split each
+ * vector over several registers, which also hides the latency of every
+ * iteration.
+ *
+ * GCC doesn't inline the operations on fixed-size vectors consistently, which
+ * spills every vector to memory. The loops that iterate are therefore
+ * flattened, and iterate local vectors rather than the ones of the caller.
+ */
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <experimental/simd>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "backends.hpp"
+#include "kernels.hpp"
+#include "utility.hpp"
+
+namespace stdx = std::experimental;
+
+bool backend::Portable::is_available() {
+  // Every instruction set that the kernels were compiled for.
+  return true
+#if defined(__SSE3__)
+         && __builtin_cpu_supports("sse3")
+#endif
+#if defined(__SSSE3__)
+         && __builtin_cpu_supports("ssse3")
+#endif
+#if defined(__SSE4_1__)
+         && __builtin_cpu_supports("sse4.1")
+#endif
+#if defined(__SSE4_2__)
+         && __builtin_cpu_supports("sse4.2")
+#endif
+#if defined(__AVX__)
+         && __builtin_cpu_supports("avx")
+#endif
+#if defined(__AVX2__)
+         && __builtin_cpu_supports("avx2")
+#endif
+#if defined(__FMA__)
+         && __builtin_cpu_supports("fma")
+#endif
+#if defined(__AVX512F__)
+         && __builtin_cpu_supports("avx512f")
+#endif
+      ;
+}
+
+namespace {
+template <Scalar T>
+constexpr std::size_t lanes = Kernel<backend::Portable, T>::lanes;
+
+template <Scalar T> using Vec = stdx::fixed_size_simd<T, lanes<T>>;
+template <Scalar T> using Mask = typename Vec<T>::mask_type;
+
+// The native registers that a vector is split over.
+template <Scalar T>
+constexpr std::size_t registers = lanes<T> / stdx::native_simd<T>::size();
+
+// Iteration counts are kept in lanes of the same width as the scalar type, so
+// that converting masks between both doesn't move any data.
+template <Scalar T>
+using CountElement =
+    std::conditional_t<std::is_same_v<T, float>, std::int32_t, std::int64_t>;
+template <Scalar T>
+using Count = stdx::fixed_size_simd<CountElement<T>, lanes<T>>;
+template <Scalar T> using CountMask = typename Count<T>::mask_type;
+
+constexpr auto element_aligned = stdx::element_aligned;
+
+/*
+ * Get the lanes of a mask as bits.
+ *
+ * @param k The mask.
+ *
+ * @returns The mask, one bit per lane.
+ */
+template <Scalar T> unsigned int maskBits(const Mask<T>& k) {
+  unsigned int bits{0};
+
+  for (std::size_t lane = 0; lane < lanes<T>; ++lane) {
+    bits |= static_cast<unsigned int>(k[lane]) << lane;
+  }
+
+  return bits;
+}
+
+/*
+ * Get a mask from its lanes as bits.
+ *
+ * @param bits The mask, one bit per lane.
+ *
+ * @returns The mask.
+ */
+template <Scalar T> Mask<T> maskFromBits(const unsigned int bits) {
+  const Count<T> lane_bits(
+      [](const auto lane) { return CountElement<T>{1} << lane; });
+
+  return Mask<T>((Count<T>(static_cast<CountElement<T>>(bits)) & lane_bits) ==
+                 lane_bits);
+}
+
+/*
+ * Map a row to the imaginary axis.
+ *
+ * Consecutive and arbitrary pixels are both mapped through this function, so
+ * that their coordinates are identical.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row.
+ *
+ * @returns The imaginary coordinate.
+ */
+template <Scalar T>
+T mapRowToImag(const KernelParams& params, const std::size_t row) {
+  return utility::mapIndexToAxis(row, params.height,
+                                 static_cast<T>(params.bounds.imag_max),
+                                 static_cast<T>(params.bounds.imag_min));
+}
+
+/*
+ * Map the columns of a vector of pixels to the real axis.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param cols The columns.
+ *
+ * @returns The real coordinates.
+ */
+template <Scalar T>
+Vec<T> mapColumnsToReal(const KernelParams& params, const Vec<T>& cols) {
+  const auto real_min = static_cast<T>(params.bounds.real_min);
+  const T real_scale = utility::axisSpacing(
+      params.width, real_min, static_cast<T>(params.bounds.real_max));
+
+  return cols * real_scale + real_min;
+}
+
+/*
+ * Map consecutive pixels in the same row onto the complex plane.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ *
+ * @returns The mapped positions of one vector of pixels.
+ */
+template <Scalar T>
+std::pair<Vec<T>, Vec<T>> mapPixels(const KernelParams& params,
+                                    const std::size_t row,
+                                    const std::size_t col) {
+  const Vec<T> cols(
+      [col](const auto lane) { return static_cast<T>(col + lane); });
+
+  return {mapColumnsToReal<T>(params, cols),
+          Vec<T>(mapRowToImag<T>(params, row))};
+}
+
+/*
+ * Map up to one vector of arbitrary pixels onto the complex plane.
+ *
+ * Unused lanes repeat the last pixel. The mapping is identical to the one for
+ * consecutive pixels.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at least one and at most the number of
+ * lanes.
+ *
+ * @returns The mapped positions of the pixels.
+ */
+template <Scalar T>
+std::pair<Vec<T>, Vec<T>> mapPixels(const KernelParams& params,
+                                    const std::size_t* indices,
+                                    const std::size_t count) {
+  const auto index = [&](const std::size_t lane) {
+    return indices[std::min(lane, count - 1)];
+  };
+
+  const Vec<T> cols([&](const auto lane) {
+    return static_cast<T>(index(lane) % params.width);
+  });
+  const Vec<T> imags([&](const auto lane) {
+    return mapRowToImag<T>(params, index(lane) / params.width);
+  });
+
+  return {mapColumnsToReal<T>(params, cols), imags};
+}
+
+/*
+ * Calculate the norms of a vector of complex numbers.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns The norms.
+ */
+template <Scalar T> Vec<T> norm(const Vec<T>& real, const Vec<T>& imag) {
+  return real * real + imag * imag;
+}
+
+/*
+ * Check which of a vector of points lie within the main cardioid or the
+ * period-2 bulb of the Mandelbrot set.
+ *
+ * @param real The real parts.
+ * @param imag The imaginary parts.
+ *
+ * @returns The lanes of the points within the main cardioid or period-2 bulb.
+ */
+template <Scalar T>
+Mask<T> isInMainCardioidOrBulb(const Vec<T>& real, const Vec<T>& imag) {
+  const Vec<T> real_shifted = real - T{0.25};
+  const Vec<T> imag_squared = imag * imag;
+  const Vec<T> q = real_shifted * real_shifted + imag_squared;
+  const Vec<T> real_bulb = real + T{1};
+
+  return q * (q + real_shifted) <= T{0.25} * imag_squared ||
+         real_bulb * real_bulb + imag_squared <= T{0.0625};
+}
+
+/*
+ * Advance a vector of points by one iteration.
+ *
+ * The real part is computed as (z_real + z_imag) * (z_real - z_imag) + c_real,
+ * so that no sum has more than two terms. Fast math then has nothing to
+ * reorder, and can at most contract a product and the sum it feeds into a
+ * fused multiply-add. Every kernel iterates with it, so that they round alike
+ * however it is inlined and unrolled.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param z_real The real parts of the z-values.
+ * @param z_imag The imaginary parts of the z-values.
+ */
+template <Scalar T>
+void step(const Vec<T>& c_real, const Vec<T>& c_imag, Vec<T>& z_real,
+          Vec<T>& z_imag) {
+  const Vec<T> z_real_new = (z_real + z_imag) * (z_real - z_imag) + c_real;
+  z_imag = (z_real + z_real) * z_imag + c_imag;
+  z_real = z_real_new;
+}
+
+/*
+ * Iterate a vector of points until they escape or reach the maximum
+ * iterations.
+ *
+ * With interior detection enabled, lanes within the main cardioid or period-2
+ * bulb are retired before iterating, and the orbits are checked for
+ * periodicity using Brent's method. A lane whose orbit repeats exactly is
+ * retired as interior, keeping its z-value at the time of detection.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Derivative Whether to track the derivatives of the orbits.
+ *
+ * @param params The parameters of the computation.
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param dz_real The real parts of the final derivatives, if tracked.
+ * @param dz_imag The imaginary parts of the final derivatives, if tracked.
+ *
+ * @returns The iteration counts.
+ */
+template <Scalar T, bool InteriorDetection, bool Derivative = false>
+[[gnu::flatten]]
+Count<T> iterate(const KernelParams& params, const Vec<T>& c_real,
+                 const Vec<T>& c_imag, Vec<T>& z_real, Vec<T>& z_imag,
+                 [[maybe_unused]] Vec<T>* dz_real = nullptr,
+                 [[maybe_unused]] Vec<T>* dz_imag = nullptr) {
+  const auto bailout = static_cast<T>(params.bailout_norm);
+
+  z_real = 0;
+  z_imag = 0;
+
+  if constexpr (Derivative) {
+    *dz_real = 0;
+    *dz_imag = 0;
+  }
+
+  Count<T> iter_counts = 0;
+
+  // Lanes that are known to never escape.
+  Mask<T> interior(false);
+
+  [[maybe_unused]] Vec<T> z_real_saved = z_real;
+  [[maybe_unused]] Vec<T> z_imag_saved = z_imag;
+  [[maybe_unused]] unsigned int save_at{1};
+
+  if constexpr (InteriorDetection) {
+    interior = isInMainCardioidOrBulb(c_real, c_imag);
+  }
+
+  for (unsigned int i = 0; i < params.max_iterations; ++i) {
+    // Check which pixels have not escaped yet.
+    Mask<T> active = norm(z_real, z_imag) <= bailout;
+
+    if constexpr (InteriorDetection) {
+      active = active && !interior;
+    }
+
+    // If all pixels have escaped, stop early.
+    if (stdx::none_of(active)) {
+      break;
+    }
+
+    // Only update the iteration count for active pixels.
+    where(CountMask<T>(active), iter_counts) += 1;
+
+    if constexpr (Derivative) {
+      // dz = 2 * z * dz + 1, from the z-values before this iteration.
+      const Vec<T> z_real_2 = z_real + z_real;
+      const Vec<T> z_imag_2 = z_imag + z_imag;
+      const Vec<T> dz_real_new =
+          z_real_2 * *dz_real - z_imag_2 * *dz_imag + T{1};
+      const Vec<T> dz_imag_new = z_real_2 * *dz_imag + z_imag_2 * *dz_real;
+
+      where(active, *dz_real) = dz_real_new;
+      where(active, *dz_imag) = dz_imag_new;
+    }
+
+    // Only update the real and imaginary parts for active pixels.
+    Vec<T> z_real_new = z_real;
+    Vec<T> z_imag_new = z_imag;
+    step<T>(c_real, c_imag, z_real_new, z_imag_new);
+
+    where(active, z_real) = z_real_new;
+    where(active, z_imag) = z_imag_new;
+
+    if constexpr (InteriorDetection) {
+      // An active orbit that returns exactly to its saved point is periodic.
+      interior = interior || (active && z_real == z_real_saved &&
+                              z_imag == z_imag_saved);
+
+      if (i + 1 == save_at) {
+        z_real_saved = z_real;
+        z_imag_saved = z_imag;
+        save_at <<= 1;
+      }
+    }
+  }
+
+  if constexpr (InteriorDetection) {
+    where(CountMask<T>(interior), iter_counts) =
+        static_cast<CountElement<T>>(params.max_iterations);
+  }
+
+  return iter_counts;
+}
+
+/*
+ * Store the results of up to one vector of consecutive pixels.
+ *
+ * Full vectors of iteration counts and z-values are stored directly. Partial
+ * vectors and the smooth iteration counts are stored per lane.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, Channels C>
+void storeBlock(const std::size_t count, const Count<T>& iter_counts,
+                const Vec<T>& z_real, const Vec<T>& z_imag,
+                const unsigned int max_iterations,
+                const KernelOutput<T, C>& out) {
+  if (count == lanes<T> && !C::smooth) {
+    if constexpr (C::iterations) {
+      using Iterations =
+          stdx::fixed_size_simd<typename C::Iteration, lanes<T>>;
+
+      stdx::static_simd_cast<Iterations>(iter_counts)
+          .copy_to(out.iterations, element_aligned);
+    }
+
+    if constexpr (C::z) {
+      z_real.copy_to(out.z_reals, element_aligned);
+      z_imag.copy_to(out.z_imags, element_aligned);
+    }
+
+    return;
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, i, static_cast<unsigned int>(iter_counts[i]), z_real[i],
+               z_imag[i], max_iterations);
+  }
+}
+
+/*
+ * Store the results of up to one vector of arbitrary pixels.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param max_iterations The maximum iterations.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, Channels C>
+void storeList(const std::size_t* indices, const std::size_t count,
+               const Count<T>& iter_counts, const Vec<T>& z_real,
+               const Vec<T>& z_imag, const unsigned int max_iterations,
+               const KernelOutput<T, C>& out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, indices[i], static_cast<unsigned int>(iter_counts[i]),
+               z_real[i], z_imag[i], max_iterations);
+  }
+}
+
+/*
+ * Store the results of up to one vector of pixels with their distance
+ * estimates, which are computed per lane.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param indices The indices of the pixels, or null for consecutive pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param iter_counts The iteration counts.
+ * @param z_real The real parts of the final z-values.
+ * @param z_imag The imaginary parts of the final z-values.
+ * @param dz_real The real parts of the final derivatives.
+ * @param dz_imag The imaginary parts of the final derivatives.
+ * @param params The parameters of the computation.
+ * @param out The output, pointing at the first pixel, or at the first pixel of
+ * the image with indices.
+ */
+template <Scalar T, Channels C>
+void storeDistances(const std::size_t* indices, const std::size_t count,
+                    const Count<T>& iter_counts, const Vec<T>& z_real,
+                    const Vec<T>& z_imag, const Vec<T>& dz_real,
+                    const Vec<T>& dz_imag, const KernelParams& params,
+                    const KernelOutput<T, C>& out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    storePixel(out, indices != nullptr ? indices[i] : i,
+               static_cast<unsigned int>(iter_counts[i]), z_real[i],
+               z_imag[i], dz_real[i], dz_imag[i], params);
+  }
+}
+
+/*
+ * Compute up to one vector of consecutive pixels in the same row.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, bool InteriorDetection, Channels C>
+void computeBlock(const KernelParams& params, const std::size_t row,
+                  const std::size_t col, const std::size_t count,
+                  const KernelOutput<T, C>& out) {
+  const auto [c_real, c_imag] = mapPixels<T>(params, row, col);
+
+  Vec<T> z_real, z_imag;
+
+  if constexpr (C::distance) {
+    Vec<T> dz_real, dz_imag;
+    const Count<T> iter_counts = iterate<T, InteriorDetection, true>(
+        params, c_real, c_imag, z_real, z_imag, &dz_real, &dz_imag);
+
+    storeDistances(nullptr, count, iter_counts, z_real, z_imag, dz_real,
+                   dz_imag, params, out);
+  } else {
+    const Count<T> iter_counts =
+        iterate<T, InteriorDetection>(params, c_real, c_imag, z_real, z_imag);
+
+    storeBlock(count, iter_counts, z_real, z_imag, params.max_iterations, out);
+  }
+}
+
+/*
+ * Compute up to one vector of arbitrary pixels.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, bool InteriorDetection, Channels C>
+void computeBlock(const KernelParams& params, const std::size_t* indices,
+                  const std::size_t count, const KernelOutput<T, C>& out) {
+  const auto [c_real, c_imag] = mapPixels<T>(params, indices, count);
+
+  Vec<T> z_real, z_imag;
+
+  if constexpr (C::distance) {
+    Vec<T> dz_real, dz_imag;
+    const Count<T> iter_counts = iterate<T, InteriorDetection, true>(
+        params, c_real, c_imag, z_real, z_imag, &dz_real, &dz_imag);
+
+    storeDistances(indices, count, iter_counts, z_real, z_imag, dz_real,
+                   dz_imag, params, out);
+  } else {
+    const Count<T> iter_counts =
+        iterate<T, InteriorDetection>(params, c_real, c_imag, z_real, z_imag);
+
+    storeList(indices, count, iter_counts, z_real, z_imag,
+              params.max_iterations, out);
+  }
+}
+
+/*
+ * The pending pixels of a run of consecutive pixels in the same row.
+ */
+template <Scalar T> struct RunQueue {
+  static constexpr bool resumes = false;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   *
+   * @returns The mapped positions of one vector of pixels starting at `first`.
+   */
+  auto map(const std::size_t first, const std::size_t /* count */) const {
+    return mapPixels<T>(params, row, col + first);
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the output of the run.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return position;
+  }
+
+  const KernelParams& params;
+  std::size_t row;
+  std::size_t col;
+};
+
+/*
+ * The pending pixels of a list of arbitrary pixels.
+ */
+template <Scalar T> struct ListQueue {
+  static constexpr bool resumes = false;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The mapped positions of the pixels.
+   */
+  auto map(const std::size_t first, const std::size_t count) const {
+    return mapPixels<T>(params, indices + first, count);
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the first pixel of the image.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return indices[position];
+  }
+
+  const KernelParams& params;
+  const std::size_t* indices;
+};
+
+/*
+ * The pending pixels of a list of arbitrary pixels that continue from the state
+ * in the output.
+ */
+template <Scalar T> struct ResumeQueue {
+  static constexpr bool resumes = true;
+
+  /*
+   * Map pending pixels onto the complex plane.
+   *
+   * @param first The position of the first pixel in the queue.
+   * @param count The number of pixels, at most the number of lanes.
+   *
+   * @returns The mapped positions of the pixels.
+   */
+  auto map(const std::size_t first, const std::size_t count) const {
+    return mapPixels<T>(params, indices + first, count);
+  }
+
+  /*
+   * Load the state that a pending pixel continues from.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The z-value and iteration count of the pixel.
+   */
+  auto start(const std::size_t position) const {
+    const std::size_t idx = indices[position];
+
+    return std::tuple{out.z_reals[idx], out.z_imags[idx],
+                      static_cast<CountElement<T>>(out.iterations[idx])};
+  }
+
+  /*
+   * Get the output offset of a pixel.
+   *
+   * @param position The position of the pixel in the queue.
+   *
+   * @returns The offset relative to the first pixel of the image.
+   */
+  std::size_t offset(const std::size_t position) const noexcept {
+    return indices[position];
+  }
+
+  const KernelParams& params;
+  const std::size_t* indices;
+  const KernelOutput<T>& out;
+};
+
+/*
+ * Compute a queue of pixels, refilling each lane with the next pending pixel as
+ * soon as its pixel retires.
+ *
+ * The lanes iterate together until at least one of them retires. The results
+ * of the retired lanes are written, after which the next pending pixels are
+ * moved into the free lanes one lane at a time, as the abstraction has no
+ * expand operation. The results are identical to those of the block kernel.
+ *
+ * @tparam T The scalar type.
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Queue The type of the queue, `RunQueue`, `ListQueue` or
+ * `ResumeQueue`.
+ *
+ * @param params The parameters of the computation.
+ * @param queue The pending pixels.
+ * @param count The number of pixels in the queue.
+ * @param out The output that the offsets of the queue are relative to.
+ */
+template <Scalar T, bool InteriorDetection, typename Queue, Channels C>
+[[gnu::flatten]]
+void computeRefill(const KernelParams& params, const Queue& queue,
+                   const std::size_t count, const KernelOutput<T, C>& out) {
+  constexpr unsigned int all_lanes = (1u << lanes<T>) - 1;
+
+  const auto max_iterations =
+      static_cast<CountElement<T>>(params.max_iterations);
+  const auto bailout = static_cast<T>(params.bailout_norm);
+
+  Vec<T> c_real = 0;
+  Vec<T> c_imag = 0;
+  Vec<T> z_real = 0;
+  Vec<T> z_imag = 0;
+  Count<T> iter_counts = 0;
+
+  // The position in the queue of the pixel in each lane.
+  std::array<std::size_t, lanes<T>> positions{};
+
+  // Brent's method needs a saved point and save interval per lane, as the lanes
+  // started iterating at different times.
+  [[maybe_unused]] Vec<T> z_real_saved = 0;
+  [[maybe_unused]] Vec<T> z_imag_saved = 0;
+  [[maybe_unused]] Count<T> save_at = 0;
+
+  // Lanes holding a pixel that hasn't retired yet, one bit per lane.
+  unsigned int occupied{0};
+  std::size_t next{0};
+
+  while (true) {
+    if (next < count) {
+      const std::size_t free_lanes =
+          lanes<T> - static_cast<std::size_t>(std::popcount(occupied));
+      const std::size_t loaded = std::min(free_lanes, count - next);
+      const auto [new_real, new_imag] = queue.map(next, loaded);
+
+      unsigned int refill{0};
+      unsigned int free = ~occupied & all_lanes;
+
+      for (std::size_t i = 0; i < loaded; ++i, free &= free - 1) {
+        const auto lane = static_cast<std::size_t>(std::countr_zero(free));
+        refill |= 1u << lane;
+
+        c_real[lane] = new_real[i];
+        c_imag[lane] = new_imag[i];
+        positions[lane] = next + i;
+
+        if constexpr (Queue::resumes) {
+          const auto [start_real, start_imag, start_iters] =
+              queue.start(next + i);
+
+          z_real[lane] = start_real;
+          z_imag[lane] = start_imag;
+          iter_counts[lane] = start_iters;
+        } else {
+          z_real[lane] = 0;
+          z_imag[lane] = 0;
+          iter_counts[lane] = 0;
+        }
+      }
+
+      if constexpr (InteriorDetection) {
+        const Mask<T> refill_mask = maskFromBits<T>(refill);
+
+        where(refill_mask, z_real_saved) = z_real;
+        where(refill_mask, z_imag_saved) = z_imag;
+        where(CountMask<T>(refill_mask), save_at) = iter_counts + 1;
+
+        // Points within the main cardioid or period-2 bulb retire right away.
+        where(CountMask<T>(refill_mask &&
+                           isInMainCardioidOrBulb(c_real, c_imag)),
+              iter_counts) = max_iterations;
+      }
+
+      occupied |= refill;
+      next += loaded;
+    }
+
+    if (occupied == 0) {
+      return;
+    }
+
+    // Keep lanes without a pixel from drifting off to infinity.
+    const Mask<T> vacant = !maskFromBits<T>(occupied);
+    where(vacant, c_real) = 0;
+    where(vacant, c_imag) = 0;
+    where(vacant, z_real) = 0;
+    where(vacant, z_imag) = 0;
+
+    while (true) {
+      // A pixel retires when it escapes or reaches the maximum iterations.
+      const Mask<T> active = norm(z_real, z_imag) <= bailout &&
+                             Mask<T>(iter_counts != max_iterations);
+
+      if (!stdx::all_of(active || vacant)) {
+        break;
+      }
+
+      // Every occupied lane is active, so no masking is needed.
+      iter_counts += 1;
+      step<T>(c_real, c_imag, z_real, z_imag);
+
+      if constexpr (InteriorDetection) {
+        // Periodic lanes reach the maximum iterations, so that they retire at
+        // the next check with their current z-value.
+        const Mask<T> periodic =
+            !vacant && z_real == z_real_saved && z_imag == z_imag_saved;
+        where(CountMask<T>(periodic), iter_counts) = max_iterations;
+
+        const CountMask<T> save = iter_counts == save_at;
+        where(Mask<T>(save), z_real_saved) = z_real;
+        where(Mask<T>(save), z_imag_saved) = z_imag;
+        where(save, save_at) = save_at + save_at;
+      }
+    }
+
+    const unsigned int retired =
+        occupied & ~maskBits<T>(norm(z_real, z_imag) <= bailout &&
+                                Mask<T>(iter_counts != max_iterations));
+
+    for (unsigned int lanes_left = retired; lanes_left != 0;
+         lanes_left &= lanes_left - 1) {
+      const auto lane = static_cast<std::size_t>(std::countr_zero(lanes_left));
+
+      storePixel(out, queue.offset(positions[lane]),
+                 static_cast<unsigned int>(iter_counts[lane]),
+                 static_cast<T>(z_real[lane]), static_cast<T>(z_imag[lane]),
+                 params.max_iterations);
+    }
+
+    occupied &= ~retired;
+  }
+}
+
+/*
+ * Iterate several independent vectors of points together until they escape
+ * or reach the maximum iterations.
+ *
+ * Every lane iterates without masks or counters for `CheckInterval`
+ * iterations. A vector in which a lane escaped during the interval is then
+ * rolled back to the start of the interval, and repeats it one iteration at a
+ * time as the block kernel does. See `iterateInterleaved` in
+ * mandelbrot_avx2.cpp.
+ *
+ * The z-values and iteration counts are iterated in local vectors and only
+ * stored at the end. Through the references of the caller, GCC stores every
+ * vector back to memory after every iteration.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param c_real The real parts of the points.
+ * @param c_imag The imaginary parts of the points.
+ * @param retired The lanes without a point.
+ * @param z_real_out The real parts of the final z-values.
+ * @param z_imag_out The imaginary parts of the final z-values.
+ * @param iter_counts_out The iteration counts.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval>
+[[gnu::flatten]]
+void iterateInterleaved(const KernelParams& params,
+                        const std::array<Vec<T>, Vectors>& c_real,
+                        const std::array<Vec<T>, Vectors>& c_imag,
+                        std::array<Mask<T>, Vectors> retired,
+                        std::array<Vec<T>, Vectors>& z_real_out,
+                        std::array<Vec<T>, Vectors>& z_imag_out,
+                        std::array<Count<T>, Vectors>& iter_counts_out) {
+  const auto bailout = static_cast<T>(params.bailout_norm);
+
+  std::array<Vec<T>, Vectors> z_real, z_imag;
+  std::array<Count<T>, Vectors> iter_counts;
+
+  z_real.fill(0);
+  z_imag.fill(0);
+  iter_counts.fill(0);
+
+  const auto step_all = [&](auto) {
+    unroll<Vectors>([&](const auto v) {
+      step<T>(c_real[v], c_imag[v], z_real[v], z_imag[v]);
+    });
+  };
+
+  for (unsigned int i = 0; i < params.max_iterations;) {
+    const unsigned int steps =
+        std::min(CheckInterval, params.max_iterations - i);
+    const std::array<Vec<T>, Vectors> start_real = z_real;
+    const std::array<Vec<T>, Vectors> start_imag = z_imag;
+
+    if (steps == CheckInterval) {
+      unroll<CheckInterval>(step_all);
+    } else {
+      for (unsigned int j = 0; j < steps; ++j) {
+        step_all(j);
+      }
+    }
+
+    i += steps;
+    bool finished = true;
+
+    unroll<Vectors>([&](const auto v) {
+      if (stdx::all_of(retired[v] || norm(z_real[v], z_imag[v]) <= bailout)) {
+        // Retired lanes keep the z-value they retired with.
+        where(retired[v], z_real[v]) = start_real[v];
+        where(retired[v], z_imag[v]) = start_imag[v];
+        where(!CountMask<T>(retired[v]), iter_counts[v]) +=
+            static_cast<CountElement<T>>(steps);
+      } else {
+        z_real[v] = start_real[v];
+        z_imag[v] = start_imag[v];
+
+        for (unsigned int j = 0; j < steps; ++j) {
+          const Mask<T> active =
+              !retired[v] && norm(z_real[v], z_imag[v]) <= bailout;
+          retired[v] = !active;
+
+          if (stdx::none_of(active)) {
+            break;
+          }
+
+          where(CountMask<T>(active), iter_counts[v]) += 1;
+
+          Vec<T> z_real_new = z_real[v];
+          Vec<T> z_imag_new = z_imag[v];
+          step<T>(c_real[v], c_imag[v], z_real_new, z_imag_new);
+
+          where(active, z_real[v]) = z_real_new;
+          where(active, z_imag[v]) = z_imag_new;
+        }
+      }
+
+      finished = finished && stdx::all_of(retired[v]);
+    });
+
+    if (finished) {
+      break;
+    }
+  }
+
+  z_real_out = z_real;
+  z_imag_out = z_imag;
+  iter_counts_out = iter_counts;
+}
+
+/*
+ * Compute consecutive pixels in the same row, several vectors at a time.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors iterated together.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval,
+          Channels C>
+void computeInterleaved(const KernelParams& params, const std::size_t row,
+                        const std::size_t col, const std::size_t count,
+                        const KernelOutput<T, C>& out) {
+  constexpr unsigned int all_lanes = (1u << lanes<T>) - 1;
+
+  for (std::size_t offset = 0; offset < count; offset += Vectors * lanes<T>) {
+    std::array<Vec<T>, Vectors> c_real, c_imag, z_real, z_imag;
+    std::array<Mask<T>, Vectors> retired;
+    std::array<Count<T>, Vectors> iter_counts;
+    std::array<std::size_t, Vectors> pixels;
+
+    unroll<Vectors>([&](const auto v) {
+      const std::size_t first = offset + v * lanes<T>;
+      pixels[v] = first < count ? std::min(lanes<T>, count - first) : 0;
+
+      std::tie(c_real[v], c_imag[v]) = mapPixels<T>(params, row, col + first);
+      retired[v] = maskFromBits<T>(all_lanes & ~((1u << pixels[v]) - 1));
+    });
+
+    iterateInterleaved<T, Vectors, CheckInterval>(params, c_real, c_imag,
+                                                  retired, z_real, z_imag,
+                                                  iter_counts);
+
+    unroll<Vectors>([&](const auto v) {
+      if (pixels[v] != 0) {
+        storeBlock(pixels[v], iter_counts[v], z_real[v], z_imag[v],
+                   params.max_iterations, out.at(offset + v * lanes<T>));
+      }
+    });
+  }
+}
+
+/*
+ * Compute arbitrary pixels, several vectors at a time.
+ *
+ * @tparam T The scalar type.
+ * @tparam Vectors The number of vectors iterated together.
+ * @tparam CheckInterval The number of iterations between escape checks.
+ *
+ * @param params The parameters of the computation.
+ * @param indices The indices of the pixels.
+ * @param count The number of pixels.
+ * @param out The output, pointing at the first pixel of the image.
+ */
+template <Scalar T, std::size_t Vectors, unsigned int CheckInterval,
+          Channels C>
+void computeInterleaved(const KernelParams& params,
+                        const std::size_t* indices, const std::size_t count,
+                        const KernelOutput<T, C>& out) {
+  constexpr unsigned int all_lanes = (1u << lanes<T>) - 1;
+
+  for (std::size_t offset = 0; offset < count; offset += Vectors * lanes<T>) {
+    std::array<Vec<T>, Vectors> c_real, c_imag, z_real, z_imag;
+    std::array<Mask<T>, Vectors> retired;
+    std::array<Count<T>, Vectors> iter_counts;
+    std::array<std::size_t, Vectors> pixels;
+
+    unroll<Vectors>([&](const auto v) {
+      const std::size_t first = offset + v * lanes<T>;
+      pixels[v] = first < count ? std::min(lanes<T>, count - first) : 0;
+
+      retired[v] = maskFromBits<T>(all_lanes & ~((1u << pixels[v]) - 1));
+
+      if (pixels[v] != 0) {
+        std::tie(c_real[v], c_imag[v]) =
+            mapPixels<T>(params, indices + first, pixels[v]);
+      } else {
+        c_real[v] = 0;
+        c_imag[v] = 0;
+      }
+    });
+
+    iterateInterleaved<T, Vectors, CheckInterval>(params, c_real, c_imag,
+                                                  retired, z_real, z_imag,
+                                                  iter_counts);
+
+    unroll<Vectors>([&](const auto v) {
+      if (pixels[v] != 0) {
+        storeList(indices + offset + v * lanes<T>, pixels[v], iter_counts[v],
+                  z_real[v], z_imag[v], params.max_iterations, out);
+      }
+    });
+  }
+}
+
+/*
+ * Evaluate the series approximation of the differences to the reference orbit
+ * with Horner's method.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param u_real The real parts of the offsets divided by the series scale.
+ * @param u_imag The imaginary parts of the offsets divided by the series
+ * scale.
+ * @param dz_real The real parts of the differences.
+ * @param dz_imag The imaginary parts of the differences.
+ */
+template <Scalar T>
+void evaluateSeries(const PerturbationParams<T>& params, const Vec<T>& u_real,
+                    const Vec<T>& u_imag, Vec<T>& dz_real, Vec<T>& dz_imag) {
+  dz_real = 0;
+  dz_imag = 0;
+
+  for (std::size_t k = params.series_terms; k-- > 0;) {
+    const Vec<T> a_real = dz_real + params.series_reals[k];
+    const Vec<T> a_imag = dz_imag + params.series_imags[k];
+
+    dz_real = a_real * u_real - a_imag * u_imag;
+    dz_imag = a_real * u_imag + a_imag * u_real;
+  }
+}
+
+/*
+ * Compute up to one vector of consecutive pixels in the same row by perturbing
+ * a reference orbit.
+ *
+ * Each lane tracks its own position in the reference orbit, as lanes are
+ * rebased independently. See `iteratePerturbed` in mandelbrot_serial.cpp for
+ * the rebasing condition.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixels.
+ * @param col The column of the first pixel.
+ * @param count The number of pixels, at most the number of lanes.
+ * @param out The output, pointing at the first pixel.
+ */
+template <Scalar T>
+[[gnu::flatten]]
+void computePerturbedBlock(const PerturbationParams<T>& params,
+                           const std::size_t row, const std::size_t col,
+                           const std::size_t count,
+                           const KernelOutput<T>& out) {
+  // The offsets are computed in double precision before rounding them, so that
+  // single precision kernels don't lose the position of the pixels.
+  const auto real_offset = [&](const std::size_t lane) {
+    return params.real_offset + static_cast<double>(col + lane) * params.step;
+  };
+
+  const double dc_imag_offset =
+      params.imag_offset - static_cast<double>(row) * params.step;
+
+  const Vec<T> dc_real(
+      [&](const auto lane) { return static_cast<T>(real_offset(lane)); });
+  const Vec<T> dc_imag(static_cast<T>(dc_imag_offset));
+
+  // Start after the skipped iterations, as given by the series.
+  Vec<T> dz_real, dz_imag;
+  evaluateSeries<T>(
+      params, Vec<T>([&](const auto lane) {
+        return static_cast<T>(real_offset(lane) / params.series_scale);
+      }),
+      Vec<T>(static_cast<T>(dc_imag_offset / params.series_scale)), dz_real,
+      dz_imag);
+
+  const std::size_t skipped = params.skipped_iterations;
+
+  // The reference point at the position of each lane.
+  Vec<T> ref_real = params.orbit_reals[skipped];
+  Vec<T> ref_imag = params.orbit_imags[skipped];
+
+  Vec<T> z_real = ref_real + dz_real;
+  Vec<T> z_imag = ref_imag + dz_imag;
+  Count<T> iter_counts = static_cast<CountElement<T>>(skipped);
+
+  // The position of each lane in the reference orbit.
+  Count<T> n = static_cast<CountElement<T>>(skipped);
+
+  const auto last = static_cast<CountElement<T>>(params.orbit_length - 1);
+  const auto bailout = static_cast<T>(params.bailout_norm);
+
+  Mask<T> active(true);
+
+  for (unsigned int i = params.skipped_iterations; i < params.max_iterations;
+       ++i) {
+    // dz = (2 * Z + dz) * dz + dc
+    const Vec<T> a_real = ref_real + ref_real + dz_real;
+    const Vec<T> a_imag = ref_imag + ref_imag + dz_imag;
+
+    const Vec<T> dz_real_new = a_real * dz_real - a_imag * dz_imag + dc_real;
+    const Vec<T> dz_imag_new = a_real * dz_imag + a_imag * dz_real + dc_imag;
+
+    where(active, dz_real) = dz_real_new;
+    where(active, dz_imag) = dz_imag_new;
+    where(CountMask<T>(active), n) += 1;
+    where(CountMask<T>(active), iter_counts) += 1;
+
+    // Lanes that are no longer active keep their position, so that they can
+    // load their reference point as well.
+    ref_real = Vec<T>([&](const auto lane) {
+      return params.orbit_reals[static_cast<std::size_t>(n[lane])];
+    });
+    ref_imag = Vec<T>([&](const auto lane) {
+      return params.orbit_imags[static_cast<std::size_t>(n[lane])];
+    });
+
+    where(active, z_real) = ref_real + dz_real;
+    where(active, z_imag) = ref_imag + dz_imag;
+
+    const Vec<T> z_norm = norm(z_real, z_imag);
+
+    // Check which pixels have not escaped yet.
+    active = active && z_norm <= bailout;
+
+    // If all pixels have escaped, stop early.
+    if (stdx::none_of(active)) {
+      break;
+    }
+
+    const Mask<T> rebase = active && (z_norm < norm(dz_real, dz_imag) ||
+                                      Mask<T>(n == last));
+
+    // Rebasing is rare, so keep it off the dependency chain of the iteration.
+    if (stdx::any_of(rebase)) {
+      where(rebase, dz_real) = z_real;
+      where(rebase, dz_imag) = z_imag;
+      where(rebase, ref_real) = 0;
+      where(rebase, ref_imag) = 0;
+      where(CountMask<T>(rebase), n) = 0;
+    }
+  }
+
+  storeBlock(count, iter_counts, z_real, z_imag, params.max_iterations, out);
+}
+} // namespace
+
+/*
+ * Compute the Mandelbrot set for a run of pixels with portable SIMD.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Portable, T, C>::compute(const KernelParams& params,
+                                              std::size_t row, std::size_t col,
+                                              std::size_t count,
+                                              const KernelOutput<T, C>& out) {
+  // Only the block variant tracks the derivatives, see `channels::Distance`.
+  if constexpr (!C::distance) {
+    if (params.variant == KernelVariant::Interleaved &&
+        !params.interior_detection) {
+      withInterleaving(params.interleaving, [&]<std::size_t Vectors,
+                                                unsigned int CheckInterval>() {
+        computeInterleaved<T, (Vectors + registers<T> - 1) / registers<T>,
+                           CheckInterval>(params, row, col, count, out);
+      });
+
+      return;
+    }
+
+    if (params.variant == KernelVariant::LaneRefill) {
+      const RunQueue<T> queue{params, row, col};
+
+      if (params.interior_detection) {
+        computeRefill<T, true>(params, queue, count, out);
+      } else {
+        computeRefill<T, false>(params, queue, count, out);
+      }
+
+      return;
+    }
+  }
+
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    const std::size_t block = std::min(lanes, count - offset);
+
+    if (params.interior_detection) {
+      computeBlock<T, true>(params, row, col + offset, block, out.at(offset));
+    } else {
+      computeBlock<T, false>(params, row, col + offset, block,
+                             out.at(offset));
+    }
+  }
+}
+
+/*
+ * Compute the Mandelbrot set for a list of pixels with portable SIMD.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Portable, T, C>::compute(const KernelParams& params,
+                                              const std::size_t* indices,
+                                              std::size_t count,
+                                              const KernelOutput<T, C>& out) {
+  // Only the block variant tracks the derivatives, see `channels::Distance`.
+  if constexpr (!C::distance) {
+    if (params.variant == KernelVariant::Interleaved &&
+        !params.interior_detection) {
+      withInterleaving(params.interleaving, [&]<std::size_t Vectors,
+                                                unsigned int CheckInterval>() {
+        computeInterleaved<T, (Vectors + registers<T> - 1) / registers<T>,
+                           CheckInterval>(params, indices, count, out);
+      });
+
+      return;
+    }
+
+    if (params.variant == KernelVariant::LaneRefill) {
+      const ListQueue<T> queue{params, indices};
+
+      if (params.interior_detection) {
+        computeRefill<T, true>(params, queue, count, out);
+      } else {
+        computeRefill<T, false>(params, queue, count, out);
+      }
+
+      return;
+    }
+  }
+
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    const std::size_t block = std::min(lanes, count - offset);
+
+    if (params.interior_detection) {
+      computeBlock<T, true>(params, indices + offset, block, out);
+    } else {
+      computeBlock<T, false>(params, indices + offset, block, out);
+    }
+  }
+}
+
+/*
+ * Continue computing the Mandelbrot set for a list of pixels with portable
+ * SIMD.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Portable, T, C>::resume(const KernelParams& params,
+                                             const std::size_t* indices,
+                                             std::size_t count,
+                                             const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  const ResumeQueue<T> queue{params, indices, out};
+
+  if (params.interior_detection) {
+    computeRefill<T, true>(params, queue, count, out);
+  } else {
+    computeRefill<T, false>(params, queue, count, out);
+  }
+}
+
+/*
+ * Compute the Mandelbrot set for a run of pixels by perturbation with portable
+ * SIMD.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Portable, T, C>::compute(
+    const PerturbationParams<T>& params, std::size_t row, std::size_t col,
+    std::size_t count, const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  for (std::size_t offset = 0; offset < count; offset += lanes) {
+    computePerturbedBlock(params, row, col + offset,
+                          std::min(lanes, count - offset), out.at(offset));
+  }
+}
+
+template struct Kernel<backend::Portable, float>;
+template struct Kernel<backend::Portable, double>;
+
+template struct Kernel<backend::Portable, float, channels::Iterations>;
+template struct Kernel<backend::Portable, double, channels::Iterations>;
+template struct Kernel<backend::Portable, float, channels::Iterations16>;
+template struct Kernel<backend::Portable, double, channels::Iterations16>;
+template struct Kernel<backend::Portable, float, channels::Smooth>;
+template struct Kernel<backend::Portable, double, channels::Smooth>;
+template struct Kernel<backend::Portable, float, channels::Distance>;
+template struct Kernel<backend::Portable, double, channels::Distance>;
+
+#endif
@@ -5,37 +5,269 @@
 #include <complex>
 
 #include "backends.hpp"
-#include "mandelbrot_engine.hpp"
+#include "kernels.hpp"
 #include "utility.hpp"
 
 /*
- * Compute the Mandelbrot set.
+ * Iterate a single point until it escapes or reaches the maximum iterations.
  *
- * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ * With interior detection enabled, points within the main cardioid or
+ * period-2 bulb are not iterated at all, and the orbit is checked for
+ * periodicity using Brent's method: it is compared against the orbit point
+ * saved at the last power-of-two iteration. Once an orbit repeats exactly it
+ * can never escape, so the point reports the maximum iterations with its
+ * z-value at the time of detection.
+ *
+ * @tparam InteriorDetection Whether interior detection is enabled.
+ * @tparam Derivative Whether to track the derivative of the orbit.
+ * @tparam T The scalar type.
+ *
+ * @param c The point on the complex plane.
+ * @param params The parameters of the computation.
+ * @param z The z-value to start from, replaced by the final z-value.
+ * @param iteration The iteration count to start from.
+ * @param dz The derivative dz/dc to start from, replaced by the final
+ * derivative, if it is tracked.
+ *
+ * @returns The iteration count.
  */
-template <>
-MandelbrotResult<backend::Serial> MandelbrotEngine<backend::Serial>::compute() {
-  for (std::size_t row = 0; row < m_height; ++row) {
-    for (std::size_t col = 0; col < m_width; ++col) {
-      std::complex<float> z{0.0f, 0.0f};
-      const std::complex<float> c = utility::mapPixelToComplexPlane(
-          row, col, m_width, m_height, m_bounds.real_min, m_bounds.real_max,
-          m_bounds.imag_min, m_bounds.imag_max);
+template <bool InteriorDetection, bool Derivative = false, Scalar T>
+static unsigned int iterate(const std::complex<T> c,
+                            const KernelParams& params, std::complex<T>& z,
+                            unsigned int iteration,
+                            [[maybe_unused]] std::complex<T>* dz = nullptr) {
+  const unsigned int max_iterations = params.max_iterations;
+  const auto bailout_norm = static_cast<T>(params.bailout_norm);
+
+  if constexpr (InteriorDetection) {
+    if (utility::isInMainCardioidOrBulb(c)) {
+      return max_iterations;
+    }
+  }
+
+  std::complex<T> z_saved = z;
+  unsigned int save_at{iteration + 1};
+
+  while (std::norm(z) <= bailout_norm && iteration < max_iterations) {
+    if constexpr (Derivative) {
+      *dz = T{2} * z * *dz + T{1};
+    }
 
-      unsigned int iteration{0};
-      while (std::norm(z) <= 4.0f && iteration < m_max_iterations) {
-        z = z * z + c;
+    z = z * z + c;
 
-        ++iteration;
+    ++iteration;
+
+    if constexpr (InteriorDetection) {
+      if (z == z_saved) {
+        return max_iterations;
+      }
+
+      if (iteration == save_at) {
+        z_saved = z;
+        save_at <<= 1;
       }
+    }
+  }
+
+  return iteration;
+}
+
+/*
+ * Map a pixel onto the complex plane in the precision of the kernel.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param row The row of the pixel.
+ * @param col The column of the pixel.
+ *
+ * @returns The mapped position of the pixel on the complex plane.
+ */
+template <Scalar T>
+static std::complex<T> mapPixel(const KernelParams& params,
+                                const std::size_t row, const std::size_t col) {
+  return {utility::mapIndexToAxis(col, params.width,
+                                  static_cast<T>(params.bounds.real_min),
+                                  static_cast<T>(params.bounds.real_max)),
+          utility::mapIndexToAxis(row, params.height,
+                                  static_cast<T>(params.bounds.imag_max),
+                                  static_cast<T>(params.bounds.imag_min))};
+}
+
+/*
+ * Compute the Mandelbrot set for a run of pixels.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Serial, T, C>::compute(const KernelParams& params,
+                                            std::size_t row, std::size_t col,
+                                            std::size_t count,
+                                            const KernelOutput<T, C>& out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::complex<T> c = mapPixel<T>(params, row, col + i);
+
+    std::complex<T> z{T{0}, T{0}};
 
-      const std::size_t idx = row * m_width + col;
+    if constexpr (C::distance) {
+      std::complex<T> dz{T{0}, T{0}};
+      const unsigned int iteration =
+          params.interior_detection
+              ? iterate<true, true>(c, params, z, 0, &dz)
+              : iterate<false, true>(c, params, z, 0, &dz);
 
-      m_host.iterations[idx] = iteration;
-      m_host.z_reals[idx] = z.real();
-      m_host.z_imags[idx] = z.imag();
+      storePixel(out, i, iteration, z.real(), z.imag(), dz.real(), dz.imag(),
+                 params);
+    } else {
+      const unsigned int iteration =
+          params.interior_detection
+              ? iterate<true>(c, params, z, 0)
+              : iterate<false>(c, params, z, 0);
+
+      storePixel(out, i, iteration, z.real(), z.imag(),
+                 params.max_iterations);
     }
   }
+}
+
+/*
+ * Compute the Mandelbrot set for a list of pixels.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Serial, T, C>::compute(const KernelParams& params,
+                                            const std::size_t* indices,
+                                            std::size_t count,
+                                            const KernelOutput<T, C>& out) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::size_t idx = indices[i];
 
-  return {m_host, m_width, m_height};
+    compute(params, idx / params.width, idx % params.width, 1, out.at(idx));
+  }
 }
+
+/*
+ * Continue computing the Mandelbrot set for a list of pixels.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Serial, T, C>::resume(const KernelParams& params,
+                                           const std::size_t* indices,
+                                           std::size_t count,
+                                           const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::size_t idx = indices[i];
+    const std::complex<T> c =
+        mapPixel<T>(params, idx / params.width, idx % params.width);
+
+    std::complex<T> z{out.z_reals[idx], out.z_imags[idx]};
+    const unsigned int iteration =
+        params.interior_detection
+            ? iterate<true>(c, params, z, out.iterations[idx])
+            : iterate<false>(c, params, z, out.iterations[idx]);
+
+    out.iterations[idx] = iteration;
+    out.z_reals[idx] = z.real();
+    out.z_imags[idx] = z.imag();
+  }
+}
+
+/*
+ * Iterate the difference of a single point to the reference orbit until the
+ * point escapes or reaches the maximum iterations.
+ *
+ * The point starts after the skipped iterations, with its difference given by
+ * the series approximation.
+ *
+ * Whenever the point comes closer to zero than its difference to the
+ * reference, or the reference orbit runs out, the difference is rebased onto
+ * the start of the reference orbit. This keeps the difference small relative
+ * to the point, which is what prevents glitches.
+ *
+ * @tparam T The scalar type.
+ *
+ * @param params The parameters of the computation.
+ * @param dc The difference of the point to the reference point.
+ * @param u The difference divided by the scale of the series.
+ * @param z The final z-value.
+ *
+ * @returns The iteration count.
+ */
+template <Scalar T>
+static unsigned int iteratePerturbed(const PerturbationParams<T>& params,
+                                     const std::complex<T> dc,
+                                     const std::complex<T> u,
+                                     std::complex<T>& z) {
+  const auto bailout_norm = static_cast<T>(params.bailout_norm);
+  std::complex<T> dz{T{0}, T{0}};
+
+  // Evaluate the series with Horner's method.
+  for (std::size_t k = params.series_terms; k-- > 0;) {
+    dz = (dz + std::complex<T>{params.series_reals[k],
+                               params.series_imags[k]}) *
+         u;
+  }
+
+  std::size_t n = params.skipped_iterations;
+  unsigned int iteration = params.skipped_iterations;
+  z = {params.orbit_reals[n] + dz.real(), params.orbit_imags[n] + dz.imag()};
+
+  while (iteration < params.max_iterations) {
+    const std::complex<T> reference{params.orbit_reals[n],
+                                    params.orbit_imags[n]};
+
+    dz = (T{2} * reference + dz) * dz + dc;
+    ++n;
+    ++iteration;
+
+    z = {params.orbit_reals[n] + dz.real(), params.orbit_imags[n] + dz.imag()};
+
+    if (std::norm(z) > bailout_norm) {
+      break;
+    }
+
+    if (std::norm(z) < std::norm(dz) || n == params.orbit_length - 1) {
+      dz = z;
+      n = 0;
+    }
+  }
+
+  return iteration;
+}
+
+/*
+ * Compute the Mandelbrot set for a run of pixels by perturbation.
+ */
+template <Scalar T, Channels C>
+void Kernel<backend::Serial, T, C>::compute(
+    const PerturbationParams<T>& params, std::size_t row, std::size_t col,
+    std::size_t count, const KernelOutput<T>& out)
+  requires std::is_same_v<C, channels::Full>
+{
+  const double dc_imag =
+      params.imag_offset - static_cast<double>(row) * params.step;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const double dc_real =
+        params.real_offset + static_cast<double>(col + i) * params.step;
+
+    const std::complex<T> dc{static_cast<T>(dc_real), static_cast<T>(dc_imag)};
+    const std::complex<T> u{static_cast<T>(dc_real / params.series_scale),
+                            static_cast<T>(dc_imag / params.series_scale)};
+
+    std::complex<T> z;
+    out.iterations[i] = iteratePerturbed(params, dc, u, z);
+    out.z_reals[i] = z.real();
+    out.z_imags[i] = z.imag();
+  }
+}
+
+template struct Kernel<backend::Serial, float>;
+template struct Kernel<backend::Serial, double>;
+
+template struct Kernel<backend::Serial, float, channels::Iterations>;
+template struct Kernel<backend::Serial, double, channels::Iterations>;
+template struct Kernel<backend::Serial, float, channels::Iterations16>;
+template struct Kernel<backend::Serial, double, channels::Iterations16>;
+template struct Kernel<backend::Serial, float, channels::Smooth>;
+template struct Kernel<backend::Serial, double, channels::Smooth>;
+template struct Kernel<backend::Serial, float, channels::Distance>;
+template struct Kernel<backend::Serial, double, channels::Distance>;
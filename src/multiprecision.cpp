@@ -0,0 +1,245 @@
+/*
+ * This file contains the implementation of the multiprecision number type.
+ *
+ * The header can be found in: include/multiprecision.hpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "multiprecision.hpp"
+
+namespace multiprecision {
+namespace {
+using Limbs = std::vector<std::uint32_t>;
+
+/*
+ * Compare the magnitudes of two numbers.
+ *
+ * @param a The limbs of the first number.
+ * @param b The limbs of the second number.
+ *
+ * @returns A negative value, zero or a positive value if `a` is less than,
+ * equal to or greater than `b`.
+ */
+int compareMagnitudes(const Limbs& a, const Limbs& b) {
+  for (std::size_t i = a.size(); i-- > 0;) {
+    if (a[i] != b[i]) {
+      return a[i] < b[i] ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Add two magnitudes. A carry out of the integer limb is discarded.
+ *
+ * @param a The limbs of the first number.
+ * @param b The limbs of the second number.
+ *
+ * @returns The limbs of the sum.
+ */
+Limbs addMagnitudes(const Limbs& a, const Limbs& b) {
+  Limbs sum(a.size());
+  std::uint64_t carry{0};
+
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    const std::uint64_t limb = std::uint64_t{a[i]} + b[i] + carry;
+
+    sum[i] = static_cast<std::uint32_t>(limb);
+    carry = limb >> 32;
+  }
+
+  return sum;
+}
+
+/*
+ * Subtract a magnitude from a larger or equal one.
+ *
+ * @param a The limbs of the larger number.
+ * @param b The limbs of the smaller number.
+ *
+ * @returns The limbs of the difference.
+ */
+Limbs subtractMagnitudes(const Limbs& a, const Limbs& b) {
+  Limbs difference(a.size());
+  std::uint32_t borrow{0};
+
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    const std::uint64_t subtrahend = std::uint64_t{b[i]} + borrow;
+
+    difference[i] = static_cast<std::uint32_t>(a[i] - subtrahend);
+    borrow = a[i] < subtrahend ? 1 : 0;
+  }
+
+  return difference;
+}
+
+/*
+ * Check whether all limbs are zero.
+ *
+ * @param limbs The limbs.
+ *
+ * @returns Whether the number is zero.
+ */
+bool isZero(const Limbs& limbs) {
+  return std::all_of(limbs.begin(), limbs.end(),
+                     [](const std::uint32_t limb) { return limb == 0; });
+}
+} // namespace
+
+FixedPoint::FixedPoint(const std::size_t fraction_limbs)
+    : m_limbs(fraction_limbs + 1, 0) {}
+
+FixedPoint::FixedPoint(const double value, const std::size_t fraction_limbs)
+    : FixedPoint(fraction_limbs) {
+  double magnitude = std::fabs(value);
+
+  // Peel off 32 bits at a time, starting with the integer part.
+  for (std::size_t i = m_limbs.size(); i-- > 0;) {
+    const double limb = std::floor(magnitude);
+
+    m_limbs[i] = static_cast<std::uint32_t>(limb);
+    magnitude = std::ldexp(magnitude - limb, 32);
+  }
+
+  m_negative = value < 0.0 && !isZero(m_limbs);
+}
+
+FixedPoint FixedPoint::parse(const std::string_view decimal,
+                             const std::size_t fraction_limbs) {
+  FixedPoint result(fraction_limbs);
+  std::string_view digits = decimal;
+
+  const bool negative = !digits.empty() && digits.front() == '-';
+
+  if (!digits.empty() && (digits.front() == '-' || digits.front() == '+')) {
+    digits.remove_prefix(1);
+  }
+
+  const std::size_t point = digits.find('.');
+  const std::string_view integer = digits.substr(0, point);
+  const std::string_view fraction =
+      point == std::string_view::npos ? std::string_view{}
+                                      : digits.substr(point + 1);
+
+  const auto is_digit = [](const char c) { return c >= '0' && c <= '9'; };
+
+  if ((integer.empty() && fraction.empty()) ||
+      !std::all_of(integer.begin(), integer.end(), is_digit) ||
+      !std::all_of(fraction.begin(), fraction.end(), is_digit)) {
+    throw std::invalid_argument("Not a decimal number.");
+  }
+
+  // Build the fraction from its last digit to its first: x = (digit + x) / 10.
+  Limbs& limbs = result.m_limbs;
+
+  for (auto it = fraction.rbegin(); it != fraction.rend(); ++it) {
+    limbs.back() = static_cast<std::uint32_t>(*it - '0');
+
+    std::uint64_t remainder{0};
+
+    for (std::size_t i = limbs.size(); i-- > 0;) {
+      const std::uint64_t current = (remainder << 32) | limbs[i];
+
+      limbs[i] = static_cast<std::uint32_t>(current / 10);
+      remainder = current % 10;
+    }
+  }
+
+  std::uint64_t integer_value{0};
+
+  for (const char c : integer) {
+    integer_value = integer_value * 10 + static_cast<std::uint64_t>(c - '0');
+
+    if (integer_value > UINT32_MAX) {
+      throw std::invalid_argument("The integer part is out of range.");
+    }
+  }
+
+  limbs.back() = static_cast<std::uint32_t>(integer_value);
+  result.m_negative = negative && !isZero(limbs);
+
+  return result;
+}
+
+double FixedPoint::to_double() const noexcept {
+  const std::size_t fraction = fraction_limbs();
+  double value{0.0};
+
+  // Only the most significant limbs contribute to a double.
+  const std::size_t first = m_limbs.size() > 3 ? m_limbs.size() - 3 : 0;
+
+  for (std::size_t i = first; i < m_limbs.size(); ++i) {
+    const int exponent =
+        32 * (static_cast<int>(i) - static_cast<int>(fraction));
+
+    value += std::ldexp(static_cast<double>(m_limbs[i]), exponent);
+  }
+
+  return m_negative ? -value : value;
+}
+
+FixedPoint FixedPoint::operator-() const {
+  FixedPoint result = *this;
+  result.m_negative = !m_negative && !isZero(m_limbs);
+
+  return result;
+}
+
+FixedPoint FixedPoint::operator+(const FixedPoint& other) const {
+  FixedPoint result(fraction_limbs());
+
+  if (m_negative == other.m_negative) {
+    result.m_limbs = addMagnitudes(m_limbs, other.m_limbs);
+    result.m_negative = m_negative;
+  } else if (compareMagnitudes(m_limbs, other.m_limbs) >= 0) {
+    result.m_limbs = subtractMagnitudes(m_limbs, other.m_limbs);
+    result.m_negative = m_negative;
+  } else {
+    result.m_limbs = subtractMagnitudes(other.m_limbs, m_limbs);
+    result.m_negative = other.m_negative;
+  }
+
+  result.m_negative = result.m_negative && !isZero(result.m_limbs);
+
+  return result;
+}
+
+FixedPoint FixedPoint::operator-(const FixedPoint& other) const {
+  return *this + -other;
+}
+
+FixedPoint FixedPoint::operator*(const FixedPoint& other) const {
+  const std::size_t size = m_limbs.size();
+  const std::size_t fraction = fraction_limbs();
+
+  // The full product has twice the limbs, of which the lowest `fraction`
+  // limbs are truncated and anything above the integer limb is discarded.
+  Limbs product(2 * size, 0);
+
+  for (std::size_t i = 0; i < size; ++i) {
+    std::uint64_t carry{0};
+
+    for (std::size_t j = 0; j < size; ++j) {
+      const std::uint64_t limb =
+          std::uint64_t{m_limbs[i]} * other.m_limbs[j] + product[i + j] + carry;
+
+      product[i + j] = static_cast<std::uint32_t>(limb);
+      carry = limb >> 32;
+    }
+
+    product[i + size] = static_cast<std::uint32_t>(carry);
+  }
+
+  FixedPoint result(fraction);
+  std::copy_n(product.begin() + static_cast<std::ptrdiff_t>(fraction), size,
+              result.m_limbs.begin());
+  result.m_negative =
+      (m_negative != other.m_negative) && !isZero(result.m_limbs);
+
+  return result;
+}
+} // namespace multiprecision
@@ -0,0 +1,227 @@
+/*
+ * This file contains the implementation of the placement of threads on NUMA
+ * nodes.
+ *
+ * The NUMA nodes and their CPUs are read from /sys/devices/system/node, so
+ * that no NUMA library is needed.
+ *
+ * The header can be found in: src/numa.hpp
+ */
+
+#if defined(MANDELBROT_HAS_OMP)
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "numa.hpp"
+
+namespace {
+#if defined(__linux__)
+// The CPUs that the process may run on, grouped by their NUMA node.
+using Topology = std::vector<std::vector<int>>;
+
+/*
+ * Parse a list of CPUs, such as "0-3,8,10-11".
+ *
+ * @param list The list.
+ *
+ * @returns The CPUs.
+ */
+std::vector<int> parseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  const char* current = list.data();
+  const char* const end = list.data() + list.size();
+
+  while (current < end) {
+    int first{0};
+    const auto [first_end, first_error] = std::from_chars(current, end, first);
+
+    if (first_error != std::errc{}) {
+      break;
+    }
+
+    int last{first};
+    current = first_end;
+
+    if (current < end && *current == '-') {
+      const auto [last_end, last_error] =
+          std::from_chars(current + 1, end, last);
+
+      if (last_error != std::errc{}) {
+        break;
+      }
+
+      current = last_end;
+    }
+
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+
+    // Skip the separator.
+    ++current;
+  }
+
+  return cpus;
+}
+
+/*
+ * Read the NUMA nodes and the CPUs that the process may run on.
+ *
+ * Nodes without such CPUs are left out. Without any NUMA information, all
+ * CPUs form a single node.
+ *
+ * @returns The topology, which is empty if the CPUs can't be determined.
+ */
+Topology readTopology() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return {};
+  }
+
+  const auto is_allowed = [&](const int cpu) {
+    return cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed);
+  };
+
+  // The nodes by their number, which may have gaps.
+  std::vector<std::pair<int, std::vector<int>>> numbered;
+  std::error_code error;
+
+  for (const auto& entry : std::filesystem::directory_iterator(
+           "/sys/devices/system/node", error)) {
+    const std::string name = entry.path().filename().string();
+    int number{0};
+
+    if (!name.starts_with("node") ||
+        std::from_chars(name.data() + 4, name.data() + name.size(), number)
+                .ec != std::errc{}) {
+      continue;
+    }
+
+    std::ifstream file{entry.path() / "cpulist"};
+    std::string list;
+    std::getline(file, list);
+
+    std::vector<int> cpus = parseCpuList(list);
+    std::erase_if(cpus, [&](const int cpu) { return !is_allowed(cpu); });
+
+    if (!cpus.empty()) {
+      numbered.emplace_back(number, std::move(cpus));
+    }
+  }
+
+  std::ranges::sort(numbered);
+
+  Topology nodes;
+
+  for (auto& [number, cpus] : numbered) {
+    nodes.push_back(std::move(cpus));
+  }
+
+  if (nodes.empty()) {
+    std::vector<int> cpus;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (is_allowed(cpu)) {
+        cpus.push_back(cpu);
+      }
+    }
+
+    if (!cpus.empty()) {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+
+  return nodes;
+}
+
+/*
+ * Get the NUMA nodes and the CPUs that the process may run on.
+ *
+ * The topology is read once, before any thread is pinned, so that it holds
+ * the CPUs of the process rather than those of a pinned thread.
+ *
+ * @returns The topology.
+ */
+const Topology& topology() {
+  static const Topology nodes = readTopology();
+  return nodes;
+}
+#endif
+} // namespace
+
+namespace numa {
+ThreadPin::ThreadPin([[maybe_unused]] const ThreadPlacement placement,
+                     [[maybe_unused]] const std::size_t thread) {
+#if defined(__linux__)
+  const Topology& nodes = topology();
+
+  if (placement == ThreadPlacement::None || nodes.empty()) {
+    return;
+  }
+
+  std::size_t node{0};
+  int cpu{0};
+
+  if (placement == ThreadPlacement::Close) {
+    std::size_t cpus{0};
+
+    for (const std::vector<int>& node_cpus : nodes) {
+      cpus += node_cpus.size();
+    }
+
+    std::size_t idx = thread % cpus;
+
+    while (idx >= nodes[node].size()) {
+      idx -= nodes[node].size();
+      ++node;
+    }
+
+    cpu = nodes[node][idx];
+  } else {
+    node = thread % nodes.size();
+    cpu = nodes[node][thread / nodes.size() % nodes[node].size()];
+  }
+
+  cpu_set_t previous;
+  CPU_ZERO(&previous);
+
+  if (sched_getaffinity(0, sizeof(previous), &previous) != 0) {
+    return;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    return;
+  }
+
+  m_previous = previous;
+  m_node = node;
+#endif
+}
+
+ThreadPin::~ThreadPin() {
+#if defined(__linux__)
+  if (m_previous) {
+    sched_setaffinity(0, sizeof(*m_previous), &*m_previous);
+  }
+#endif
+}
+} // namespace numa
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * This file contains the declarations for the placement of threads on NUMA
+ * nodes.
+ */
+
+#pragma once
+
+#if defined(MANDELBROT_HAS_OMP)
+
+#include <cstddef>
+#include <optional>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "mandelbrot_engine.hpp"
+
+namespace numa {
+/*
+ * Pins the calling thread to a CPU for as long as it lives, according to the
+ * number of the thread within the threads of a parallel region.
+ *
+ * The CPUs that the process may run on are grouped by their NUMA node. With
+ * `ThreadPlacement::Close`, the threads take the CPUs of the first node, then
+ * those of the next. With `ThreadPlacement::Spread`, consecutive threads take
+ * consecutive nodes. Threads beyond the number of CPUs wrap around.
+ *
+ * The thread gets back the CPUs it could run on before when the pin is
+ * destroyed, so that neither the threads of the runtime nor the thread calling
+ * the engine stay pinned after the parallel region.
+ */
+class ThreadPin {
+public:
+  /*
+   * @param placement The placement of the threads.
+   * @param thread The number of the thread.
+   */
+  ThreadPin(ThreadPlacement placement, std::size_t thread);
+  ~ThreadPin();
+
+  ThreadPin(const ThreadPin&) = delete;
+  ThreadPin& operator=(const ThreadPin&) = delete;
+
+  // The NUMA node of the thread, or 0 if it isn't pinned.
+  std::size_t node() const noexcept { return m_node; }
+
+private:
+  std::size_t m_node{0};
+
+#if defined(__linux__)
+  // The CPUs that the thread could run on before, if it was pinned.
+  std::optional<cpu_set_t> m_previous;
+#endif
+};
+} // namespace numa
+
+#endif
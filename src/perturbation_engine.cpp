@@ -0,0 +1,202 @@
+/*
+ * This file contains the reference orbit and the execution policies of the
+ * perturbation engine.
+ *
+ * The pixels are computed by the perturbation variant of the backend kernels
+ * in kernels.hpp.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
+#include "backends.hpp"
+#include "kernels.hpp"
+#include "multiprecision.hpp"
+#include "perturbation_engine.hpp"
+#include "scheduler.hpp"
+#include "series_approximation.hpp"
+
+namespace {
+// The bits of precision beyond the distance between pixels that the reference
+// orbit is computed with.
+constexpr std::size_t guard_bits = 64;
+
+// The error of the series approximation relative to the differences of the
+// probe points, beyond which the pixels have to be iterated.
+template <Scalar T>
+constexpr double series_tolerance = std::is_same_v<T, float> ? 1e-6 : 1e-12;
+
+/*
+ * Compute the orbit of a point in multiprecision, rounding every point to
+ * double precision.
+ *
+ * The orbit starts at zero and ends once it escapes or reaches the maximum
+ * iterations, so it holds at most `max_iterations + 1` points.
+ *
+ * @param c_real The real part of the point.
+ * @param c_imag The imaginary part of the point.
+ * @param max_iterations The maximum iterations.
+ * @param bailout_norm The square of the bailout radius.
+ * @param reals The real parts of the orbit.
+ * @param imags The imaginary parts of the orbit.
+ */
+void computeReferenceOrbit(const multiprecision::FixedPoint& c_real,
+                           const multiprecision::FixedPoint& c_imag,
+                           const unsigned int max_iterations,
+                           const double bailout_norm,
+                           std::vector<double>& reals,
+                           std::vector<double>& imags) {
+  multiprecision::FixedPoint z_real(c_real.fraction_limbs());
+  multiprecision::FixedPoint z_imag(c_real.fraction_limbs());
+
+  reals.assign(1, 0.0);
+  imags.assign(1, 0.0);
+
+  for (unsigned int i = 0; i < max_iterations; ++i) {
+    const multiprecision::FixedPoint z_real_imag = z_real * z_imag;
+
+    z_real = z_real * z_real - z_imag * z_imag + c_real;
+    z_imag = z_real_imag + z_real_imag + c_imag;
+
+    const double real = z_real.to_double();
+    const double imag = z_imag.to_double();
+
+    reals.push_back(real);
+    imags.push_back(imag);
+
+    if (real * real + imag * imag > bailout_norm) {
+      break;
+    }
+  }
+}
+} // namespace
+
+/*
+ * Compute the Mandelbrot set by perturbation.
+ *
+ * @returns MandelbrotResult containing iteration and final z-value per pixel.
+ */
+template <Backend B, Execution Exec, Scalar T>
+  requires Compatible<B, Exec> && SupportsScalar<B, T> && PerturbationBackend<B>
+MandelbrotResult<B, T> PerturbationEngine<B, Exec, T>::compute() {
+  using K = Kernel<B, T>;
+  using multiprecision::FixedPoint;
+
+  const double step =
+      2.0 * m_radius /
+      static_cast<double>(std::max<std::size_t>(m_width, 2) - 1);
+
+  // The reference has to resolve the distance between pixels.
+  const auto pixel_bits =
+      static_cast<std::size_t>(std::max(0.0, std::ceil(-std::log2(step))));
+  const std::size_t limbs = FixedPoint::limbs_for_bits(pixel_bits + guard_bits);
+
+  std::vector<double> orbit_reals, orbit_imags;
+  computeReferenceOrbit(FixedPoint::parse(m_center_real, limbs),
+                        FixedPoint::parse(m_center_imag, limbs),
+                        std::max(m_max_iterations, 1u), bailout_norm(),
+                        orbit_reals, orbit_imags);
+
+  const double imag_radius = step * static_cast<double>(m_height - 1) / 2.0;
+
+  // Replace the iterations that all pixels share by a series.
+  const series::Approximation series =
+      series::approximate(orbit_reals, orbit_imags, m_series_terms, m_radius,
+                          imag_radius, series_tolerance<T>, bailout_norm());
+  m_skipped_iterations = series.skipped_iterations;
+
+  m_series_reals.clear();
+  m_series_imags.clear();
+
+  for (const std::complex<double>& coefficient : series.coefficients) {
+    m_series_reals.push_back(static_cast<T>(coefficient.real()));
+    m_series_imags.push_back(static_cast<T>(coefficient.imag()));
+  }
+
+  m_orbit_reals.assign(orbit_reals.begin(), orbit_reals.end());
+  m_orbit_imags.assign(orbit_imags.begin(), orbit_imags.end());
+
+  m_host.allocate();
+
+  const PerturbationParams<T> params{m_width,
+                                     m_height,
+                                     -m_radius,
+                                     imag_radius,
+                                     step,
+                                     m_max_iterations,
+                                     m_orbit_reals.data(),
+                                     m_orbit_imags.data(),
+                                     m_orbit_reals.size(),
+                                     m_skipped_iterations,
+                                     m_series_reals.data(),
+                                     m_series_imags.data(),
+                                     m_series_reals.size(),
+                                     m_radius,
+                                     bailout_norm()};
+  const KernelOutput<T> out = makeOutput(m_host);
+
+  if constexpr (std::is_same_v<Exec, exec::Default>) {
+    for (std::size_t row = 0; row < m_height; ++row) {
+      K::compute(params, row, 0, m_width, out.at(row * m_width));
+    }
+  }
+#if defined(MANDELBROT_HAS_OMP)
+  else if constexpr (std::is_same_v<Exec, exec::OMP>) {
+#pragma omp parallel for schedule(dynamic)
+    for (std::size_t row = 0; row < m_height; ++row) {
+      K::compute(params, row, 0, m_width, out.at(row * m_width));
+    }
+  } else if constexpr (std::is_same_v<Exec, exec::WorkStealing>) {
+    scheduler::runWorkStealing(m_height, [&](const std::size_t row) {
+      K::compute(params, row, 0, m_width, out.at(row * m_width));
+    });
+  }
+#endif
+
+  return {m_host, m_width, m_height};
+}
+
+#define INSTANTIATE_ENGINE(B, Exec)                                            \
+  template MandelbrotResult<B, float>                                          \
+  PerturbationEngine<B, Exec, float>::compute();                               \
+  template MandelbrotResult<B, double>                                         \
+  PerturbationEngine<B, Exec, double>::compute();
+
+INSTANTIATE_ENGINE(backend::Serial, exec::Default)
+
+#if defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::Serial, exec::OMP)
+INSTANTIATE_ENGINE(backend::Serial, exec::WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX2)
+INSTANTIATE_ENGINE(backend::AVX2, exec::Default)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX2) && defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::AVX2, exec::OMP)
+INSTANTIATE_ENGINE(backend::AVX2, exec::WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+INSTANTIATE_ENGINE(backend::AVX512, exec::Default)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512) && defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::AVX512, exec::OMP)
+INSTANTIATE_ENGINE(backend::AVX512, exec::WorkStealing)
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+INSTANTIATE_ENGINE(backend::Portable, exec::Default)
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE) && defined(MANDELBROT_HAS_OMP)
+INSTANTIATE_ENGINE(backend::Portable, exec::OMP)
+INSTANTIATE_ENGINE(backend::Portable, exec::WorkStealing)
+#endif
+
+#undef INSTANTIATE_ENGINE
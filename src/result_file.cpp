@@ -0,0 +1,190 @@
+/*
+ * This file contains the implementation of result files.
+ *
+ * The header can be found in: include/result_file.hpp
+ */
+
+#include <cerrno>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "result_file.hpp"
+
+namespace result_file {
+namespace {
+/*
+ * Round a size up to a multiple of the alignment of the arrays.
+ *
+ * @param size The size.
+ *
+ * @returns The rounded size.
+ */
+constexpr std::size_t alignUp(const std::size_t size) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+/*
+ * Throw the error of the last failed system call.
+ *
+ * @param what What failed.
+ * @param path The path of the file.
+ */
+[[noreturn]] void throwSystemError(const std::string_view what,
+                                   const std::filesystem::path& path) {
+  throw std::system_error(errno, std::generic_category(),
+                          std::format("{} {}", what, path.string()));
+}
+
+/*
+ * Map a file descriptor into memory and close it.
+ *
+ * @param fd The file descriptor.
+ * @param size The size of the file.
+ * @param protection The protection of the mapping.
+ * @param path The path of the file, for errors.
+ *
+ * @returns The start of the mapping.
+ */
+std::byte* mapAndClose(const int fd, const std::size_t size,
+                       const int protection,
+                       const std::filesystem::path& path) {
+  void* data = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+
+  // The mapping keeps the file open by itself.
+  const int error = errno;
+  close(fd);
+  errno = error;
+
+  if (data == MAP_FAILED) {
+    throwSystemError("Failed to map", path);
+  }
+
+  return static_cast<std::byte*>(data);
+}
+} // namespace
+
+Header makeHeader(const std::size_t width, const std::size_t height,
+                  const std::size_t scalar_size) {
+  const std::size_t pixels = width * height;
+
+  Header header{};
+  header.magic = magic;
+  header.version = version;
+  header.scalar_size = static_cast<std::uint32_t>(scalar_size);
+  header.width = width;
+  header.height = height;
+  header.alignment = static_cast<std::uint32_t>(alignment);
+
+  header.iterations_offset = alignUp(sizeof(Header));
+  header.z_reals_offset =
+      alignUp(header.iterations_offset + pixels * sizeof(unsigned int));
+  header.z_imags_offset = alignUp(header.z_reals_offset + pixels * scalar_size);
+  header.size = alignUp(header.z_imags_offset + pixels * scalar_size);
+
+  return header;
+}
+
+Mapping Mapping::create(const std::filesystem::path& path,
+                        const Header& header) {
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+  if (fd < 0) {
+    throwSystemError("Failed to create", path);
+  }
+
+  // Extending the file leaves a hole, which takes no disk space until written.
+  if (ftruncate(fd, static_cast<off_t>(header.size)) != 0) {
+    const int error = errno;
+    close(fd);
+    errno = error;
+
+    throwSystemError("Failed to resize", path);
+  }
+
+  Mapping mapping{
+      mapAndClose(fd, header.size, PROT_READ | PROT_WRITE, path),
+      header.size};
+  mapping.header() = header;
+
+  return mapping;
+}
+
+Mapping Mapping::open(const std::filesystem::path& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    throwSystemError("Failed to open", path);
+  }
+
+  struct stat status {};
+
+  if (fstat(fd, &status) != 0) {
+    const int error = errno;
+    close(fd);
+    errno = error;
+
+    throwSystemError("Failed to inspect", path);
+  }
+
+  const auto size = static_cast<std::size_t>(status.st_size);
+
+  if (size < sizeof(Header)) {
+    close(fd);
+    throw std::runtime_error(
+        std::format("{} is not a result file.", path.string()));
+  }
+
+  Mapping mapping{mapAndClose(fd, size, PROT_READ, path), size};
+  const Header& header = mapping.header();
+
+  if (header.magic != magic || header.size != size) {
+    throw std::runtime_error(
+        std::format("{} is not a result file.", path.string()));
+  }
+
+  if (header.version != version) {
+    throw std::runtime_error(
+        std::format("{} has version {}, expected {}.", path.string(),
+                    header.version, version));
+  }
+
+  return mapping;
+}
+
+Mapping::Mapping(Mapping&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)} {}
+
+Mapping& Mapping::operator=(Mapping&& other) noexcept {
+  if (this != &other) {
+    if (m_data != nullptr) {
+      munmap(m_data, m_size);
+    }
+
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+  }
+
+  return *this;
+}
+
+Mapping::~Mapping() {
+  if (m_data != nullptr) {
+    munmap(m_data, m_size);
+  }
+}
+
+void Mapping::advise_sequential() const noexcept {
+  const std::size_t offset = header().iterations_offset;
+
+  madvise(m_data + offset, m_size - offset, MADV_SEQUENTIAL);
+}
+} // namespace result_file
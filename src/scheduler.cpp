@@ -0,0 +1,185 @@
+/*
+ * This file contains the implementation of the work-stealing scheduler.
+ *
+ * The header can be found in: src/scheduler.hpp
+ */
+
+#if defined(MANDELBROT_HAS_OMP)
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include <omp.h>
+
+#include "numa.hpp"
+#include "scheduler.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The remaining tasks of a thread. Aligned to a cache line so that threads
+// don't contend on each other's queues.
+struct alignas(64) WorkerQueue {
+  /*
+   * Take the task at the front of the queue.
+   *
+   * @param task The task that was taken.
+   *
+   * @returns Whether a task was taken.
+   */
+  bool pop(std::size_t& task) {
+    std::lock_guard lock{mutex};
+
+    if (begin == end) {
+      return false;
+    }
+
+    task = begin++;
+    return true;
+  }
+
+  /*
+   * Take the back half of the remaining tasks.
+   *
+   * @param stolen_begin The first task that was taken.
+   * @param stolen_end One past the last task that was taken.
+   *
+   * @returns Whether any tasks were taken.
+   */
+  bool steal(std::size_t& stolen_begin, std::size_t& stolen_end) {
+    std::lock_guard lock{mutex};
+
+    if (begin == end) {
+      return false;
+    }
+
+    stolen_begin = begin + (end - begin) / 2;
+    stolen_end = end;
+    end = stolen_begin;
+    return true;
+  }
+
+  /*
+   * Replace the remaining tasks.
+   *
+   * @param new_begin The first task.
+   * @param new_end One past the last task.
+   */
+  void assign(std::size_t new_begin, std::size_t new_end) {
+    std::lock_guard lock{mutex};
+
+    begin = new_begin;
+    end = new_end;
+  }
+
+  std::mutex mutex;
+  std::size_t begin{0};
+  std::size_t end{0};
+};
+} // namespace
+
+namespace scheduler {
+std::vector<WorkerStats>
+runWorkStealing(std::size_t count,
+                const std::function<void(std::size_t)>& task,
+                const ThreadPlacement placement) {
+  const std::size_t max_workers =
+      static_cast<std::size_t>(omp_get_max_threads());
+
+  const std::unique_ptr<WorkerQueue[]> queues{new WorkerQueue[max_workers]};
+  std::vector<WorkerStats> stats(max_workers);
+  std::vector<std::size_t> nodes(max_workers);
+
+  std::size_t workers = max_workers;
+
+  const Clock::time_point start = Clock::now();
+
+#pragma omp parallel num_threads(static_cast<int>(max_workers))
+  {
+    // The runtime may provide fewer threads than requested.
+#pragma omp single
+    workers = static_cast<std::size_t>(omp_get_num_threads());
+
+    const std::size_t self = static_cast<std::size_t>(omp_get_thread_num());
+
+    const numa::ThreadPin pin{placement, self};
+    nodes[self] = pin.node();
+    queues[self].assign(self * count / workers, (self + 1) * count / workers);
+
+#pragma omp barrier
+
+    WorkerStats& own_stats = stats[self];
+    std::size_t current;
+
+    while (true) {
+      if (queues[self].pop(current)) {
+        const Clock::time_point task_start = Clock::now();
+        task(current);
+        own_stats.busy += Clock::now() - task_start;
+        ++own_stats.tasks;
+
+        continue;
+      }
+
+      // Look for a victim, starting at the next thread so that thieves spread
+      // out over the queues. The tasks of threads on the same node write to
+      // memory on that node, so those threads are robbed first.
+      bool stolen = false;
+
+      for (const bool same_node : {true, false}) {
+        for (std::size_t i = 1; i < workers && !stolen; ++i) {
+          const std::size_t victim = (self + i) % workers;
+          std::size_t stolen_begin, stolen_end;
+
+          if ((nodes[victim] == nodes[self]) == same_node &&
+              queues[victim].steal(stolen_begin, stolen_end)) {
+            queues[self].assign(stolen_begin, stolen_end);
+            ++own_stats.steals;
+            stolen = true;
+          }
+        }
+      }
+
+      // Tasks are never added, so if every queue is empty, all work has been
+      // handed out.
+      if (!stolen) {
+        break;
+      }
+    }
+  }
+
+  const Clock::duration elapsed = Clock::now() - start;
+
+  stats.resize(workers);
+
+  for (WorkerStats& worker : stats) {
+    worker.idle = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        elapsed - worker.busy);
+  }
+
+  return stats;
+}
+
+void runPartitioned(std::size_t count,
+                    const std::function<void(std::size_t)>& task,
+                    const ThreadPlacement placement) {
+  const std::size_t max_workers =
+      static_cast<std::size_t>(omp_get_max_threads());
+
+#pragma omp parallel num_threads(static_cast<int>(max_workers))
+  {
+    const auto workers = static_cast<std::size_t>(omp_get_num_threads());
+    const std::size_t self = static_cast<std::size_t>(omp_get_thread_num());
+
+    const numa::ThreadPin pin{placement, self};
+
+    for (std::size_t idx = self * count / workers;
+         idx < (self + 1) * count / workers; ++idx) {
+      task(idx);
+    }
+  }
+}
+} // namespace scheduler
+
+#endif
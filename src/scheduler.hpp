@@ -0,0 +1,51 @@
+/*
+ * This file contains the declarations for the work-stealing scheduler.
+ */
+
+#pragma once
+
+#if defined(MANDELBROT_HAS_OMP)
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "mandelbrot_engine.hpp"
+
+namespace scheduler {
+/*
+ * Run `count` independent tasks on the OpenMP threads.
+ *
+ * The tasks are split into contiguous ranges, one per thread. A thread runs
+ * the tasks of its own range from the front. Once it runs out, it steals the
+ * back half of the remaining range of another thread, until no tasks are left.
+ * Threads on the same NUMA node as the thief are robbed first.
+ *
+ * @param count The number of tasks.
+ * @param task The task to run, called with the index of the task.
+ * @param placement The placement of the threads, see `numa::ThreadPin`.
+ *
+ * @returns The statistics of each thread.
+ */
+std::vector<WorkerStats>
+runWorkStealing(std::size_t count,
+                const std::function<void(std::size_t)>& task,
+                ThreadPlacement placement = ThreadPlacement::None);
+
+/*
+ * Run `count` independent tasks on the OpenMP threads, each on the thread
+ * whose range it is in at the start of `runWorkStealing`, without stealing.
+ *
+ * This writes memory for the first time from the threads that will compute
+ * it, so that it is placed on their NUMA nodes.
+ *
+ * @param count The number of tasks.
+ * @param task The task to run, called with the index of the task.
+ * @param placement The placement of the threads, see `numa::ThreadPin`.
+ */
+void runPartitioned(std::size_t count,
+                    const std::function<void(std::size_t)>& task,
+                    ThreadPlacement placement);
+} // namespace scheduler
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * This file contains the implementation of the series approximation.
+ *
+ * The header can be found in: src/series_approximation.hpp
+ */
+
+#include <array>
+#include <cmath>
+
+#include "series_approximation.hpp"
+
+namespace series {
+namespace {
+/*
+ * Evaluate a series at a point.
+ *
+ * @param coefficients The coefficients, starting at the linear term.
+ * @param u The point.
+ *
+ * @returns The value of the series.
+ */
+std::complex<double>
+evaluate(const std::vector<std::complex<double>>& coefficients,
+         const std::complex<double> u) {
+  std::complex<double> sum{0.0, 0.0};
+
+  for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) {
+    sum = (sum + *it) * u;
+  }
+
+  return sum;
+}
+} // namespace
+
+Approximation approximate(const std::vector<double>& orbit_reals,
+                          const std::vector<double>& orbit_imags,
+                          const std::size_t terms, const double real_radius,
+                          const double imag_radius, const double tolerance,
+                          const double bailout_norm) {
+  Approximation result{0, std::vector<std::complex<double>>(terms)};
+
+  // A pixel has to be able to take at least one step along the orbit after
+  // skipping.
+  if (terms == 0 || orbit_reals.size() < 3) {
+    return result;
+  }
+
+  // The corners and the midpoints of the edges of the view.
+  const std::array<std::complex<double>, 8> probes{{
+      {-real_radius, -imag_radius},
+      {0.0, -imag_radius},
+      {real_radius, -imag_radius},
+      {-real_radius, 0.0},
+      {real_radius, 0.0},
+      {-real_radius, imag_radius},
+      {0.0, imag_radius},
+      {real_radius, imag_radius},
+  }};
+  std::array<std::complex<double>, 8> probe_deltas{};
+
+  std::vector<std::complex<double>>& coefficients = result.coefficients;
+  std::vector<std::complex<double>> next(terms);
+
+  for (std::size_t n = 0; n + 2 < orbit_reals.size(); ++n) {
+    const std::complex<double> reference{orbit_reals[n], orbit_imags[n]};
+    const std::complex<double> next_reference{orbit_reals[n + 1],
+                                              orbit_imags[n + 1]};
+
+    // Squaring the series convolves its coefficients with themselves.
+    for (std::size_t k = 0; k < terms; ++k) {
+      std::complex<double> square{0.0, 0.0};
+
+      for (std::size_t i = 0; 2 * i + 1 < k; ++i) {
+        square += 2.0 * coefficients[i] * coefficients[k - 1 - i];
+      }
+
+      if (k % 2 == 1) {
+        square += coefficients[k / 2] * coefficients[k / 2];
+      }
+
+      next[k] = 2.0 * reference * coefficients[k] + square;
+    }
+
+    next[0] += real_radius;
+
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+      std::complex<double>& delta = probe_deltas[i];
+      delta = (2.0 * reference + delta) * delta + probes[i];
+
+      const std::complex<double> approximation =
+          evaluate(next, probes[i] / real_radius);
+
+      if (std::norm(next_reference + delta) > bailout_norm ||
+          std::abs(approximation - delta) > tolerance * std::abs(delta)) {
+        return result;
+      }
+    }
+
+    coefficients.swap(next);
+    result.skipped_iterations = static_cast<unsigned int>(n + 1);
+  }
+
+  return result;
+}
+} // namespace series
@@ -0,0 +1,54 @@
+/*
+ * This file contains the declarations for the series approximation.
+ *
+ * At a deep zoom, the pixels of an image follow nearly the same orbit for many
+ * iterations. During those iterations, the difference of each pixel to the
+ * reference orbit is well approximated by a truncated power series in its
+ * offset to the reference point, with coefficients shared by all pixels. The
+ * perturbation kernels evaluate the series to start every pixel at a late
+ * iteration instead of at zero.
+ */
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace series {
+struct Approximation {
+  // The number of iterations that the series replaces.
+  unsigned int skipped_iterations{0};
+
+  // The coefficients of the series, starting at the linear term. They are
+  // scaled to the offset divided by the scale of the approximation, which
+  // keeps them within the range of `float`.
+  std::vector<std::complex<double>> coefficients;
+};
+
+/*
+ * Find the coefficients of the series and the number of iterations that can
+ * be skipped with them.
+ *
+ * The series is advanced along the reference orbit for as long as it matches
+ * the exactly iterated differences of probe points on the edges of the view
+ * to within `tolerance`, and none of the probe points has escaped beyond the
+ * bailout radius.
+ *
+ * @param orbit_reals The real parts of the reference orbit.
+ * @param orbit_imags The imaginary parts of the reference orbit.
+ * @param terms The number of terms of the series. Zero disables skipping.
+ * @param real_radius Half the width of the view.
+ * @param imag_radius Half the height of the view.
+ * @param tolerance The maximum error of the series relative to the
+ * differences of the probe points.
+ * @param bailout_norm The square of the bailout radius.
+ *
+ * @returns The series, scaled by `real_radius`.
+ */
+Approximation approximate(const std::vector<double>& orbit_reals,
+                          const std::vector<double>& orbit_imags,
+                          std::size_t terms, double real_radius,
+                          double imag_radius, double tolerance,
+                          double bailout_norm);
+} // namespace series
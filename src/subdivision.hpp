@@ -0,0 +1,328 @@
+/*
+ * This file contains the Mariani-Silver subdivision renderer.
+ *
+ * The Mandelbrot set and the regions with an iteration count of at least n
+ * are connected. Hence, if every pixel on the border of a rectangle has the
+ * same iteration count, the pixels inside it do as well and can be filled in
+ * without iterating them. Otherwise, the rectangle is split in two along its
+ * longer side and both halves are handled recursively.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "backends.hpp"
+#include "kernels.hpp"
+
+namespace subdivision {
+// Rectangles with a side shorter than this are computed pixel by pixel, as the
+// chance of them being uniform doesn't outweigh the cost of checking.
+constexpr std::size_t min_size = 8;
+
+// Rows narrower than this many kernel lanes are gathered rather than computed
+// as a run.
+constexpr std::size_t gather_width = 4;
+
+// Rectangles with fewer pixels than this are not split into separate tasks.
+constexpr std::size_t min_task_pixels = 64 * 64;
+
+/*
+ * Renders an image into the channels `C`, which must include the iteration
+ * counts that the borders are compared by.
+ */
+template <Backend B, Execution Exec, Scalar T, Channels C = channels::Full>
+  requires(C::iterations)
+class Renderer {
+public:
+  /*
+   * Create a renderer.
+   *
+   * @param params The parameters of the computation.
+   * @param out The output, pointing at the first pixel of the image.
+   * @param cancelled A flag that stops the rendering of further rectangles
+   * once it is set, if any. The image is then left incomplete.
+   */
+  Renderer(const KernelParams& params, const KernelOutput<T, C>& out,
+           const std::atomic<bool>* cancelled = nullptr)
+      : m_params{params}, m_out{out}, m_cancelled{cancelled} {};
+
+  /*
+   * Render the image.
+   *
+   * With the OpenMP execution policy, the rectangles are rendered as parallel
+   * tasks.
+   *
+   * @returns The number of pixels that were iterated rather than filled.
+   */
+  std::size_t render() {
+    const Rect image{0, m_params.height - 1, 0, m_params.width - 1};
+
+#if defined(MANDELBROT_HAS_OMP)
+    if constexpr (std::is_same_v<Exec, exec::OMP>) {
+#pragma omp parallel
+#pragma omp single
+      render(image);
+    } else {
+      render(image);
+    }
+#else
+    render(image);
+#endif
+
+    return iterated();
+  }
+
+  /*
+   * Render a region of the image.
+   *
+   * Regions may be rendered concurrently, as long as they don't overlap.
+   *
+   * @param region The region.
+   */
+  void render(const Rect& region) {
+    if (region.width() < 3 || region.height() < 3) {
+      for (std::size_t row = region.row_min; row <= region.row_max; ++row) {
+        computeRow(row, region.col_min, region.col_max);
+      }
+
+      return;
+    }
+
+    computeRow(region.row_min, region.col_min, region.col_max);
+    computeRow(region.row_max, region.col_min, region.col_max);
+    computeColumn(region.col_min, region.row_min + 1, region.row_max - 1);
+    computeColumn(region.col_max, region.row_min + 1, region.row_max - 1);
+
+    subdivide(region);
+  }
+
+  /*
+   * Get the number of pixels that were iterated rather than filled so far.
+   *
+   * @returns The number of iterated pixels.
+   */
+  std::size_t iterated() const noexcept {
+    return m_iterated.load(std::memory_order_relaxed);
+  }
+
+private:
+  using K = Kernel<B, T, C>;
+
+  /*
+   * Compute the pixels of a row between two columns, both inclusive.
+   *
+   * @param row The row.
+   * @param col_min The first column.
+   * @param col_max The last column.
+   */
+  void computeRow(std::size_t row, std::size_t col_min, std::size_t col_max) {
+    const std::size_t count = col_max - col_min + 1;
+
+    K::compute(m_params, row, col_min, count,
+               m_out.at(row * m_params.width + col_min));
+    m_iterated.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /*
+   * Compute the pixels of a column between two rows, both inclusive.
+   *
+   * The pixels are gathered so that the kernel can still fill all its lanes.
+   *
+   * @param col The column.
+   * @param row_min The first row.
+   * @param row_max The last row.
+   */
+  void computeColumn(std::size_t col, std::size_t row_min,
+                     std::size_t row_max) {
+    std::array<std::size_t, 8 * K::lanes> indices;
+
+    for (std::size_t row = row_min; row <= row_max; row += indices.size()) {
+      const std::size_t count = std::min(indices.size(), row_max - row + 1);
+
+      for (std::size_t i = 0; i < count; ++i) {
+        indices[i] = (row + i) * m_params.width + col;
+      }
+
+      K::compute(m_params, indices.data(), count, m_out);
+      m_iterated.fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+
+  /*
+   * Compute every pixel inside a rectangle, excluding its border.
+   *
+   * Narrow rectangles would leave most lanes of the kernel unused if computed
+   * row by row, so their pixels are gathered instead.
+   *
+   * @param rect The rectangle.
+   */
+  void computeInterior(const Rect& rect) {
+    const std::size_t inner_width = rect.width() - 2;
+
+    if (inner_width >= gather_width * K::lanes) {
+      for (std::size_t row = rect.row_min + 1; row < rect.row_max; ++row) {
+        computeRow(row, rect.col_min + 1, rect.col_max - 1);
+      }
+
+      return;
+    }
+
+    std::array<std::size_t, 8 * K::lanes> indices;
+    std::size_t count{0};
+
+    for (std::size_t row = rect.row_min + 1; row < rect.row_max; ++row) {
+      for (std::size_t col = rect.col_min + 1; col < rect.col_max; ++col) {
+        indices[count++] = row * m_params.width + col;
+
+        if (count == indices.size()) {
+          K::compute(m_params, indices.data(), count, m_out);
+          m_iterated.fetch_add(count, std::memory_order_relaxed);
+          count = 0;
+        }
+      }
+    }
+
+    K::compute(m_params, indices.data(), count, m_out);
+    m_iterated.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /*
+   * Check whether all pixels on the border of a rectangle have the same
+   * iteration count.
+   *
+   * The distance estimates vary within a rectangle of escaping pixels, so with
+   * distances only a border inside the set counts as uniform.
+   *
+   * @param rect The rectangle.
+   *
+   * @returns Whether the border is uniform.
+   */
+  bool isBorderUniform(const Rect& rect) const {
+    const typename C::Iteration* iterations = m_out.iterations;
+    const std::size_t width = m_params.width;
+    const typename C::Iteration expected =
+        iterations[rect.row_min * width + rect.col_min];
+
+    if constexpr (C::distance) {
+      if (expected != m_params.max_iterations) {
+        return false;
+      }
+    }
+
+    for (std::size_t col = rect.col_min; col <= rect.col_max; ++col) {
+      if (iterations[rect.row_min * width + col] != expected ||
+          iterations[rect.row_max * width + col] != expected) {
+        return false;
+      }
+    }
+
+    for (std::size_t row = rect.row_min + 1; row < rect.row_max; ++row) {
+      if (iterations[row * width + rect.col_min] != expected ||
+          iterations[row * width + rect.col_max] != expected) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * Fill the inside of a rectangle, excluding its border, with the values of
+   * its top-left pixel.
+   *
+   * @param rect The rectangle.
+   */
+  void fillInterior(const Rect& rect) {
+    const std::size_t corner = rect.row_min * m_params.width + rect.col_min;
+
+    for (std::size_t row = rect.row_min + 1; row < rect.row_max; ++row) {
+      const KernelOutput<T, C> out =
+          m_out.at(row * m_params.width + rect.col_min + 1);
+      const std::size_t count = rect.width() - 2;
+
+      std::fill_n(out.iterations, count, m_out.iterations[corner]);
+
+      if constexpr (C::z) {
+        std::fill_n(out.z_reals, count, m_out.z_reals[corner]);
+        std::fill_n(out.z_imags, count, m_out.z_imags[corner]);
+      }
+
+      if constexpr (C::distance) {
+        std::fill_n(out.distance, count, m_out.distance[corner]);
+      }
+    }
+  }
+
+  /*
+   * Render the inside of a rectangle whose border has already been computed.
+   *
+   * @param rect The rectangle.
+   */
+  void subdivide(const Rect& rect) {
+    if (rect.width() < 3 || rect.height() < 3) {
+      return;
+    }
+
+    if (m_cancelled != nullptr &&
+        m_cancelled->load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    if (isBorderUniform(rect)) {
+      fillInterior(rect);
+      return;
+    }
+
+    if (rect.width() < min_size || rect.height() < min_size) {
+      computeInterior(rect);
+      return;
+    }
+
+    // Split along the longer side. The line shared by both halves becomes part
+    // of their borders, so it is computed before recursing.
+    Rect first = rect;
+    Rect second = rect;
+
+    if (rect.width() >= rect.height()) {
+      const std::size_t col = rect.col_min + rect.width() / 2;
+
+      computeColumn(col, rect.row_min + 1, rect.row_max - 1);
+      first.col_max = col;
+      second.col_min = col;
+    } else {
+      const std::size_t row = rect.row_min + rect.height() / 2;
+
+      computeRow(row, rect.col_min + 1, rect.col_max - 1);
+      first.row_max = row;
+      second.row_min = row;
+    }
+
+#if defined(MANDELBROT_HAS_OMP)
+    if constexpr (std::is_same_v<Exec, exec::OMP>) {
+      if (rect.width() * rect.height() >= min_task_pixels) {
+#pragma omp task firstprivate(first)
+        subdivide(first);
+#pragma omp task firstprivate(second)
+        subdivide(second);
+#pragma omp taskwait
+        return;
+      }
+    }
+#endif
+
+    subdivide(first);
+    subdivide(second);
+  }
+
+  const KernelParams m_params;
+  const KernelOutput<T, C> m_out;
+  const std::atomic<bool>* m_cancelled;
+
+  std::atomic<std::size_t> m_iterated{0};
+};
+} // namespace subdivision
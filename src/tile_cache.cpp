@@ -0,0 +1,387 @@
+/*
+ * This file contains the implementation of the tile cache.
+ *
+ * The header can be found in: include/tile_cache.hpp
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "any_mandelbrot_engine.hpp"
+#include "tile_cache.hpp"
+
+namespace {
+/*
+ * Run-length encode a channel of a tile, unless that makes it larger.
+ *
+ * Values are compared bitwise, so that encoding is lossless for floating-point
+ * values too.
+ *
+ * @param data The values of the channel.
+ * @param count The number of values.
+ * @param values The value of each run.
+ * @param lengths The length of each run, left empty if the channel is stored
+ * as is.
+ */
+template <typename V>
+void encodeRuns(const V* data, const std::size_t count, std::vector<V>& values,
+                std::vector<std::uint32_t>& lengths) {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!values.empty() &&
+        std::memcmp(&values.back(), &data[i], sizeof(V)) == 0) {
+      ++lengths.back();
+    } else {
+      values.push_back(data[i]);
+      lengths.push_back(1);
+    }
+  }
+
+  if (values.size() * (sizeof(V) + sizeof(std::uint32_t)) >=
+      count * sizeof(V)) {
+    values.assign(data, data + count);
+    lengths.clear();
+  }
+
+  values.shrink_to_fit();
+  lengths.shrink_to_fit();
+}
+
+/*
+ * Decode a channel of a tile.
+ *
+ * @param values The value of each run.
+ * @param lengths The length of each run, or empty if the channel is stored as
+ * is.
+ * @param data The values of the channel.
+ */
+template <typename V>
+void decodeRuns(const std::vector<V>& values,
+                const std::vector<std::uint32_t>& lengths, V* data) {
+  if (lengths.empty()) {
+    std::memcpy(data, values.data(), values.size() * sizeof(V));
+    return;
+  }
+
+  for (std::size_t run = 0; run < values.size(); ++run) {
+    data = std::fill_n(data, lengths[run], values[run]);
+  }
+}
+} // namespace
+
+std::shared_ptr<const Tile> TileCache::get(const TileKey& key) {
+  std::unique_lock lock{m_mutex};
+
+  if (const auto it = m_index.find(key); it != m_index.end()) {
+    ++m_hits;
+    m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+
+    return it->second->tile;
+  }
+
+  if (const auto it = m_compressing.find(key); it != m_compressing.end()) {
+    // The tile was evicted but isn't compressed yet, so it is taken back.
+    ++m_hits;
+    std::shared_ptr<const Tile> tile = std::move(it->second);
+    m_compressing.erase(it);
+
+    std::vector<Entry> evicted = insert(key, tile);
+    lock.unlock();
+
+    compress_evicted(std::move(evicted));
+
+    return tile;
+  }
+
+  if (const auto it = m_pending.find(key); it != m_pending.end()) {
+    ++m_coalesced;
+    const std::shared_future<std::shared_ptr<const Tile>> tile = it->second;
+    lock.unlock();
+
+    return tile.get();
+  }
+
+  // Produce the tile outside of the lock, while other requests for it wait for
+  // the promise.
+  std::promise<std::shared_ptr<const Tile>> promise;
+  m_pending.emplace(key, promise.get_future().share());
+
+  std::optional<CompressedTile> compressed;
+
+  if (const auto it = m_compressed_index.find(key);
+      it != m_compressed_index.end()) {
+    ++m_hits;
+    m_compressed_bytes -= it->second->tile.bytes;
+    compressed = std::move(it->second->tile);
+    m_compressed_tiles.erase(it->second);
+    m_compressed_index.erase(it);
+  } else {
+    ++m_misses;
+  }
+
+  const std::string exec = m_exec;
+  lock.unlock();
+
+  std::shared_ptr<const Tile> tile;
+
+  try {
+    tile = compressed ? decompress(*compressed, m_tile_size)
+                      : compute(key, exec);
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+
+    lock.lock();
+    m_pending.erase(key);
+
+    // Keep a compressed tile that couldn't be decompressed, rather than lose
+    // it.
+    if (compressed) {
+      m_compressed_bytes += compressed->bytes;
+      m_compressed_tiles.push_front({key, std::move(*compressed)});
+      m_compressed_index.emplace(key, m_compressed_tiles.begin());
+    }
+
+    throw;
+  }
+
+  lock.lock();
+  m_pending.erase(key);
+  std::vector<Entry> evicted = insert(key, tile);
+  lock.unlock();
+
+  promise.set_value(tile);
+  compress_evicted(std::move(evicted));
+
+  return tile;
+}
+
+void TileCache::set_compressed_capacity(const std::size_t capacity) {
+  std::unique_lock lock{m_mutex};
+
+  m_compressed_capacity = capacity;
+  std::vector<Entry> evicted = evict();
+  lock.unlock();
+
+  compress_evicted(std::move(evicted));
+}
+
+void TileCache::set_exec(const std::string_view exec) {
+  const std::lock_guard lock{m_mutex};
+
+  m_exec = exec;
+}
+
+ViewBounds TileCache::bounds(const TileKey& key) const {
+  if (key.zoom >= 64 || key.x >> key.zoom != 0 || key.y >> key.zoom != 0) {
+    throw std::out_of_range(std::format(
+        "Tile ({}, {}) lies outside of zoom level {}.", key.x, key.y,
+        key.zoom));
+  }
+
+  // The distance between pixels at this zoom level.
+  const double pixels =
+      static_cast<double>(m_tile_size) * static_cast<double>(1ull << key.zoom);
+  const double real_step = (m_world.real_max - m_world.real_min) / pixels;
+  const double imag_step = (m_world.imag_max - m_world.imag_min) / pixels;
+
+  const double col = static_cast<double>(key.x * m_tile_size);
+  const double row = static_cast<double>(key.y * m_tile_size);
+  const double last = static_cast<double>(m_tile_size) - 0.5;
+
+  return {m_world.real_min + (col + 0.5) * real_step,
+          m_world.real_min + (col + last) * real_step,
+          m_world.imag_max - (row + last) * imag_step,
+          m_world.imag_max - (row + 0.5) * imag_step};
+}
+
+TileCacheStats TileCache::stats() const {
+  const std::lock_guard lock{m_mutex};
+
+  return {m_hits,      m_misses, m_coalesced,
+          m_evictions, m_bytes,  m_compressed_bytes};
+}
+
+/*
+ * Compute a tile.
+ */
+std::shared_ptr<const Tile> TileCache::compute(const TileKey& key,
+                                               const std::string& exec) const {
+  AnyMandelbrotEngine engine = make_engine(
+      m_tile_size, m_tile_size, bounds(key), key.max_iterations, key.backend,
+      exec);
+  const AnyMandelbrotResult result = engine.compute();
+
+  auto tile = std::make_shared<Tile>(m_tile_size);
+
+  for (std::size_t row = 0; row < m_tile_size; ++row) {
+    for (std::size_t col = 0; col < m_tile_size; ++col) {
+      const std::size_t idx = row * m_tile_size + col;
+      const EscapeResult<> pixel = result(row, col);
+
+      tile->m_iterations[idx] = pixel.iteration;
+      tile->m_z_reals[idx] = pixel.z.real();
+      tile->m_z_imags[idx] = pixel.z.imag();
+    }
+  }
+
+  return tile;
+}
+
+/*
+ * Compress a tile.
+ */
+TileCache::CompressedTile TileCache::compress(const Tile& tile) {
+  const std::size_t pixels = tile.m_iterations.size();
+
+  CompressedTile compressed{};
+  encodeRuns(tile.iterations(), pixels, compressed.iterations.values,
+             compressed.iterations.lengths);
+  encodeRuns(tile.z_reals(), pixels, compressed.z_reals.values,
+             compressed.z_reals.lengths);
+  encodeRuns(tile.z_imags(), pixels, compressed.z_imags.values,
+             compressed.z_imags.lengths);
+
+  compressed.bytes =
+      compressed.iterations.values.size() * sizeof(unsigned int) +
+      compressed.z_reals.values.size() * sizeof(float) +
+      compressed.z_imags.values.size() * sizeof(float) +
+      (compressed.iterations.lengths.size() +
+       compressed.z_reals.lengths.size() + compressed.z_imags.lengths.size()) *
+          sizeof(std::uint32_t);
+
+  return compressed;
+}
+
+/*
+ * Decompress a tile.
+ */
+std::shared_ptr<const Tile>
+TileCache::decompress(const CompressedTile& compressed,
+                      const std::size_t size) {
+  auto tile = std::make_shared<Tile>(size);
+
+  decodeRuns(compressed.iterations.values, compressed.iterations.lengths,
+             tile->m_iterations.data());
+  decodeRuns(compressed.z_reals.values, compressed.z_reals.lengths,
+             tile->m_z_reals.data());
+  decodeRuns(compressed.z_imags.values, compressed.z_imags.lengths,
+             tile->m_z_imags.data());
+
+  return tile;
+}
+
+/*
+ * Insert a tile as the most recently used one. The lock must be held.
+ *
+ * @returns The evicted tiles to compress, see `evict`.
+ */
+std::vector<TileCache::Entry>
+TileCache::insert(const TileKey& key, std::shared_ptr<const Tile> tile) {
+  m_bytes += tile->bytes();
+  m_tiles.push_front({key, std::move(tile)});
+  m_index.emplace(key, m_tiles.begin());
+
+  return evict();
+}
+
+/*
+ * Evict the least recently used tiles until the cache is within its capacity.
+ * The lock must be held.
+ *
+ * With compression enabled, the evicted tiles are set aside rather than
+ * dropped, and returned to be compressed by `compress_evicted` once the lock
+ * is released. Until then, requests still find them.
+ *
+ * @returns The evicted tiles to compress.
+ */
+std::vector<TileCache::Entry> TileCache::evict() {
+  std::vector<Entry> evicted;
+
+  while (m_bytes > m_capacity) {
+    Entry entry = std::move(m_tiles.back());
+    m_tiles.pop_back();
+    m_index.erase(entry.key);
+    m_bytes -= entry.tile->bytes();
+
+    if (m_compressed_capacity > 0) {
+      m_compressing.emplace(entry.key, entry.tile);
+      evicted.push_back(std::move(entry));
+    } else {
+      ++m_evictions;
+    }
+  }
+
+  evict_compressed();
+
+  return evicted;
+}
+
+/*
+ * Drop the least recently used compressed tiles until they are within their
+ * capacity. The lock must be held.
+ */
+void TileCache::evict_compressed() {
+  while (m_compressed_bytes > m_compressed_capacity) {
+    const CompressedEntry& entry = m_compressed_tiles.back();
+    m_compressed_bytes -= entry.tile.bytes;
+    ++m_evictions;
+
+    m_compressed_index.erase(entry.key);
+    m_compressed_tiles.pop_back();
+  }
+}
+
+/*
+ * Compress evicted tiles and add them to the compressed tiles. The lock must
+ * not be held, so that other requests aren't held up by the compression.
+ *
+ * Tiles that a request took back in the meantime are skipped, and tiles that
+ * can't be compressed for lack of memory are dropped.
+ *
+ * @param evicted The evicted tiles, see `evict`.
+ */
+void TileCache::compress_evicted(std::vector<Entry> evicted) {
+  if (evicted.empty()) {
+    return;
+  }
+
+  std::vector<CompressedEntry> compressed;
+
+  try {
+    compressed.reserve(evicted.size());
+
+    for (const Entry& entry : evicted) {
+      compressed.push_back({entry.key, compress(*entry.tile)});
+    }
+  } catch (const std::bad_alloc&) {
+    // The tiles that weren't compressed are dropped below.
+  }
+
+  const std::lock_guard lock{m_mutex};
+
+  for (std::size_t i = 0; i < evicted.size(); ++i) {
+    const auto it = m_compressing.find(evicted[i].key);
+
+    if (it == m_compressing.end() || it->second != evicted[i].tile) {
+      continue;
+    }
+
+    m_compressing.erase(it);
+
+    if (i >= compressed.size() || m_compressed_capacity == 0) {
+      ++m_evictions;
+      continue;
+    }
+
+    m_compressed_bytes += compressed[i].tile.bytes;
+    m_compressed_tiles.push_front(std::move(compressed[i]));
+    m_compressed_index.emplace(evicted[i].key, m_compressed_tiles.begin());
+  }
+
+  evict_compressed();
+}
@@ -0,0 +1,51 @@
+/*
+ * This file contains the implementations for the utility functions that the
+ * kernels share out of line.
+ *
+ * The header can be found in: include/utility.hpp
+ */
+
+#include "utility.hpp"
+
+namespace {
+/*
+ * Get the distance between consecutive indices on a bounded axis.
+ *
+ * @param num_spaces The number of spaces to linearly space to bounded axis
+ * into.
+ * @param start The start of the range.
+ * @param end The end of the range.
+ *
+ * @returns The distance between consecutive indices.
+ */
+template <typename T>
+T spacing(const std::size_t num_spaces, const T start, const T end) {
+  return (end - start) / static_cast<T>(num_spaces - 1);
+}
+} // namespace
+
+namespace utility {
+// `noipa` keeps link-time optimization from inlining the functions or cloning
+// them for constant arguments, either of which would round copies differently.
+[[gnu::noipa]] float mapIndexToAxis(const std::size_t idx,
+                                    const std::size_t num_spaces,
+                                    const float start, const float end) {
+  return mapIndexToBoundedAxis(idx, num_spaces, start, end);
+}
+
+[[gnu::noipa]] double mapIndexToAxis(const std::size_t idx,
+                                     const std::size_t num_spaces,
+                                     const double start, const double end) {
+  return mapIndexToBoundedAxis(idx, num_spaces, start, end);
+}
+
+[[gnu::noipa]] float axisSpacing(const std::size_t num_spaces,
+                                 const float start, const float end) {
+  return spacing(num_spaces, start, end);
+}
+
+[[gnu::noipa]] double axisSpacing(const std::size_t num_spaces,
+                                  const double start, const double end) {
+  return spacing(num_spaces, start, end);
+}
+} // namespace utility
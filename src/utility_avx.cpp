@@ -6,13 +6,14 @@
 
 #if defined(MANDELBROT_HAS_AVX)
 
+#include <algorithm>
+
 #include "utility.hpp"
 
 namespace utility::avx {
 __m256 mapRowToImagAxis(const std::size_t row, const std::size_t height,
                         const float imag_min, const float imag_max) {
-  const float imag =
-      utility::mapIndexToBoundedAxis(row, height, imag_max, imag_min);
+  const float imag = mapIndexToAxis(row, height, imag_max, imag_min);
 
   return _mm256_set1_ps(imag);
 }
@@ -25,8 +26,7 @@ __m256 mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
                     static_cast<float>(col + 3), static_cast<float>(col + 2),
                     static_cast<float>(col + 1), static_cast<float>(col + 0));
 
-  const float real_scale =
-      (real_max - real_min) / (static_cast<float>(width - 1));
+  const float real_scale = axisSpacing(width, real_min, real_max);
 
   const __m256 reals = _mm256_fmadd_ps(col_indices, _mm256_set1_ps(real_scale),
                                        _mm256_set1_ps(real_min));
@@ -34,7 +34,7 @@ __m256 mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
   return reals;
 }
 
-std::pair<__m256, __m256>
+Points
 mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
                         const std::size_t width, const std::size_t height,
                         const float real_min, const float real_max,
@@ -45,8 +45,126 @@ mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
   return {reals, imags};
 }
 
+Points
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const float real_min, const float real_max,
+                        const float imag_min, const float imag_max) {
+  alignas(sizeof(__m256)) float cols[8];
+  alignas(sizeof(__m256)) float imags[8];
+
+  for (std::size_t i = 0; i < 8; ++i) {
+    const std::size_t idx = indices[std::min(i, count - 1)];
+
+    cols[i] = static_cast<float>(idx % width);
+    imags[i] = mapIndexToAxis(idx / width, height, imag_max, imag_min);
+  }
+
+  const float real_scale = axisSpacing(width, real_min, real_max);
+
+  const __m256 reals = _mm256_fmadd_ps(_mm256_load_ps(cols),
+                                       _mm256_set1_ps(real_scale),
+                                       _mm256_set1_ps(real_min));
+
+  return {reals, _mm256_load_ps(imags)};
+}
+
 __m256 norm(const __m256 real, const __m256 imag) {
-  return _mm256_add_ps(_mm256_mul_ps(real, real), _mm256_mul_ps(imag, imag));
+  return _mm256_fmadd_ps(real, real, _mm256_mul_ps(imag, imag));
+}
+
+__m256 isInMainCardioidOrBulb(const __m256 real, const __m256 imag) {
+  const __m256 real_shifted = _mm256_sub_ps(real, _mm256_set1_ps(0.25f));
+  const __m256 imag_squared = _mm256_mul_ps(imag, imag);
+  const __m256 q = _mm256_fmadd_ps(real_shifted, real_shifted, imag_squared);
+
+  const __m256 in_cardioid = _mm256_cmp_ps(
+      _mm256_mul_ps(q, _mm256_add_ps(q, real_shifted)),
+      _mm256_mul_ps(_mm256_set1_ps(0.25f), imag_squared), _CMP_LE_OS);
+
+  const __m256 real_bulb = _mm256_add_ps(real, _mm256_set1_ps(1.0f));
+  const __m256 in_bulb =
+      _mm256_cmp_ps(_mm256_fmadd_ps(real_bulb, real_bulb, imag_squared),
+                    _mm256_set1_ps(0.0625f), _CMP_LE_OS);
+
+  return _mm256_or_ps(in_cardioid, in_bulb);
+}
+
+__m256d mapRowToImagAxis(const std::size_t row, const std::size_t height,
+                         const double imag_min, const double imag_max) {
+  const double imag = mapIndexToAxis(row, height, imag_max, imag_min);
+
+  return _mm256_set1_pd(imag);
+}
+
+__m256d mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
+                             const double real_min, const double real_max) {
+  const __m256d col_indices = _mm256_set_pd(
+      static_cast<double>(col + 3), static_cast<double>(col + 2),
+      static_cast<double>(col + 1), static_cast<double>(col + 0));
+
+  const double real_scale = axisSpacing(width, real_min, real_max);
+
+  const __m256d reals = _mm256_fmadd_pd(
+      col_indices, _mm256_set1_pd(real_scale), _mm256_set1_pd(real_min));
+
+  return reals;
+}
+
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max) {
+  const __m256d reals = mapColumnsToRealAxis(col, width, real_min, real_max);
+  const __m256d imags = mapRowToImagAxis(row, height, imag_min, imag_max);
+
+  return {reals, imags};
+}
+
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max) {
+  alignas(sizeof(__m256d)) double cols[4];
+  alignas(sizeof(__m256d)) double imags[4];
+
+  for (std::size_t i = 0; i < 4; ++i) {
+    const std::size_t idx = indices[std::min(i, count - 1)];
+
+    cols[i] = static_cast<double>(idx % width);
+    imags[i] = mapIndexToAxis(idx / width, height, imag_max, imag_min);
+  }
+
+  const double real_scale = axisSpacing(width, real_min, real_max);
+
+  const __m256d reals = _mm256_fmadd_pd(_mm256_load_pd(cols),
+                                        _mm256_set1_pd(real_scale),
+                                        _mm256_set1_pd(real_min));
+
+  return {reals, _mm256_load_pd(imags)};
+}
+
+__m256d norm(const __m256d real, const __m256d imag) {
+  return _mm256_fmadd_pd(real, real, _mm256_mul_pd(imag, imag));
+}
+
+__m256d isInMainCardioidOrBulb(const __m256d real, const __m256d imag) {
+  const __m256d real_shifted = _mm256_sub_pd(real, _mm256_set1_pd(0.25));
+  const __m256d imag_squared = _mm256_mul_pd(imag, imag);
+  const __m256d q = _mm256_fmadd_pd(real_shifted, real_shifted, imag_squared);
+
+  const __m256d in_cardioid = _mm256_cmp_pd(
+      _mm256_mul_pd(q, _mm256_add_pd(q, real_shifted)),
+      _mm256_mul_pd(_mm256_set1_pd(0.25), imag_squared), _CMP_LE_OS);
+
+  const __m256d real_bulb = _mm256_add_pd(real, _mm256_set1_pd(1.0));
+  const __m256d in_bulb =
+      _mm256_cmp_pd(_mm256_fmadd_pd(real_bulb, real_bulb, imag_squared),
+                    _mm256_set1_pd(0.0625), _CMP_LE_OS);
+
+  return _mm256_or_pd(in_cardioid, in_bulb);
 }
 } // namespace utility::avx
 
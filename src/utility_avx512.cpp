@@ -6,13 +6,14 @@
 
 #if defined(MANDELBROT_HAS_AVX512)
 
+#include <algorithm>
+
 #include "utility.hpp"
 
 namespace utility::avx512 {
 __m512 mapRowToImagAxis(const std::size_t row, const std::size_t height,
                         const float imag_min, const float imag_max) {
-  const float imag =
-      utility::mapIndexToBoundedAxis(row, height, imag_max, imag_min);
+  const float imag = mapIndexToAxis(row, height, imag_max, imag_min);
 
   return _mm512_set1_ps(imag);
 }
@@ -29,8 +30,7 @@ __m512 mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
                     static_cast<float>(col + 3), static_cast<float>(col + 2),
                     static_cast<float>(col + 1), static_cast<float>(col + 0));
 
-  const float real_scale =
-      (real_max - real_min) / (static_cast<float>(width - 1));
+  const float real_scale = axisSpacing(width, real_min, real_max);
 
   const __m512 reals = _mm512_fmadd_ps(col_indices, _mm512_set1_ps(real_scale),
                                        _mm512_set1_ps(real_min));
@@ -38,7 +38,7 @@ __m512 mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
   return reals;
 }
 
-std::pair<__m512, __m512>
+Points
 mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
                         const std::size_t width, const std::size_t height,
                         const float real_min, const float real_max,
@@ -49,8 +49,128 @@ mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
   return {reals, imags};
 }
 
+Points
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const float real_min, const float real_max,
+                        const float imag_min, const float imag_max) {
+  alignas(sizeof(__m512)) float cols[16];
+  alignas(sizeof(__m512)) float imags[16];
+
+  for (std::size_t i = 0; i < 16; ++i) {
+    const std::size_t idx = indices[std::min(i, count - 1)];
+
+    cols[i] = static_cast<float>(idx % width);
+    imags[i] = mapIndexToAxis(idx / width, height, imag_max, imag_min);
+  }
+
+  const float real_scale = axisSpacing(width, real_min, real_max);
+
+  const __m512 reals = _mm512_fmadd_ps(_mm512_load_ps(cols),
+                                       _mm512_set1_ps(real_scale),
+                                       _mm512_set1_ps(real_min));
+
+  return {reals, _mm512_load_ps(imags)};
+}
+
 __m512 norm(const __m512 real, const __m512 imag) {
-  return _mm512_add_ps(_mm512_mul_ps(real, real), _mm512_mul_ps(imag, imag));
+  return _mm512_fmadd_ps(real, real, _mm512_mul_ps(imag, imag));
+}
+
+__mmask16 isInMainCardioidOrBulb(const __m512 real, const __m512 imag) {
+  const __m512 real_shifted = _mm512_sub_ps(real, _mm512_set1_ps(0.25f));
+  const __m512 imag_squared = _mm512_mul_ps(imag, imag);
+  const __m512 q = _mm512_fmadd_ps(real_shifted, real_shifted, imag_squared);
+
+  const __mmask16 in_cardioid =
+      _mm512_cmple_ps_mask(_mm512_mul_ps(q, _mm512_add_ps(q, real_shifted)),
+                           _mm512_mul_ps(_mm512_set1_ps(0.25f), imag_squared));
+
+  const __m512 real_bulb = _mm512_add_ps(real, _mm512_set1_ps(1.0f));
+  const __mmask16 in_bulb =
+      _mm512_cmple_ps_mask(_mm512_fmadd_ps(real_bulb, real_bulb, imag_squared),
+                           _mm512_set1_ps(0.0625f));
+
+  return _kor_mask16(in_cardioid, in_bulb);
+}
+
+__m512d mapRowToImagAxis(const std::size_t row, const std::size_t height,
+                         const double imag_min, const double imag_max) {
+  const double imag = mapIndexToAxis(row, height, imag_max, imag_min);
+
+  return _mm512_set1_pd(imag);
+}
+
+__m512d mapColumnsToRealAxis(const std::size_t col, const std::size_t width,
+                             const double real_min, const double real_max) {
+  const __m512d col_indices = _mm512_set_pd(
+      static_cast<double>(col + 7), static_cast<double>(col + 6),
+      static_cast<double>(col + 5), static_cast<double>(col + 4),
+      static_cast<double>(col + 3), static_cast<double>(col + 2),
+      static_cast<double>(col + 1), static_cast<double>(col + 0));
+
+  const double real_scale = axisSpacing(width, real_min, real_max);
+
+  const __m512d reals = _mm512_fmadd_pd(
+      col_indices, _mm512_set1_pd(real_scale), _mm512_set1_pd(real_min));
+
+  return reals;
+}
+
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t row, const std::size_t col,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max) {
+  const __m512d reals = mapColumnsToRealAxis(col, width, real_min, real_max);
+  const __m512d imags = mapRowToImagAxis(row, height, imag_min, imag_max);
+
+  return {reals, imags};
+}
+
+DoublePoints
+mapPixelsToComplexPlane(const std::size_t* indices, const std::size_t count,
+                        const std::size_t width, const std::size_t height,
+                        const double real_min, const double real_max,
+                        const double imag_min, const double imag_max) {
+  alignas(sizeof(__m512d)) double cols[8];
+  alignas(sizeof(__m512d)) double imags[8];
+
+  for (std::size_t i = 0; i < 8; ++i) {
+    const std::size_t idx = indices[std::min(i, count - 1)];
+
+    cols[i] = static_cast<double>(idx % width);
+    imags[i] = mapIndexToAxis(idx / width, height, imag_max, imag_min);
+  }
+
+  const double real_scale = axisSpacing(width, real_min, real_max);
+
+  const __m512d reals = _mm512_fmadd_pd(_mm512_load_pd(cols),
+                                        _mm512_set1_pd(real_scale),
+                                        _mm512_set1_pd(real_min));
+
+  return {reals, _mm512_load_pd(imags)};
+}
+
+__m512d norm(const __m512d real, const __m512d imag) {
+  return _mm512_fmadd_pd(real, real, _mm512_mul_pd(imag, imag));
+}
+
+__mmask8 isInMainCardioidOrBulb(const __m512d real, const __m512d imag) {
+  const __m512d real_shifted = _mm512_sub_pd(real, _mm512_set1_pd(0.25));
+  const __m512d imag_squared = _mm512_mul_pd(imag, imag);
+  const __m512d q = _mm512_fmadd_pd(real_shifted, real_shifted, imag_squared);
+
+  const __mmask8 in_cardioid =
+      _mm512_cmple_pd_mask(_mm512_mul_pd(q, _mm512_add_pd(q, real_shifted)),
+                           _mm512_mul_pd(_mm512_set1_pd(0.25), imag_squared));
+
+  const __m512d real_bulb = _mm512_add_pd(real, _mm512_set1_pd(1.0));
+  const __mmask8 in_bulb =
+      _mm512_cmple_pd_mask(_mm512_fmadd_pd(real_bulb, real_bulb, imag_squared),
+                           _mm512_set1_pd(0.0625));
+
+  return static_cast<__mmask8>(in_cardioid | in_bulb);
 }
 } // namespace utility::avx512
 #endif
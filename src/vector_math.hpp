@@ -0,0 +1,153 @@
+/*
+ * This file contains vector approximations of the math functions that AVX2
+ * and AVX512 lack, shared by the Mandelbrot and colorization kernels.
+ *
+ * The logarithm is a polynomial approximation that is accurate to about 1e-6.
+ * The functions are inline, so that the kernels that use them in their loops
+ * don't call into another translation unit. Each set is only available in
+ * translation units compiled for its instruction set.
+ */
+
+#pragma once
+
+#include <numbers>
+
+#include <immintrin.h>
+
+namespace vector_math {
+#if defined(__AVX2__)
+namespace avx2 {
+/*
+ * Calculate the base-2 logarithms of positive, normal numbers.
+ *
+ * @param x The numbers.
+ *
+ * @returns The logarithms.
+ */
+inline __m256 log2(const __m256 x) {
+  const __m256i bits = _mm256_castps_si256(x);
+  const __m256 exponent = _mm256_cvtepi32_ps(
+      _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+  const __m256 mantissa = _mm256_castsi256_ps(
+      _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                      _mm256_set1_epi32(0x3F800000)));
+
+  // log2(m) = 2 / ln(2) * atanh(s), with s = (m - 1) / (m + 1) in [0, 1/3).
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 s = _mm256_div_ps(_mm256_sub_ps(mantissa, one),
+                                 _mm256_add_ps(mantissa, one));
+  const __m256 s2 = _mm256_mul_ps(s, s);
+
+  __m256 series = _mm256_set1_ps(1.0f / 9.0f);
+
+  for (const float coefficient :
+       {1.0f / 7.0f, 1.0f / 5.0f, 1.0f / 3.0f, 1.0f}) {
+    series = _mm256_add_ps(_mm256_mul_ps(series, s2),
+                           _mm256_set1_ps(coefficient));
+  }
+
+  return _mm256_add_ps(
+      exponent,
+      _mm256_mul_ps(_mm256_mul_ps(series, s),
+                    _mm256_set1_ps(2.0f / std::numbers::ln2_v<float>)));
+}
+
+/*
+ * Calculate the smooth iteration counts of eight pixels, see
+ * `utility::smoothIteration`.
+ *
+ * @param iterations The iteration counts.
+ * @param norm The norms of the final z-values.
+ * @param max_iterations The maximum iterations.
+ *
+ * @returns The smooth iteration counts, or the maximum iterations for the
+ * pixels that didn't escape.
+ */
+inline __m256 smoothIterations(const __m256i iterations, const __m256 norm,
+                               const unsigned int max_iterations) {
+  const __m256i max = _mm256_set1_epi32(static_cast<int>(max_iterations));
+  const __m256 inside = _mm256_castsi256_ps(
+      _mm256_cmpeq_epi32(_mm256_max_epu32(iterations, max), iterations));
+
+  // n + 1 - log2(log2(|z|^2) / 2) = n + 2 - log2(log2(|z|^2))
+  const __m256 value =
+      _mm256_sub_ps(_mm256_add_ps(_mm256_cvtepi32_ps(iterations),
+                                  _mm256_set1_ps(2.0f)),
+                    log2(log2(norm)));
+
+  return _mm256_blendv_ps(
+      value, _mm256_set1_ps(static_cast<float>(max_iterations)), inside);
+}
+} // namespace avx2
+#endif
+
+#if defined(__AVX512F__)
+namespace avx512 {
+// Every lane. The functions use the zero-masked forms of the intrinsics that
+// would otherwise pass undefined values through, which GCC warns about.
+constexpr __mmask16 all = 0xFFFF;
+
+/*
+ * Calculate the base-2 logarithms of positive, normal numbers.
+ *
+ * @param x The numbers.
+ *
+ * @returns The logarithms.
+ */
+inline __m512 log2(const __m512 x) {
+  const __m512i bits = _mm512_castps_si512(x);
+  const __m512 exponent = _mm512_maskz_cvtepi32_ps(
+      all, _mm512_sub_epi32(_mm512_maskz_srli_epi32(all, bits, 23),
+                            _mm512_set1_epi32(127)));
+  const __m512 mantissa = _mm512_castsi512_ps(
+      _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)),
+                      _mm512_set1_epi32(0x3F800000)));
+
+  // log2(m) = 2 / ln(2) * atanh(s), with s = (m - 1) / (m + 1) in [0, 1/3).
+  const __m512 one = _mm512_set1_ps(1.0f);
+  const __m512 s = _mm512_div_ps(_mm512_sub_ps(mantissa, one),
+                                 _mm512_add_ps(mantissa, one));
+  const __m512 s2 = _mm512_mul_ps(s, s);
+
+  __m512 series = _mm512_set1_ps(1.0f / 9.0f);
+
+  for (const float coefficient :
+       {1.0f / 7.0f, 1.0f / 5.0f, 1.0f / 3.0f, 1.0f}) {
+    series = _mm512_add_ps(_mm512_mul_ps(series, s2),
+                           _mm512_set1_ps(coefficient));
+  }
+
+  return _mm512_add_ps(
+      exponent,
+      _mm512_mul_ps(_mm512_mul_ps(series, s),
+                    _mm512_set1_ps(2.0f / std::numbers::ln2_v<float>)));
+}
+
+/*
+ * Calculate the smooth iteration counts of sixteen pixels, see
+ * `utility::smoothIteration`.
+ *
+ * @param iterations The iteration counts.
+ * @param norm The norms of the final z-values.
+ * @param max_iterations The maximum iterations.
+ *
+ * @returns The smooth iteration counts, or the maximum iterations for the
+ * pixels that didn't escape.
+ */
+inline __m512 smoothIterations(const __m512i iterations, const __m512 norm,
+                               const unsigned int max_iterations) {
+  const __mmask16 escaped = _mm512_cmplt_epu32_mask(
+      iterations, _mm512_set1_epi32(static_cast<int>(max_iterations)));
+
+  // n + 1 - log2(log2(|z|^2) / 2) = n + 2 - log2(log2(|z|^2))
+  const __m512 value =
+      _mm512_sub_ps(_mm512_add_ps(_mm512_maskz_cvtepi32_ps(all, iterations),
+                                  _mm512_set1_ps(2.0f)),
+                    log2(log2(norm)));
+
+  return _mm512_mask_blend_ps(
+      escaped, _mm512_set1_ps(static_cast<float>(max_iterations)), value);
+}
+} // namespace avx512
+#endif
+} // namespace vector_math
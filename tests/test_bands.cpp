@@ -0,0 +1,66 @@
+/*
+ * This test checks that computing an image in bands of rows hands every row
+ * to the sink once, in order, with the pixels of a computation of the whole
+ * image.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "test_common.hpp"
+
+using namespace test;
+
+namespace {
+/*
+ * Check that the bands of an image equal the image computed as a whole.
+ *
+ * The band height doesn't divide the height of the image, so that the last
+ * band is shorter.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy.
+ * @tparam T The scalar type.
+ */
+template <Backend B, Execution Exec, Scalar T> void checkBands() {
+  constexpr std::size_t band_height = 10;
+  const std::string what = name<B, Exec, T>() + " bands";
+
+  MandelbrotEngine<B, Exec, T> whole{width, height, bounds, max_iterations};
+  MandelbrotEngine<B, Exec, T> banded{width, height, bounds, max_iterations};
+
+  const auto expected = whole.compute();
+  std::size_t next_row = 0;
+  std::size_t mismatches = 0;
+  bool ordered = true;
+
+  banded.compute_bands(band_height, [&](const MandelbrotBand<T>& band) {
+    ordered = ordered && band.first_row() == next_row &&
+              band.width() == width &&
+              band.height() == std::min(band_height, height - next_row);
+
+    for (std::size_t row = 0; row < band.height(); ++row) {
+      for (std::size_t col = 0; col < width; ++col) {
+        const auto e = expected(band.first_row() + row, col);
+        const auto a = band(row, col);
+
+        mismatches += e.iteration != a.iteration || e.z != a.z;
+      }
+    }
+
+    next_row += band.height();
+  });
+
+  check(ordered, (what + " are handed over in order").c_str());
+  check(next_row == height, (what + " cover the image").c_str());
+  check(mismatches == 0, (what + " equal the whole image").c_str());
+}
+} // namespace
+
+int main() {
+  forEachBackend(
+      []<Backend B, Execution Exec, Scalar T>() { checkBands<B, Exec, T>(); },
+      true);
+
+  return result(true);
+}
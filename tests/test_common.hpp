@@ -0,0 +1,159 @@
+/*
+ * This file contains the helpers shared by the tests.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "mandelbrot_engine.hpp"
+
+namespace test {
+// The image of the comparisons. Its middle row, row 58, is the real axis.
+constexpr std::size_t width = 203, height = 117;
+constexpr unsigned int max_iterations = 500;
+inline const ViewBounds bounds{-2.0, 0.6, -1.2, 1.2};
+
+// The exit code of a test that the host can't run, see tests/CMakeLists.txt.
+constexpr int skipped = 77;
+
+inline int failures = 0;
+
+/*
+ * Record a failure if a condition doesn't hold.
+ *
+ * @param condition The condition.
+ * @param what The name of the condition.
+ */
+inline void check(bool condition, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++failures;
+  }
+}
+
+/*
+ * Count the pixels whose iteration count or z-value differ between two
+ * results, bit for bit.
+ *
+ * @param expected The expected result.
+ * @param actual The actual result.
+ * @param what The name of the comparison, printed with the count if any
+ * differ.
+ * @param z_values Whether to compare the z-values as well.
+ *
+ * @returns The number of differing pixels.
+ */
+template <typename Result>
+std::size_t countMismatches(const Result& expected, const Result& actual,
+                            const char* what, bool z_values = true) {
+  std::size_t mismatches = 0;
+
+  for (std::size_t row = 0; row < height; ++row) {
+    for (std::size_t col = 0; col < width; ++col) {
+      const auto e = expected(row, col);
+      const auto a = actual(row, col);
+
+      mismatches += e.iteration != a.iteration || (z_values && e.z != a.z);
+    }
+  }
+
+  if (mismatches != 0) {
+    std::fprintf(stderr, "%s: %zu pixels differ\n", what, mismatches);
+  }
+
+  return mismatches;
+}
+
+/*
+ * Get the name of a configuration, such as "AVX2 OMP float".
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy.
+ * @tparam T The scalar type.
+ *
+ * @returns The name.
+ */
+template <Backend B, Execution Exec, Scalar T> std::string name() {
+  return std::string{B::name()} + " " + std::string{Exec::name()} +
+         (sizeof(T) == sizeof(float) ? " float" : " double");
+}
+
+/*
+ * Run a check on a backend in both precisions, on every execution policy.
+ *
+ * @tparam B The backend.
+ *
+ * @param check The check, a generic lambda called with the backend, the
+ * execution policy and the scalar type as template arguments.
+ */
+template <Backend B, typename Check> void forEachPolicy(const Check& check) {
+  check.template operator()<B, exec::Default, float>();
+  check.template operator()<B, exec::Default, double>();
+
+#if defined(MANDELBROT_HAS_OMP)
+  check.template operator()<B, exec::OMP, float>();
+  check.template operator()<B, exec::OMP, double>();
+  check.template operator()<B, exec::WorkStealing, float>();
+  check.template operator()<B, exec::WorkStealing, double>();
+#endif
+}
+
+/*
+ * Run a check on every CPU backend that the host can run, see
+ * `forEachPolicy`.
+ *
+ * @param check The check.
+ * @param serial Whether to run the check on the serial backend as well.
+ *
+ * @returns Whether the check ran on any backend.
+ */
+template <typename Check> bool forEachBackend(const Check& check, bool serial) {
+  bool tested = false;
+
+  if (serial) {
+    forEachPolicy<backend::Serial>(check);
+    tested = true;
+  }
+
+#if defined(MANDELBROT_HAS_AVX2)
+  if (backend::AVX2::is_available()) {
+    forEachPolicy<backend::AVX2>(check);
+    tested = true;
+  }
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+  if (backend::AVX512::is_available()) {
+    forEachPolicy<backend::AVX512>(check);
+    tested = true;
+  }
+#endif
+
+#if defined(MANDELBROT_HAS_PORTABLE)
+  if (backend::Portable::is_available()) {
+    forEachPolicy<backend::Portable>(check);
+    tested = true;
+  }
+#endif
+
+  return tested;
+}
+
+/*
+ * Get the exit code of a test.
+ *
+ * @param tested Whether the host could run any of the checks.
+ *
+ * @returns The exit code.
+ */
+inline int result(bool tested) {
+  if (!tested) {
+    return skipped;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
+} // namespace test
@@ -0,0 +1,94 @@
+/*
+ * This test checks that an engine taken from a pool has the default settings,
+ * whatever the request that used it before changed.
+ */
+
+#include "engine_pool.hpp"
+#include "test_common.hpp"
+
+using namespace test;
+
+namespace {
+/*
+ * Check that the settings of one request don't carry over into the next.
+ *
+ * @tparam Exec The execution policy.
+ */
+template <Execution Exec> void checkDefaults() {
+  using Engine = MandelbrotEngine<backend::Serial, Exec, float, channels::Full>;
+
+  EnginePool<backend::Serial, Exec> pool;
+  const Engine* first = nullptr;
+
+  // Request A changes every setting.
+  {
+    auto engine = pool.acquire(width, height, bounds, max_iterations);
+    first = engine.get();
+
+    engine->set_bailout_radius(16.0);
+    engine->set_interior_detection(true);
+    engine->set_render_mode(RenderMode::Subdivision);
+    engine->set_kernel_variant(KernelVariant::LaneRefill);
+    engine->set_interleaving(2, 4);
+    engine->set_incremental(true);
+    engine->set_supersampling(4, SamplePattern::Jittered, 0.5f);
+
+#if defined(MANDELBROT_HAS_OMP)
+    if constexpr (!std::is_same_v<Exec, exec::Default>) {
+      engine->set_thread_placement(ThreadPlacement::Spread);
+    }
+#endif
+
+    engine->compute();
+  }
+
+  // Request B takes the same engine, with the defaults of a new one.
+  auto engine = pool.acquire(width, height, bounds, max_iterations / 2);
+  const Engine fresh{width, height, bounds, max_iterations / 2};
+
+  check(engine.get() == first, "the engine is reused");
+  check(engine->max_iterations() == max_iterations / 2,
+        "the maximum iterations are those of the request");
+  check(engine->bailout_radius() == fresh.bailout_radius(),
+        "the bailout radius is reset");
+  check(engine->interior_detection() == fresh.interior_detection(),
+        "interior detection is reset");
+  check(engine->render_mode() == fresh.render_mode(),
+        "the render mode is reset");
+  check(engine->kernel_variant() == fresh.kernel_variant(),
+        "the kernel variant is reset");
+  check(engine->interleaving() == fresh.interleaving(),
+        "the interleaving is reset");
+  check(engine->incremental() == fresh.incremental(),
+        "incremental rendering is reset");
+  check(engine->supersampling() == fresh.supersampling() &&
+            engine->sample_pattern() == fresh.sample_pattern() &&
+            engine->edge_threshold() == fresh.edge_threshold(),
+        "supersampling is reset");
+
+#if defined(MANDELBROT_HAS_OMP)
+  if constexpr (!std::is_same_v<Exec, exec::Default>) {
+    check(engine->thread_placement() == fresh.thread_placement(),
+          "the thread placement is reset");
+  }
+#endif
+
+  // The engine computes like a new one.
+  Engine direct{width, height, bounds, max_iterations / 2};
+  const auto expected = direct.compute();
+  const auto actual = engine->compute();
+
+  check(countMismatches(expected, actual, "pooled engine") == 0,
+        "the pooled engine computes like a new one");
+}
+} // namespace
+
+int main() {
+  checkDefaults<exec::Default>();
+
+#if defined(MANDELBROT_HAS_OMP)
+  checkDefaults<exec::OMP>();
+#endif
+
+  return result(true);
+}
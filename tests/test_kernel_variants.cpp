@@ -0,0 +1,61 @@
+/*
+ * This test checks that the lane-refill and interleaved kernels give the same
+ * iteration counts and z-values as the block kernels, bit for bit, on every
+ * SIMD backend and execution policy.
+ */
+
+#include <string>
+
+#include "test_common.hpp"
+
+using namespace test;
+
+namespace {
+/*
+ * Check that a render with a kernel variant equals a block render.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy of the render with the variant.
+ * @tparam T The scalar type.
+ *
+ * @param variant The kernel variant.
+ * @param interior_detection Whether interior detection is enabled.
+ */
+template <Backend B, Execution Exec, Scalar T>
+void checkVariant(KernelVariant variant, bool interior_detection) {
+  const std::string what =
+      name<B, Exec, T>() +
+      (variant == KernelVariant::LaneRefill ? " lane refill" : " interleaved") +
+      (interior_detection ? " with interior detection" : "");
+
+  MandelbrotEngine<B, exec::Default, T> block{width, height, bounds,
+                                              max_iterations};
+  MandelbrotEngine<B, Exec, T> other{width, height, bounds, max_iterations};
+  block.set_interior_detection(interior_detection);
+  other.set_interior_detection(interior_detection);
+  other.set_kernel_variant(variant);
+
+  const auto expected = block.compute();
+  const auto actual = other.compute();
+
+  check(countMismatches(expected, actual, what.c_str()) == 0, what.c_str());
+}
+} // namespace
+
+int main() {
+  bool tested = false;
+
+  for (const KernelVariant variant :
+       {KernelVariant::LaneRefill, KernelVariant::Interleaved}) {
+    for (const bool interior_detection : {false, true}) {
+      // The serial backend has no kernel variants.
+      tested = forEachBackend(
+          [&]<Backend B, Execution Exec, Scalar T>() {
+            checkVariant<B, Exec, T>(variant, interior_detection);
+          },
+          false);
+    }
+  }
+
+  return result(tested);
+}
@@ -0,0 +1,150 @@
+/*
+ * This test checks that pixels given as a list of indices are mapped onto the
+ * complex plane exactly like the same pixels given as a run of consecutive
+ * pixels, and that the subdivision render mode, which maps the borders of its
+ * rectangles as lists, matches a full render on every backend.
+ */
+
+#include <cstring>
+#include <numeric>
+#include <string>
+
+#include "test_common.hpp"
+#include "utility.hpp"
+
+using namespace test;
+
+namespace {
+/*
+ * Check that the list overload of `mapPixelsToComplexPlane` maps every pixel of
+ * the image like the run overload, bit for bit.
+ *
+ * @tparam lanes The number of lanes of a vector.
+ * @tparam T The scalar type.
+ *
+ * @param map_run Maps the run of pixels at a row and column.
+ * @param map_list Maps the pixels at a list of indices.
+ * @param what The name of the mapping.
+ */
+template <std::size_t lanes, typename T, typename MapRun, typename MapList>
+void checkMapping(MapRun map_run, MapList map_list, const char* what) {
+  std::size_t mismatches = 0;
+
+  for (std::size_t row = 0; row < height; ++row) {
+    for (std::size_t col = 0; col + lanes <= width; col += lanes) {
+      std::size_t indices[lanes];
+      std::iota(indices, indices + lanes, row * width + col);
+
+      T run_real[lanes], run_imag[lanes], list_real[lanes], list_imag[lanes];
+      map_run(row, col, run_real, run_imag);
+      map_list(indices, list_real, list_imag);
+
+      if (std::memcmp(run_real, list_real, sizeof(run_real)) != 0 ||
+          std::memcmp(run_imag, list_imag, sizeof(run_imag)) != 0) {
+        ++mismatches;
+      }
+
+      if (row == height / 2) {
+        check(run_imag[0] == T{0} && list_imag[0] == T{0},
+              "the middle row maps to the real axis");
+      }
+    }
+  }
+
+  if (mismatches != 0) {
+    std::fprintf(stderr, "%s: %zu vectors mapped differently\n", what,
+                 mismatches);
+  }
+
+  check(mismatches == 0, what);
+}
+
+/*
+ * Check that a subdivision render has the iteration counts of a full render.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy.
+ * @tparam T The scalar type.
+ */
+template <Backend B, Execution Exec, Scalar T> void checkSubdivision() {
+  const std::string what = name<B, Exec, T>() + " subdivision";
+
+  MandelbrotEngine<B, Exec, T> full{width, height, bounds, max_iterations};
+  MandelbrotEngine<B, Exec, T> subdivided{width, height, bounds,
+                                          max_iterations};
+  subdivided.set_render_mode(RenderMode::Subdivision);
+
+  const auto expected = full.compute();
+  const auto actual = subdivided.compute();
+
+  check(expected.iteration(height / 2, 0) == max_iterations,
+        "the real axis is inside the set");
+  check(countMismatches(expected, actual, what.c_str(), false) == 0,
+        what.c_str());
+}
+
+// The mappings are called through plain pointers, so that only they need the
+// instruction sets of the backends.
+#define MAP_FUNCTIONS(isa, ns, lanes, T, storeu)                               \
+  [[gnu::target(isa)]] void mapRun_##ns##_##T(                                  \
+      std::size_t row, std::size_t col, T* real, T* imag) {                    \
+    const auto [r, i] = utility::ns::mapPixelsToComplexPlane(                  \
+        row, col, width, height, static_cast<T>(bounds.real_min),              \
+        static_cast<T>(bounds.real_max), static_cast<T>(bounds.imag_min),      \
+        static_cast<T>(bounds.imag_max));                                      \
+    storeu(real, r);                                                           \
+    storeu(imag, i);                                                           \
+  }                                                                            \
+                                                                               \
+  [[gnu::target(isa)]] void mapList_##ns##_##T(const std::size_t* indices,     \
+                                               T* real, T* imag) {             \
+    const auto [r, i] = utility::ns::mapPixelsToComplexPlane(                  \
+        indices, lanes, width, height, static_cast<T>(bounds.real_min),        \
+        static_cast<T>(bounds.real_max), static_cast<T>(bounds.imag_min),      \
+        static_cast<T>(bounds.imag_max));                                      \
+    storeu(real, r);                                                           \
+    storeu(imag, i);                                                           \
+  }
+
+#if defined(MANDELBROT_HAS_AVX2)
+MAP_FUNCTIONS("avx2,fma", avx, 8, float, _mm256_storeu_ps)
+MAP_FUNCTIONS("avx2,fma", avx, 4, double, _mm256_storeu_pd)
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+MAP_FUNCTIONS("avx512f", avx512, 16, float, _mm512_storeu_ps)
+MAP_FUNCTIONS("avx512f", avx512, 8, double, _mm512_storeu_pd)
+#endif
+} // namespace
+
+int main() {
+  bool tested = false;
+
+#if defined(MANDELBROT_HAS_AVX2)
+  if (backend::AVX2::is_available()) {
+    checkMapping<8, float>(mapRun_avx_float, mapList_avx_float,
+                           "AVX2 float mapping");
+    checkMapping<4, double>(mapRun_avx_double, mapList_avx_double,
+                            "AVX2 double mapping");
+    tested = true;
+  }
+#endif
+
+#if defined(MANDELBROT_HAS_AVX512)
+  if (backend::AVX512::is_available()) {
+    checkMapping<16, float>(mapRun_avx512_float, mapList_avx512_float,
+                            "AVX512 float mapping");
+    checkMapping<8, double>(mapRun_avx512_double, mapList_avx512_double,
+                            "AVX512 double mapping");
+    tested = true;
+  }
+#endif
+
+  tested |= forEachBackend(
+      []<Backend B, Execution Exec, Scalar T>() {
+        checkSubdivision<B, Exec, T>();
+      },
+      true);
+
+  return result(tested);
+}
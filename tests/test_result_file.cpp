@@ -0,0 +1,104 @@
+/*
+ * This test checks that an engine storing its results in a file computes the
+ * image it would compute in memory, and that the file can be opened again with
+ * the header and arrays the engine wrote.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "result_file.hpp"
+#include "test_common.hpp"
+
+using namespace test;
+
+namespace {
+/*
+ * Check that a result file round-trips the result of a computation.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy.
+ * @tparam T The scalar type.
+ *
+ * @param path The path of the file.
+ */
+template <Backend B, Execution Exec, Scalar T>
+void checkRoundTrip(const std::filesystem::path& path) {
+  const std::string what = name<B, Exec, T>() + " result file";
+
+  MandelbrotEngine<B, Exec, T> memory{width, height, bounds, max_iterations};
+  const auto expected = memory.compute();
+
+  {
+    MandelbrotEngine<B, Exec, T> mapped{width, height, bounds, max_iterations};
+    mapped.map_results(path);
+    const auto actual = mapped.compute();
+
+    check(countMismatches(expected, actual, what.c_str()) == 0,
+          (what + " computes like memory").c_str());
+  }
+
+  const result_file::Mapping file = result_file::Mapping::open(path);
+  const result_file::Header& header = file.header();
+
+  check(header.magic == result_file::magic &&
+            header.version == result_file::version &&
+            header.scalar_size == sizeof(T) && header.width == width &&
+            header.height == height,
+        (what + " has the layout of the image").c_str());
+  check(header.real_min == bounds.real_min &&
+            header.real_max == bounds.real_max &&
+            header.imag_min == bounds.imag_min &&
+            header.imag_max == bounds.imag_max &&
+            header.max_iterations == max_iterations,
+        (what + " records the computation").c_str());
+
+  std::size_t mismatches = 0;
+
+  for (std::size_t row = 0; row < height; ++row) {
+    for (std::size_t col = 0; col < width; ++col) {
+      const std::size_t idx = row * width + col;
+      const auto e = expected(row, col);
+
+      mismatches += file.iterations()[idx] != e.iteration ||
+                    file.z_reals<T>()[idx] != e.z.real() ||
+                    file.z_imags<T>()[idx] != e.z.imag();
+    }
+  }
+
+  check(mismatches == 0, (what + " holds the result").c_str());
+}
+
+// Check that a file that isn't a result file is refused.
+void checkForeignFile(const std::filesystem::path& path) {
+  std::ofstream{path} << std::string(8192, 'x');
+  bool refused = false;
+
+  try {
+    result_file::Mapping::open(path);
+  } catch (const std::runtime_error&) {
+    refused = true;
+  }
+
+  check(refused, "a file that isn't a result file is refused");
+}
+} // namespace
+
+int main() {
+  const std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "mandelbrot_test_result_file.mbr";
+
+  forEachBackend(
+      [&]<Backend B, Execution Exec, Scalar T>() {
+        checkRoundTrip<B, Exec, T>(path);
+      },
+      true);
+  checkForeignFile(path);
+
+  std::filesystem::remove(path);
+
+  return result(true);
+}
@@ -0,0 +1,77 @@
+/*
+ * This test checks that resuming a computation at a higher maximum iterations
+ * gives the result of computing the image with it directly, whatever the kernel
+ * variant and render mode.
+ */
+
+#include <string>
+#include <utility>
+
+#include "test_common.hpp"
+
+using namespace test;
+
+namespace {
+/*
+ * Check that a resumed computation equals a direct one.
+ *
+ * Pixels found by interior detection keep the z-value of their detection, and
+ * pixels filled in by subdivision have none of their own, so in either case
+ * only the iteration counts are compared.
+ *
+ * @tparam B The backend.
+ * @tparam Exec The execution policy.
+ * @tparam T The scalar type.
+ *
+ * @param interior_detection Whether interior detection is enabled.
+ * @param variant The kernel variant.
+ * @param mode The render mode.
+ */
+template <Backend B, Execution Exec, Scalar T>
+void checkResume(bool interior_detection, KernelVariant variant,
+                 RenderMode mode) {
+  const std::string what =
+      name<B, Exec, T>() +
+      (interior_detection ? " with interior detection" : "") +
+      (variant == KernelVariant::Interleaved ? " interleaved" : "") +
+      (mode == RenderMode::Subdivision ? " subdivided" : "");
+
+  MandelbrotEngine<B, Exec, T> direct{width, height, bounds, max_iterations};
+  MandelbrotEngine<B, Exec, T> resumed{width, height, bounds,
+                                       max_iterations / 4};
+
+  for (auto* engine : {&direct, &resumed}) {
+    engine->set_interior_detection(interior_detection);
+    engine->set_kernel_variant(variant);
+    engine->set_render_mode(mode);
+  }
+
+  const auto expected = direct.compute();
+  resumed.compute();
+  const auto actual = resumed.resume(max_iterations);
+
+  const bool z_values = !interior_detection && mode == RenderMode::Full;
+  check(countMismatches(expected, actual, what.c_str(), z_values) == 0,
+        what.c_str());
+}
+} // namespace
+
+int main() {
+  const std::pair<KernelVariant, RenderMode> renders[] = {
+      {KernelVariant::Block, RenderMode::Full},
+      {KernelVariant::Interleaved, RenderMode::Full},
+      {KernelVariant::Block, RenderMode::Subdivision},
+  };
+
+  for (const bool interior_detection : {false, true}) {
+    for (const auto& [variant, mode] : renders) {
+      forEachBackend(
+          [&]<Backend B, Execution Exec, Scalar T>() {
+            checkResume<B, Exec, T>(interior_detection, variant, mode);
+          },
+          true);
+    }
+  }
+
+  return result(true);
+}
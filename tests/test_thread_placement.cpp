@@ -0,0 +1,66 @@
+/*
+ * This test checks that the thread calling an engine with a thread placement
+ * may run on the same CPUs after the computation as before it.
+ */
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "test_common.hpp"
+
+using namespace test;
+
+#if defined(MANDELBROT_HAS_OMP) && defined(__linux__)
+namespace {
+/*
+ * Check that computing with a placement leaves the CPUs of the calling thread
+ * as they were.
+ *
+ * @tparam Exec The execution policy.
+ *
+ * @param before The CPUs of the calling thread before the computation.
+ * @param placement The placement of the threads.
+ * @param what The name of the check.
+ */
+template <Execution Exec>
+void checkRestored(const cpu_set_t& before, ThreadPlacement placement,
+                   const char* what) {
+  MandelbrotEngine<backend::Serial, Exec> engine{width, height, bounds,
+                                                 max_iterations};
+  engine.set_thread_placement(placement);
+  engine.compute();
+
+  cpu_set_t after;
+  CPU_ZERO(&after);
+  sched_getaffinity(0, sizeof(after), &after);
+
+  check(CPU_EQUAL(&before, &after), what);
+}
+} // namespace
+#endif
+
+int main() {
+#if defined(MANDELBROT_HAS_OMP) && defined(__linux__)
+  cpu_set_t before;
+  CPU_ZERO(&before);
+
+  // A thread that may only run on one CPU stays there either way.
+  if (sched_getaffinity(0, sizeof(before), &before) != 0 ||
+      CPU_COUNT(&before) < 2) {
+    return result(false);
+  }
+
+  for (const ThreadPlacement placement :
+       {ThreadPlacement::Close, ThreadPlacement::Spread}) {
+    checkRestored<exec::OMP>(before, placement,
+                             "OMP leaves the calling thread unpinned");
+    checkRestored<exec::WorkStealing>(
+        before, placement, "WorkStealing leaves the calling thread unpinned");
+  }
+
+  return result(true);
+#else
+  return result(false);
+#endif
+}
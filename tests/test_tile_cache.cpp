@@ -0,0 +1,160 @@
+/*
+ * This test checks that the tile cache computes tiles like an engine, serves
+ * repeated and concurrent requests for a tile from a single computation, and
+ * evicts the least recently used tiles, keeping them compressed if asked to.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "test_common.hpp"
+#include "tile_cache.hpp"
+
+using namespace test;
+
+namespace {
+constexpr std::size_t tile_size = 64;
+
+// The memory taken by a tile.
+constexpr std::size_t tile_bytes =
+    tile_size * tile_size * (sizeof(unsigned int) + 2 * sizeof(float));
+
+/*
+ * Get the key of a tile of zoom level 2, computed on the serial backend.
+ *
+ * @param x The column of the tile.
+ * @param y The row of the tile.
+ *
+ * @returns The key.
+ */
+TileKey key(std::uint64_t x, std::uint64_t y) {
+  return {2, x, y, max_iterations, "Serial"};
+}
+
+/*
+ * Check whether two tiles hold the same pixels, bit for bit.
+ *
+ * @param a The first tile.
+ * @param b The second tile.
+ *
+ * @returns Whether the tiles are equal.
+ */
+bool equal(const Tile& a, const Tile& b) {
+  for (std::size_t row = 0; row < tile_size; ++row) {
+    for (std::size_t col = 0; col < tile_size; ++col) {
+      if (a(row, col).iteration != b(row, col).iteration ||
+          a(row, col).z != b(row, col).z) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Check that a tile holds the result of an engine computing its bounds.
+void checkContents() {
+  TileCache cache{16 * tile_bytes, tile_size};
+  const auto tile = cache.get(key(1, 2));
+
+  MandelbrotEngine<backend::Serial, exec::Default> engine{
+      tile_size, tile_size, cache.bounds(key(1, 2)), max_iterations};
+  const auto expected = engine.compute();
+  bool same = tile->size() == tile_size;
+
+  for (std::size_t row = 0; row < tile_size && same; ++row) {
+    for (std::size_t col = 0; col < tile_size && same; ++col) {
+      same = (*tile)(row, col).iteration == expected(row, col).iteration &&
+             (*tile)(row, col).z == expected(row, col).z;
+    }
+  }
+
+  check(same, "a tile holds the pixels of its bounds");
+  check(cache.get(key(1, 2)) == tile, "a repeated request shares the tile");
+
+  const TileCacheStats stats = cache.stats();
+  check(stats.misses == 1 && stats.hits == 1,
+        "a repeated request is served from the cache");
+}
+
+// Check that concurrent requests for a tile wait for a single computation.
+void checkCoalescing() {
+  constexpr std::size_t requests = 8;
+
+  TileCache cache{16 * tile_bytes, tile_size};
+  std::vector<std::shared_ptr<const Tile>> tiles(requests);
+  std::vector<std::thread> threads;
+
+  for (std::size_t i = 0; i < requests; ++i) {
+    threads.emplace_back([&, i] { tiles[i] = cache.get(key(0, 1)); });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  bool shared = true;
+
+  for (const auto& tile : tiles) {
+    shared = shared && tile == tiles.front();
+  }
+
+  // Requests that arrive after the computation finished are hits instead.
+  const TileCacheStats stats = cache.stats();
+  check(shared, "concurrent requests share the tile");
+  check(stats.misses == 1 && stats.coalesced + stats.hits == requests - 1,
+        "concurrent requests compute the tile once");
+}
+
+// Check that the least recently used tiles are evicted first.
+void checkEviction() {
+  TileCache cache{2 * tile_bytes, tile_size};
+
+  const auto a = cache.get(key(0, 0));
+  const auto b = cache.get(key(0, 1));
+  cache.get(key(0, 0));
+  cache.get(key(0, 2));
+
+  const TileCacheStats stats = cache.stats();
+  check(stats.evictions == 1 && stats.bytes <= cache.capacity(),
+        "the cache stays within its capacity");
+
+  // The most recently used tile stays, the least recently used one was
+  // evicted, but is still valid for its holders.
+  check(cache.get(key(0, 0)) == a, "the recently used tile stays");
+  check(b->size() == tile_size, "an evicted tile stays valid");
+
+  cache.get(key(0, 1));
+  check(cache.stats().misses == 4, "an evicted tile is computed again");
+}
+
+// Check that evicted tiles are kept compressed, and come back as they were.
+void checkCompression() {
+  TileCache cache{2 * tile_bytes, tile_size};
+  cache.set_compressed_capacity(16 * tile_bytes);
+
+  const auto b = cache.get(key(0, 1));
+  cache.get(key(0, 0));
+  cache.get(key(0, 2));
+
+  const TileCacheStats stats = cache.stats();
+  check(stats.evictions == 0 && stats.compressed_bytes > 0,
+        "the evicted tile is kept compressed");
+
+  const auto restored = cache.get(key(0, 1));
+  check(restored != b && equal(*restored, *b),
+        "an evicted tile is decompressed as it was");
+  check(cache.stats().misses == 3, "a compressed tile isn't computed again");
+}
+} // namespace
+
+int main() {
+  checkContents();
+  checkCoalescing();
+  checkEviction();
+  checkCompression();
+
+  return result(true);
+}